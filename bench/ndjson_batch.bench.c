@@ -0,0 +1,185 @@
+/**
+ * @file ndjson_batch.bench.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Benchmark of the multi-threaded NDJSON batch engine. Parses the same
+ * generated buffer with 1, 2, 4 ... threads and reports the speedup over one
+ * thread for both delivery orders.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ * usage: JTOK_ndjson_batch.bench [max threads] [records]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#define MAX_WORKERS (256u)
+#define TOKENS_PER_WORKER (4096u)
+#define RECS_PER_WORKER (256u)
+#define REPEAT (3u)
+
+/* One cache line per worker so the counters do not share lines */
+struct counter
+{
+    size_t tokens;
+    char   pad[64 - sizeof(size_t)];
+};
+
+static jtok_batch_worker_t workers[MAX_WORKERS];
+static struct counter      counters[MAX_WORKERS];
+
+static char * generate(size_t records, size_t *len);
+static double now(void);
+static bool   on_record(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                        size_t worker, void *ctx);
+
+int main(int argc, char **argv)
+{
+    size_t max_threads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 8;
+    size_t records     = (argc > 2) ? strtoul(argv[2], NULL, 10) : 200000;
+    size_t len;
+    char * buf;
+    size_t i;
+
+    if (max_threads < 1 || max_threads > MAX_WORKERS)
+    {
+        printf("max threads must be 1 .. %u\n", MAX_WORKERS);
+        return 1;
+    }
+
+    buf = generate(records, &len);
+    if (buf == NULL)
+    {
+        return 1;
+    }
+
+    for (i = 0; i < max_threads; i++)
+    {
+        workers[i].tkns  = malloc(TOKENS_PER_WORKER * sizeof(jtok_tkn_t));
+        workers[i].size  = TOKENS_PER_WORKER;
+        workers[i].recs  = malloc(RECS_PER_WORKER * sizeof(jtok_ndjson_rec_t));
+        workers[i].nrecs = RECS_PER_WORKER;
+        if (workers[i].tkns == NULL || workers[i].recs == NULL)
+        {
+            return 1;
+        }
+    }
+
+    printf("%zu records, %.1f MiB\n", records, (double)len / (1024 * 1024));
+    printf("%-10s %8s %10s %10s %8s\n", "order", "threads", "MiB/s",
+           "records/s", "speedup");
+    for (int order = JTOK_BATCH_UNORDERED; order <= JTOK_BATCH_ORDERED; order++)
+    {
+        double base = 0;
+        for (size_t n = 1; n <= max_threads; n *= 2)
+        {
+            double best = 0;
+            for (unsigned int r = 0; r < REPEAT; r++)
+            {
+                double start = now();
+                if (jtok_batch_parse(buf, len, workers, n, 0,
+                                     (JTOK_BATCH_ORDER_t)order, on_record,
+                                     NULL) != JTOK_PARSE_STATUS_OK)
+                {
+                    printf("parse failed\n");
+                    return 1;
+                }
+                double elapsed = now() - start;
+                if (best == 0 || elapsed < best)
+                {
+                    best = elapsed;
+                }
+            }
+
+            if (n == 1)
+            {
+                base = best;
+            }
+            printf("%-10s %8zu %10.1f %10.0f %8.2f\n",
+                   (order == JTOK_BATCH_ORDERED) ? "ordered" : "unordered", n,
+                   (double)len / (1024 * 1024) / best, (double)records / best,
+                   base / best);
+        }
+    }
+
+    for (i = 0; i < max_threads; i++)
+    {
+        free(workers[i].tkns);
+        free(workers[i].recs);
+    }
+    free(buf);
+    return 0;
+}
+
+
+/**
+ * @brief Generate records of uneven size. Every 64th record carries a large
+ * array so chunks take different amounts of time to parse.
+ *
+ * @param records number of records
+ * @param len length of the buffer
+ * @return char* the buffer, NULL if out of memory
+ */
+static char *generate(size_t records, size_t *len)
+{
+    size_t cap = records * 128 + (records / 64 + 1) * 8 * 1024;
+    char * buf = malloc(cap);
+    size_t pos = 0;
+    size_t i;
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < records; i++)
+    {
+        pos += (size_t)snprintf(&buf[pos], cap - pos,
+                                "{\"id\":%zu,\"name\":\"sensor-%zu\","
+                                "\"ok\":true,\"values\":[",
+                                i, i % 97);
+        unsigned int values = (i % 64 == 0) ? 1000 : 4;
+        for (unsigned int v = 0; v < values; v++)
+        {
+            pos += (size_t)snprintf(&buf[pos], cap - pos, "%s%u.%u",
+                                    v ? "," : "", v, (unsigned int)(i % 10));
+        }
+        pos += (size_t)snprintf(&buf[pos], cap - pos, "]}\n");
+    }
+    *len = pos;
+    return buf;
+}
+
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+static bool on_record(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                      size_t worker, void *ctx)
+{
+    (void)tkns;
+    (void)ctx;
+    counters[worker].tokens += rec->used;
+    return true;
+}
+
+#else
+
+int main(void)
+{
+    printf("Batch engine not built (JTOK_THREADS=0)\n");
+    return 0;
+}
+
+#endif /* #if JTOK_THREADS */
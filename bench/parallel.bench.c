@@ -0,0 +1,185 @@
+/**
+ * @file parallel.bench.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Benchmark of parsing one large document on several threads. Parses
+ * a generated document whose largest array holds every record with 1, 2,
+ * 4 ... threads, into pools with no slack, 1% slack and 10% slack, and
+ * reports the speedup over a single-threaded parse.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ * usage: JTOK_parallel.bench [max threads] [records]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#define REPEAT (5u)
+
+static char * generate(size_t records, size_t *len);
+static double now(void);
+static double best_parse(const char *buf, size_t len, jtok_tkn_t *tkns,
+                         size_t size, size_t threads);
+
+int main(int argc, char **argv)
+{
+    static const unsigned int slack[] = {0, 1, 10};
+    size_t       max_threads = (argc > 1) ? strtoul(argv[1], NULL, 10) : 4;
+    size_t       records     = (argc > 2) ? strtoul(argv[2], NULL, 10) : 300000;
+    size_t       len;
+    size_t       exact;
+    jtok_tkn_t * tkns;
+    char *       buf;
+
+    if (max_threads < 2)
+    {
+        printf("max threads must be at least 2\n");
+        return 1;
+    }
+
+    buf = generate(records, &len);
+    if (buf == NULL ||
+        jtok_count_tokens(buf, len, &exact) != JTOK_PARSE_STATUS_OK)
+    {
+        return 1;
+    }
+    tkns = malloc((exact + exact / 10) * sizeof(*tkns));
+    if (tkns == NULL)
+    {
+        return 1;
+    }
+
+    printf("%zu records, %.1f MiB, %zu tokens\n", records,
+           (double)len / (1024 * 1024), exact);
+    printf("%-6s %8s %10s %10s %8s\n", "slack", "threads", "ms", "MiB/s",
+           "speedup");
+    for (size_t s = 0; s < sizeof(slack) / sizeof(*slack); s++)
+    {
+        size_t size = exact + exact * slack[s] / 100;
+        double base = best_parse(buf, len, tkns, size, 1);
+        if (base < 0)
+        {
+            printf("parse failed\n");
+            return 1;
+        }
+        for (size_t n = 1; n <= max_threads; n *= 2)
+        {
+            double best = (n == 1) ? base : best_parse(buf, len, tkns, size, n);
+            if (best < 0)
+            {
+                printf("parse failed\n");
+                return 1;
+            }
+            printf("%5u%% %8zu %10.1f %10.1f %8.2f\n", slack[s], n,
+                   best * 1e3, (double)len / (1024 * 1024) / best,
+                   base / best);
+        }
+    }
+
+    free(tkns);
+    free(buf);
+    return 0;
+}
+
+
+/**
+ * @brief Generate a document with a small object, then an array of
+ * records of slightly different shapes
+ *
+ * @param records number of records in the array
+ * @param len length of the document
+ * @return char* the document, NULL if out of memory
+ */
+static char *generate(size_t records, size_t *len)
+{
+    size_t cap = records * 96 + 256;
+    char * buf = malloc(cap);
+    size_t pos = 0;
+    size_t i;
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    pos += (size_t)snprintf(&buf[pos], cap - pos,
+                            "{\"meta\":{\"ver\":1,\"source\":\"bench\"},"
+                            "\"items\":[");
+    for (i = 0; i < records; i++)
+    {
+        pos += (size_t)snprintf(&buf[pos], cap - pos,
+                                "%s{\"id\":%zu,\"name\":\"sensor-%zu\","
+                                "\"ok\":true,\"values\":[",
+                                i ? ",\n" : "", i, i % 97);
+        for (unsigned int v = 0; v < 1 + i % 4; v++)
+        {
+            pos += (size_t)snprintf(&buf[pos], cap - pos, "%s%u.%u",
+                                    v ? "," : "", v, (unsigned int)(i % 10));
+        }
+        pos += (size_t)snprintf(&buf[pos], cap - pos, "]}");
+    }
+    pos += (size_t)snprintf(&buf[pos], cap - pos, "]}");
+    *len = pos;
+    return buf;
+}
+
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+/**
+ * @brief Best time of a few parses of the document, on one thread with
+ * jtok_parse_n_used or on several with jtok_parse_parallel
+ *
+ * @return double seconds, negative if the parse failed
+ */
+static double best_parse(const char *buf, size_t len, jtok_tkn_t *tkns,
+                         size_t size, size_t threads)
+{
+    double best = 0;
+    for (unsigned int r = 0; r < REPEAT; r++)
+    {
+        JTOK_PARSE_STATUS_t status;
+        size_t              used  = 0;
+        double              start = now();
+        if (threads == 1)
+        {
+            status = jtok_parse_n_used(buf, len, tkns, size, &used);
+        }
+        else
+        {
+            status = jtok_parse_parallel(buf, len, tkns, size, threads, &used);
+        }
+        double elapsed = now() - start;
+        if (status != JTOK_PARSE_STATUS_OK)
+        {
+            return -1;
+        }
+        if (best == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+#else
+
+int main(void)
+{
+    printf("Parallel parse not built (JTOK_THREADS=0)\n");
+    return 0;
+}
+
+#endif /* #if JTOK_THREADS */
@@ -0,0 +1,193 @@
+/**
+ * @file parse.bench.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Benchmark of the single-threaded parser on a generated document of
+ * mixed content: indented objects, numbers with fractions and exponents,
+ * strings with escapes and literals, and optionally a long base64-like blob
+ * string per item. The cursor reads one field of the item 3/4 of the way
+ * in, stepping over the items before it.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ * usage: JTOK_parse.bench [items] [repeat] [blob chars] [kernel]
+ *
+ * kernel is a JTOK_KERNEL_t value, the best one the CPU supports if omitted
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "jtok.h"
+
+#define TOKENS_PER_ITEM (26u)
+
+static char * generate(size_t items, size_t blob, size_t *len);
+static double cursor_read(const char *buf, size_t len, size_t item);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    size_t        items  = (argc > 1) ? strtoul(argv[1], NULL, 10) : 50000;
+    size_t        repeat = (argc > 2) ? strtoul(argv[2], NULL, 10) : 20;
+    size_t        blob   = (argc > 3) ? strtoul(argv[3], NULL, 10) : 0;
+    JTOK_KERNEL_t kernel = jtok_init();
+    size_t        size   = items * TOKENS_PER_ITEM + 8;
+    size_t        len;
+    size_t        used = 0;
+    double        best = 0;
+    char *        buf  = generate(items, blob, &len);
+    jtok_tkn_t *  tkns = malloc(size * sizeof(*tkns));
+    if (buf == NULL || tkns == NULL)
+    {
+        return 1;
+    }
+    if (argc > 4)
+    {
+        kernel = (JTOK_KERNEL_t)strtoul(argv[4], NULL, 10);
+        if (!jtok_set_kernel(kernel))
+        {
+            printf("kernel %s is not supported\n", jtok_kernel_name(kernel));
+            return 1;
+        }
+    }
+
+    for (size_t r = 0; r < repeat; r++)
+    {
+        double start = now();
+        if (jtok_parse_n_used(buf, len, tkns, size, &used) !=
+            JTOK_PARSE_STATUS_OK)
+        {
+            printf("parse failed\n");
+            return 1;
+        }
+        double elapsed = now() - start;
+        if (best == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+
+    printf("%s: %.1f MiB, %zu tokens, best of %zu: %.2f ms, %.1f MiB/s\n",
+           jtok_kernel_name(kernel), (double)len / (1024 * 1024), used,
+           repeat, best * 1e3,
+           (double)len / (1024 * 1024) / best);
+
+    double cursor_best = 0;
+    for (size_t r = 0; r < repeat; r++)
+    {
+        double elapsed = cursor_read(buf, len, items * 3 / 4);
+        if (elapsed < 0)
+        {
+            printf("cursor failed\n");
+            return 1;
+        }
+        if (cursor_best == 0 || elapsed < cursor_best)
+        {
+            cursor_best = elapsed;
+        }
+    }
+    printf("%s: cursor to item %zu, best of %zu: %.3f ms, %.1fx faster than "
+           "parsing\n",
+           jtok_kernel_name(kernel), items * 3 / 4, repeat, cursor_best * 1e3,
+           best / cursor_best);
+    free(tkns);
+    free(buf);
+    return 0;
+}
+
+
+/**
+ * @brief Generate a document with one array of items of mixed content
+ *
+ * @param items number of items
+ * @param blob number of chars of the blob string of each item, 0 for none
+ * @param len length of the document
+ * @return char* the document, NULL if out of memory
+ */
+static char *generate(size_t items, size_t blob, size_t *len)
+{
+    static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmn"
+                                 "opqrstuvwxyz0123456789+/";
+    size_t cap = items * (256 + blob + 16) + 64;
+    char * buf = malloc(cap);
+    size_t pos = 0;
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    pos += (size_t)snprintf(&buf[pos], cap - pos, "{\n  \"items\" : [");
+    for (size_t i = 0; i < items; i++)
+    {
+        pos += (size_t)snprintf(
+            &buf[pos], cap - pos,
+            "%s\n    {\n      \"id\" : %zu,\n"
+            "      \"name\" : \"sensor \\\"%zu\\\"\\n\\u00e9\",\n"
+            "      \"ok\" : %s,\n      \"gain\" : -%zu.%03zue-%zu,\n"
+            "      \"values\" : [%zu, %zu.5, -1e+%zu, 0.25],\n"
+            "      \"unit\" : null",
+            i ? "," : "", i, i % 97, (i % 3) ? "true" : "false", i % 10,
+            i % 1000, i % 9 + 1, i * 7, i % 100, i % 30);
+        if (blob > 0)
+        {
+            pos += (size_t)snprintf(&buf[pos], cap - pos,
+                                    ",\n      \"blob\" : \"");
+            for (size_t c = 0; c < blob; c++)
+            {
+                buf[pos++] = base64[(i + c * 7) % 64];
+            }
+            buf[pos++] = '\"';
+        }
+        pos += (size_t)snprintf(&buf[pos], cap - pos, "\n    }");
+    }
+    pos += (size_t)snprintf(&buf[pos], cap - pos, "\n  ]\n}");
+    *len = pos;
+    return buf;
+}
+
+
+/**
+ * @brief Time reading the gain of one item with a cursor
+ *
+ * @param buf the document
+ * @param len length of the document
+ * @param item index of the item to read
+ * @return double seconds taken, negative if the cursor failed
+ */
+static double cursor_read(const char *buf, size_t len, size_t item)
+{
+    jtok_cursor_t root;
+    jtok_cursor_t items;
+    jtok_cursor_t elem;
+    jtok_cursor_t gain;
+    double        start = now();
+    if (jtok_cursor_init(&root, buf, len) != JTOK_PARSE_STATUS_OK ||
+        jtok_cursor_find_key(&root, "items", &items) != JTOK_PARSE_STATUS_OK ||
+        jtok_cursor_first(&items, &elem) != JTOK_PARSE_STATUS_OK)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < item; i++)
+    {
+        if (jtok_cursor_next(&elem) != JTOK_PARSE_STATUS_OK)
+        {
+            return -1;
+        }
+    }
+    if (jtok_cursor_find_key(&elem, "gain", &gain) != JTOK_PARSE_STATUS_OK ||
+        gain.type != JTOK_PRIMITIVE)
+    {
+        return -1;
+    }
+    return now() - start;
+}
+
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
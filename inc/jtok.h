@@ -11,18 +11,73 @@ extern "C" {
 #include <stdbool.h>
 #include <limits.h>
 
+/* Set to 1 to build the multi-threaded NDJSON batch engine (pthreads) */
+#ifndef JTOK_THREADS
+#define JTOK_THREADS 0
+#endif /* #ifndef JTOK_THREADS */
+
+#if JTOK_THREADS
+#include <pthread.h>
+#endif /* #if JTOK_THREADS */
+
+/* Set to 0 to compile out the double and float accessors on targets without
+ * an FPU. Numbers are then read and compared with integer arithmetic only */
+#ifndef JTOK_FLOAT
+#define JTOK_FLOAT 1
+#endif /* #ifndef JTOK_FLOAT */
+
 #define JTOK_INVALID_ARRAY_INDEX (-1)
 #define JTOK_NO_PARENT_IDX (JTOK_INVALID_ARRAY_INDEX)
 #define JTOK_NO_SIBLING_IDX (JTOK_INVALID_ARRAY_INDEX)
 #define JTOK_NO_CHILD_IDX (JTOK_INVALID_ARRAY_INDEX)
 #define JTOK_STRING_INDEX_NONE (JTOK_INVALID_ARRAY_INDEX)
 
-/* The highest level of object nesting before a DFS recursion error
- * is issued */
+/* Width in bits of the compact token fields. 16 suits documents under
+ * 64 KiB on small targets, 64 suits documents larger than 2 GiB.
+ * The width only applies to the compact tokens of jtok_doc_parse, the
+ * struct-of-arrays pool, the tape, the cursor and jtok_count_tokens.
+ * jtok_tkn_t keeps int fields whatever the width, so jtok_parse,
+ * jtok_parser_feed and the other functions that fill a jtok_tkn_t pool
+ * reject documents longer than INT_MAX chars */
+#ifndef JTOK_INDEX_WIDTH
+#define JTOK_INDEX_WIDTH 32
+#endif /* #ifndef JTOK_INDEX_WIDTH */
+
+#if JTOK_INDEX_WIDTH == 16
+typedef uint16_t jtok_off_t; /* compact token offset in the json string */
+typedef uint16_t jtok_idx_t; /* compact token index in the token pool */
+typedef int      jtok_pos_t; /* parser position, -1 if invalid */
+#define JTOK_CTKN_NONE (UINT16_MAX)
+#define JTOK_OFF_MAX (UINT16_MAX)
+#define JTOK_POS_MAX (INT_MAX)
+#elif JTOK_INDEX_WIDTH == 32
+typedef uint32_t jtok_off_t;
+typedef uint32_t jtok_idx_t;
+typedef int      jtok_pos_t;
+#define JTOK_CTKN_NONE (UINT32_MAX)
+#define JTOK_OFF_MAX (UINT32_MAX)
+#define JTOK_POS_MAX (INT_MAX)
+#elif JTOK_INDEX_WIDTH == 64
+typedef uint64_t jtok_off_t;
+typedef uint32_t jtok_idx_t;
+typedef int64_t  jtok_pos_t;
+#define JTOK_CTKN_NONE (UINT32_MAX)
+#define JTOK_OFF_MAX (UINT64_MAX)
+#define JTOK_POS_MAX (INT64_MAX)
+#else
+#error "JTOK_INDEX_WIDTH must be 16, 32 or 64"
+#endif /* #if JTOK_INDEX_WIDTH == 16 */
+
+/* The highest level of object nesting before jtok_parse issues a
+ * JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED error. Callers that need a
+ * different limit provide their own nesting stack to jtok_parse_with_stack */
 #ifndef JTOK_MAX_RECURSE_DEPTH
 #define JTOK_MAX_RECURSE_DEPTH 25
 #endif /* #ifndef JTOK_MAX_RECURSE_DEPTH */
 
+/* Max number of paths jtok_parse_paths can project a json string onto */
+#define JTOK_MAX_PATHS 32
+
 /**
  * JTOK type identifier. Basic types are:
  *  - Object
@@ -39,6 +94,21 @@ typedef enum
     JTOK_STRING,
 } JTOK_TYPE_t;
 
+/**
+ * Subtype of a JTOK_PRIMITIVE token, found while it is parsed so comparisons
+ * and accessors do not have to parse the token again
+ */
+typedef enum
+{
+    JTOK_SUBTYPE_NONE,     /* not a primitive */
+    JTOK_SUBTYPE_INTEGER,  /* eg: -12 */
+    JTOK_SUBTYPE_DECIMAL,  /* eg: 1.25 */
+    JTOK_SUBTYPE_EXPONENT, /* eg: 1.25e-3 */
+    JTOK_SUBTYPE_TRUE,
+    JTOK_SUBTYPE_FALSE,
+    JTOK_SUBTYPE_NULL,
+} JTOK_SUBTYPE_t;
+
 typedef enum
 {
     /* Parsed successfully! */
@@ -120,28 +190,351 @@ typedef enum
 typedef struct jtok_tkn_struct jtok_tkn_t;
 struct jtok_tkn_struct
 {
-    int         start;   /* start position in JTOK data string */
-    int         end;     /* end position in JTOK data string */
-    int         size;    /* number of child tokens */
-    int         parent;  /* index of parent token in the token pool */
-    int         sibling; /* index of next token that shares the same parent */
-    char *      json;    /* json string into which the data structure inserts */
-    jtok_tkn_t *pool;    /* Token pool */
-    JTOK_TYPE_t type;    /* type (object, array, string etc.) */
+    int            start;   /* start position in JTOK data string */
+    int            end;     /* end position in JTOK data string */
+    int            size;    /* number of child tokens */
+    int            parent;  /* index of parent token in the token pool */
+    int            sibling; /* index of next token with the same parent */
+    char *         json;    /* json string the data structure inserts into */
+    jtok_tkn_t *   pool;    /* Token pool */
+    JTOK_TYPE_t    type;    /* type (object, array, string etc.) */
+    JTOK_SUBTYPE_t subtype; /* primitive subtype, else JTOK_SUBTYPE_NONE */
 };
 
+/* Max number of tokens in a compact token pool */
+#define JTOK_CTKN_POOL_MAX (JTOK_CTKN_NONE)
+
+/* Token index in a struct-of-arrays pool. 32 bits whatever the
+ * JTOK_INDEX_WIDTH, since the pool has no per-token size budget */
+typedef uint32_t jtok_soa_idx_t;
+#define JTOK_SOA_NONE (UINT32_MAX)
+
+/* Max number of tokens in a struct-of-arrays pool */
+#define JTOK_SOA_POOL_MAX (JTOK_SOA_NONE)
+
+/**
+ * Compact token. The json string and token pool are held once by the
+ * jtok_doc_t the token belongs to instead of by every token.
+ */
+typedef struct
+{
+    jtok_off_t start;   /* start position in JTOK data string */
+    jtok_off_t end;     /* end position in JTOK data string */
+    jtok_idx_t size;    /* number of child tokens */
+    jtok_idx_t parent;  /* index of parent token in the token pool */
+    jtok_idx_t sibling; /* index of next token that shares the same parent */
+    uint8_t    type;    /* JTOK_TYPE_t */
+    uint8_t    subtype; /* JTOK_SUBTYPE_t */
+} jtok_ctkn_t;
+
+/**
+ * Parsed json document backed by a pool of compact tokens
+ */
+typedef struct
+{
+    const char * json;  /* json string the tokens index into */
+    size_t       len;   /* number of chars in the json string */
+    jtok_ctkn_t *tkns;  /* compact token pool */
+    size_t       size;  /* number of tokens in the token pool */
+    size_t       count; /* number of tokens parsed */
+} jtok_doc_t;
+
+/**
+ * Struct-of-arrays token pool. Each field of the tokens is stored in its own
+ * caller-provided array so scans over one field only touch that field.
+ * Token i is described by element i of every array.
+ */
+typedef struct
+{
+    uint8_t *   type;    /* JTOK_TYPE_t of each token */
+    jtok_off_t *start;   /* start position in JTOK data string */
+    jtok_off_t *end;     /* end position in JTOK data string */
+    jtok_soa_idx_t *size;    /* number of child tokens */
+    jtok_soa_idx_t *parent;  /* index of parent token, JTOK_SOA_NONE if none */
+    jtok_soa_idx_t *sibling; /* index of next sibling, JTOK_SOA_NONE if none */
+    size_t          cap;     /* number of elements in each array */
+    size_t          count;   /* number of tokens parsed */
+    const char *    json;    /* json string the tokens index into */
+    size_t          len;     /* number of chars in the json string */
+} jtok_soa_t;
+
+/* Tags of the tape entries. Every entry is two 64 bit words: the tagged
+ * word and a second word holding a json string offset or length */
+#define JTOK_TAPE_OBJECT ('{')     /* payload: index after the matching '}' */
+#define JTOK_TAPE_OBJECT_END ('}') /* payload: index of the matching '{' */
+#define JTOK_TAPE_ARRAY ('[')      /* payload: index after the matching ']' */
+#define JTOK_TAPE_ARRAY_END (']')  /* payload: index of the matching '[' */
+#define JTOK_TAPE_KEY ('k')        /* payload: start, next word: length */
+#define JTOK_TAPE_STRING ('\"')    /* payload: start, next word: length */
+#define JTOK_TAPE_PRIMITIVE ('p')  /* payload: start, next word: length */
+
+#define JTOK_TAPE_TAG_SHIFT (56)
+#define JTOK_TAPE_PAYLOAD_MASK ((UINT64_C(1) << JTOK_TAPE_TAG_SHIFT) - 1)
+
+/* Tape index returned when there is no such entry */
+#define JTOK_TAPE_NONE (SIZE_MAX)
+
+/**
+ * Tape of a parsed json document. Entries are laid out in document order so
+ * a full traversal is a single forward scan, and every container records
+ * where it ends so skipping a subtree is O(1).
+ *
+ * Each word holds the entry tag in its top 8 bits and a payload in the
+ * remaining 56 bits.
+ */
+typedef struct
+{
+    uint64_t *  words; /* caller-provided tape */
+    size_t      cap;   /* number of words in the tape */
+    size_t      count; /* number of words written */
+    const char *json;  /* json string the tape indexes into */
+    size_t      len;   /* number of chars in the json string */
+} jtok_tape_t;
+
+/**
+ * On-demand cursor on a value of a json document. The document is only
+ * scanned as far as the caller navigates, and values that are stepped over
+ * are skipped by bracket matching rather than tokenized.
+ */
+typedef struct
+{
+    const char *json;   /* json string being navigated */
+    jtok_pos_t  len;    /* number of chars in the json string */
+    jtok_pos_t  pos;    /* first char of the value */
+    jtok_pos_t  start;  /* start position in JTOK data string */
+    jtok_pos_t  end;    /* end position, unknown (-1) for objects and arrays */
+    JTOK_TYPE_t type;   /* JTOK_UNASSIGNED_TOKEN when past the last child */
+    JTOK_TYPE_t parent; /* type of the aggregate holding the value */
+    bool        key;    /* the value is a key of its parent object */
+} jtok_cursor_t;
+
+/**
+ * One record of a newline-delimited json (NDJSON) buffer
+ */
+typedef struct
+{
+    const char *        json;   /* first char of the record */
+    size_t              len;    /* number of chars, excluding the newline */
+    size_t              index;  /* record number, blank lines are not counted */
+    size_t              used;   /* number of tokens written to the pool */
+    JTOK_PARSE_STATUS_t status; /* parse status of the record */
+} jtok_ndjson_rec_t;
+
+/**
+ * Iterator over the records of a newline-delimited json (NDJSON) buffer
+ */
+typedef struct
+{
+    const char *buf;     /* buffer of newline separated records */
+    size_t      len;     /* number of chars in the buffer */
+    size_t      pos;     /* first char not consumed yet */
+    size_t      records; /* number of records returned so far */
+} jtok_ndjson_t;
+
+/**
+ * @brief Callback invoked by jtok_ndjson_parse for every record
+ *
+ * @param rec the record. rec->status tells if the tokens are valid
+ * @param tkns the token pool holding the tokens of the record
+ * @param ctx caller context
+ * @return true to continue with the next record, false to stop
+ */
+typedef bool (*jtok_ndjson_cb_t)(const jtok_ndjson_rec_t *rec,
+                                 const jtok_tkn_t *tkns, void *ctx);
+
+#if JTOK_THREADS
+
+/* Chunk size jtok_batch_parse uses when the caller passes 0 */
+#define JTOK_BATCH_CHUNK_SIZE (64u * 1024u)
+
+/* Smallest slice of an array that jtok_parse_parallel hands to a thread */
+#define JTOK_PARALLEL_MIN_SLICE (4u * 1024u)
+
+/**
+ * Order in which jtok_batch_parse delivers records to the callback
+ */
+typedef enum
+{
+    JTOK_BATCH_UNORDERED, /* as soon as they are parsed, from every worker */
+    JTOK_BATCH_ORDERED,   /* one at a time, in buffer order */
+} JTOK_BATCH_ORDER_t;
+
+/**
+ * @brief Callback invoked by jtok_batch_parse for every record
+ *
+ * @param rec the record. rec->status tells if the tokens are valid
+ * @param tkns the token pool holding the tokens of the record
+ * @param worker index of the worker that parsed the record
+ * @param ctx caller context
+ * @return true to continue, false to stop every worker
+ *
+ * @note With JTOK_BATCH_UNORDERED the callback runs concurrently on every
+ * worker thread
+ */
+typedef bool (*jtok_batch_cb_t)(const jtok_ndjson_rec_t *rec,
+                                const jtok_tkn_t *tkns, size_t worker,
+                                void *ctx);
+
+/**
+ * Worker of the NDJSON batch engine. The caller provides the storage, the
+ * scheduler fields are private.
+ */
 typedef struct
 {
-    int          json_len; /* max length of json string   */
-    int          pos;      /* current parsing index in json string */
-    int          toknext;  /* index of next token to allocate */
-    int          toksuper; /* superior token node, e.g parent object or array */
-    int          last_child; /* index of last sibling parsed */
-    unsigned int pool_size;  /* pool size */
-    jtok_tkn_t * tkn_pool;   /* token pool */
-    char *       json;       /* ptr to start of json string */
+    jtok_tkn_t *       tkns;  /* token pool of the worker */
+    size_t             size;  /* number of tokens in the pool */
+    jtok_ndjson_rec_t *recs;  /* ordered: records held until their turn */
+    size_t             nrecs; /* number of records that can be held */
+
+    size_t          lo;     /* next chunk of the worker's deque */
+    size_t          hi;     /* end of the worker's deque */
+    pthread_mutex_t lock;   /* guards lo and hi against thieves */
+    pthread_t       thread; /* thread running the worker */
+    void *          batch;  /* batch the worker belongs to */
+    size_t          id;     /* index of the worker */
+} jtok_batch_worker_t;
+
+#endif /* #if JTOK_THREADS */
+
+/**
+ * Stage-1 classification of a 64 byte block of the json string.
+ * Bit i of each mask describes the character at json[base + i].
+ */
+typedef struct
+{
+    jtok_pos_t base;       /* index of first block char in json string */
+    uint64_t   whitespace; /* ' ', '\t', '\r', '\n' */
+    uint64_t   structural; /* '{', '}', '[', ']', ':', ',' */
+    uint64_t   quote;      /* '\"', '\'' */
+    uint64_t   backslash;  /* '\\' */
+} jtok_block_t;
+
+/**
+ * Nesting frame of an object or array that is being parsed.
+ * The parser keeps one frame per open aggregate instead of recursing.
+ */
+typedef struct
+{
+    jtok_pos_t  tkn;          /* index of the aggregate token */
+    jtok_pos_t  key;          /* objects: index of key awaiting a value */
+    jtok_pos_t  last_child;   /* index of last sibling parsed */
+    int         expecting;    /* aggregate specific parse state */
+    JTOK_TYPE_t type;         /* JTOK_OBJECT or JTOK_ARRAY */
+    JTOK_TYPE_t element_type; /* arrays: type of the elements */
+    uint32_t    sel_paths;    /* projection: paths matched up to this frame */
+    bool        sel_all;      /* projection: every descendant is kept */
+} jtok_frame_t;
+
+/**
+ * Where the parser writes the tokens it allocates
+ */
+typedef enum
+{
+    JTOK_OUTPUT_COUNT,   /* no tokens are written, only counted */
+    JTOK_OUTPUT_TOKENS,  /* jtok_tkn_t pool */
+    JTOK_OUTPUT_COMPACT, /* jtok_ctkn_t pool */
+    JTOK_OUTPUT_SOA,     /* jtok_soa_t pool */
+    JTOK_OUTPUT_TAPE,    /* jtok_tape_t tape */
+} JTOK_OUTPUT_t;
+
+typedef struct
+{
+    jtok_pos_t    json_len;  /* max length of json string   */
+    jtok_pos_t    pos;       /* current parsing index in json string */
+    jtok_pos_t    toknext;   /* index of next token to allocate */
+    jtok_pos_t    toklast;   /* index of the last token allocated */
+    jtok_pos_t    toksuper;  /* superior node, e.g parent object or array */
+    jtok_pos_t    pool_size; /* pool size */
+    jtok_tkn_t *  tkn_pool;  /* token pool */
+    jtok_ctkn_t * ctkn_pool; /* compact token pool */
+    jtok_soa_t *  soa;       /* struct-of-arrays token pool */
+    jtok_tape_t * tape;      /* tape, indices are tape indices */
+    JTOK_OUTPUT_t output;    /* which of the token pools is written */
+    char *        json;      /* ptr to start of json string */
+    jtok_block_t  block;     /* whitespace bitmap of the current block */
+    jtok_frame_t *frames;    /* nesting stack, one frame per open aggregate */
+    unsigned int  max_depth; /* number of frames in the nesting stack */
+    unsigned int  depth;     /* number of frames in use */
+    jtok_pos_t    str_quote; /* opening quote of string cut off by a chunk */
+    jtok_pos_t    str_scan;  /* where validation of that string resumes */
+    const char *const *paths; /* projection paths, NULL keeps every token */
+    size_t        npaths;    /* number of projection paths */
+    uint32_t      sel_paths; /* paths the last selected token matched */
+    bool          sel_all;   /* last selected token is kept with its subtree */
+    JTOK_PARSE_STATUS_t status; /* status of the last chunk fed */
 } jtok_parser_t;
 
+#if JTOK_FLOAT
+/* Max number of dimensions of an array of arrays jtok_array_to_tensor_double
+ * and jtok_array_to_tensor_float extract */
+#ifndef JTOK_TENSOR_MAX_RANK
+#define JTOK_TENSOR_MAX_RANK 8
+#endif /* #ifndef JTOK_TENSOR_MAX_RANK */
+
+/**
+ * Shape of a dense tensor held as nested arrays, eg: [[1,2,3],[4,5,6]] has
+ * rank 2, shape {2, 3} and 6 elements
+ */
+typedef struct
+{
+    size_t rank;                        /* number of dimensions */
+    size_t shape[JTOK_TENSOR_MAX_RANK]; /* length of each, outermost first */
+    size_t count;                       /* number of elements */
+} jtok_shape_t;
+#endif /* #if JTOK_FLOAT */
+
+/**
+ * Scanning kernels the parser can run on. Every build has the scalar kernel
+ */
+typedef enum
+{
+    JTOK_KERNEL_SCALAR, /* one char at a time */
+    JTOK_KERNEL_SWAR,   /* one 32 or 64 bit word at a time */
+    JTOK_KERNEL_SSE2,   /* 16 chars at a time */
+    JTOK_KERNEL_AVX2,   /* 32 chars at a time */
+} JTOK_KERNEL_t;
+
+
+/**
+ * @brief Probe the CPU and select the fastest scanning kernel it supports
+ *
+ * @return JTOK_KERNEL_t the kernel selected
+ *
+ * @note Until this is called the parser uses the fastest kernel the compiler
+ * targets, eg: SSE2 on x86-64. Call it once at startup, before any parse runs
+ * on another thread
+ */
+JTOK_KERNEL_t jtok_init(void);
+
+
+/**
+ * @brief Select a scanning kernel
+ *
+ * @param kernel the kernel
+ * @return true if selected, false if the build or the CPU does not support
+ * it, in which case the kernel in use does not change
+ *
+ * @note Not thread safe, like jtok_init
+ */
+bool jtok_set_kernel(JTOK_KERNEL_t kernel);
+
+
+/**
+ * @brief Get the scanning kernel in use
+ *
+ * @return JTOK_KERNEL_t the kernel
+ */
+JTOK_KERNEL_t jtok_get_kernel(void);
+
+
+/**
+ * @brief Get the name of a scanning kernel, for diagnostics
+ *
+ * @param kernel the kernel
+ * @return const char* its name, eg: "avx2"
+ */
+const char *jtok_kernel_name(JTOK_KERNEL_t kernel);
+
 
 /**
  * @brief Parse a json string into its JTOK token representation
@@ -151,17 +544,682 @@ typedef struct
  * @param size number of tokens in the token pool (max number of tokens that can
  * be parsed)
  * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note The token following the last parsed token (if the pool has room) is
+ * marked JTOK_UNASSIGNED_TOKEN. The rest of the pool is left untouched.
  */
 JTOK_PARSE_STATUS_t jtok_parse(const char *json, jtok_tkn_t *tkns, size_t size);
 
 
+/**
+ * @brief Parse a json string into its JTOK token representation using a
+ * caller-provided nesting stack
+ *
+ * @param json json string (nul-terminated) to parse
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool (max number of tokens that can
+ * be parsed)
+ * @param frames caller-provided nesting stack
+ * @param max_depth number of frames in the nesting stack (max number of
+ * nested objects and arrays, including the top-level object)
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note Stack usage is constant regardless of the document nesting depth
+ */
+JTOK_PARSE_STATUS_t jtok_parse_with_stack(const char *json, jtok_tkn_t *tkns,
+                                          size_t size, jtok_frame_t *frames,
+                                          size_t max_depth);
+
+
+/**
+ * @brief Parse the first len chars of a json string into its JTOK token
+ * representation
+ *
+ * @param json json string to parse. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool (max number of tokens that can
+ * be parsed)
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note No char at or past json[len] is ever read, so read-only, memory mapped
+ * and DMA buffers can be parsed in place
+ */
+JTOK_PARSE_STATUS_t jtok_parse_n(const char *json, size_t len, jtok_tkn_t *tkns,
+                                 size_t size);
+
+
+/**
+ * @brief Parse the first len chars of a json string into its JTOK token
+ * representation using a caller-provided nesting stack
+ *
+ * @param json json string to parse. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool (max number of tokens that can
+ * be parsed)
+ * @param frames caller-provided nesting stack
+ * @param max_depth number of frames in the nesting stack
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ */
+JTOK_PARSE_STATUS_t jtok_parse_n_with_stack(const char *json, size_t len,
+                                            jtok_tkn_t *tkns, size_t size,
+                                            jtok_frame_t *frames,
+                                            size_t max_depth);
+
+
+/**
+ * @brief Parse the first len chars of a json string and report how many
+ * tokens were used
+ *
+ * @param json json string to parse. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool
+ * @param used number of tokens written to the pool (may be NULL)
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note No token past tkns[*used - 1] is written, so the cost of a parse
+ * does not depend on the size of the pool. Use jtok_clear_tokens if the
+ * unused tokens must be marked JTOK_UNASSIGNED_TOKEN.
+ */
+JTOK_PARSE_STATUS_t jtok_parse_n_used(const char *json, size_t len,
+                                      jtok_tkn_t *tkns, size_t size,
+                                      size_t *used);
+
+
+/**
+ * @brief Parse the first len chars of a json string but only materialize the
+ * tokens on the given paths
+ *
+ * @param json json string to parse. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool
+ * @param paths paths to keep, eg "/header/id". Each segment is compared with
+ * the raw text of an object key. "" keeps the whole document
+ * @param npaths number of paths (at most JTOK_MAX_PATHS)
+ * @param used number of tokens written to the pool (may be NULL)
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note Tokens are allocated for the top-level object, the keys and values
+ * along each path and the whole subtree at the end of each path. Every other
+ * value is validated exactly as jtok_parse would, but uses no token. Object
+ * sizes and sibling links only count the tokens that were kept.
+ * @note Segments never select array elements, an array is only kept whole at
+ * the end of a path
+ */
+JTOK_PARSE_STATUS_t jtok_parse_paths(const char *json, size_t len,
+                                     jtok_tkn_t *tkns, size_t size,
+                                     const char *const *paths, size_t npaths,
+                                     size_t *used);
+
+
+/**
+ * @brief Mark a range of tokens as JTOK_UNASSIGNED_TOKEN
+ *
+ * @param tkns the token pool
+ * @param from index of the first token to clear
+ * @param size number of tokens in the token pool
+ */
+void jtok_clear_tokens(jtok_tkn_t *tkns, size_t from, size_t size);
+
+
+/**
+ * @brief Initialize a persistent parser for incremental parsing of a json
+ * string that arrives in chunks
+ *
+ * @param parser the parser to initialize
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool
+ * @param frames caller-provided nesting stack
+ * @param max_depth number of frames in the nesting stack
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success
+ */
+JTOK_PARSE_STATUS_t jtok_parser_init(jtok_parser_t *parser, jtok_tkn_t *tkns,
+                                     size_t size, jtok_frame_t *frames,
+                                     size_t max_depth);
+
+
+/**
+ * @brief Continue parsing after more of the json string has arrived
+ *
+ * @param parser parser initialized with jtok_parser_init
+ * @param json buffer holding every chunk received so far followed by the new
+ * chunk. Does not need to be nul-terminated and may have moved since the
+ * previous call
+ * @param len number of chars received so far
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_PARTIAL_TOKEN if more chunks
+ * are required, JTOK_PARSE_STATUS_OK once the top-level object is closed,
+ * otherwise the parse error. Errors are sticky.
+ *
+ * @note Parsing resumes where the previous call stopped, so the total cost
+ * is linear in the size of the json. parser->toknext is the number of
+ * tokens used.
+ */
+JTOK_PARSE_STATUS_t jtok_parser_feed(jtok_parser_t *parser, const char *json,
+                                     size_t len);
+
+
+/**
+ * @brief Validate a json string and count the tokens required to parse it,
+ * without writing any tokens
+ *
+ * @param json json string to scan. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param count number of tokens jtok_parse_n requires for the json string
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note On success, a pool of exactly *count tokens is sufficient to parse
+ * the same json string
+ */
+JTOK_PARSE_STATUS_t jtok_count_tokens(const char *json, size_t len,
+                                      size_t *count);
+
+
+/**
+ * @brief Parse the first len chars of a json string into a document of
+ * compact tokens
+ *
+ * @param doc the document to populate
+ * @param json json string to parse. Does not need to be nul-terminated and
+ * must outlive the document
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of compact tokens
+ * @param size number of tokens in the token pool. At most JTOK_CTKN_POOL_MAX
+ * tokens are used
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note JTOK_INDEX_WIDTH bounds the length of the json string to
+ * JTOK_OFF_MAX chars
+ */
+JTOK_PARSE_STATUS_t jtok_doc_parse(jtok_doc_t *doc, const char *json,
+                                   size_t len, jtok_ctkn_t *tkns, size_t size);
+
+
+/**
+ * @brief Get the top-level object of a document
+ *
+ * @param doc the parsed document
+ * @return const jtok_ctkn_t* NULL if the document is empty
+ */
+const jtok_ctkn_t *jtok_doc_root(const jtok_doc_t *doc);
+
+
+/**
+ * @brief Get the first child of an object, array or key
+ *
+ * @param doc the parsed document
+ * @param tkn token of the document
+ * @return const jtok_ctkn_t* NULL if the token has no children
+ */
+const jtok_ctkn_t *jtok_doc_child(const jtok_doc_t *doc,
+                                  const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Get the next token that shares the same parent
+ *
+ * @param doc the parsed document
+ * @param tkn token of the document
+ * @return const jtok_ctkn_t* NULL if the token is the last child
+ */
+const jtok_ctkn_t *jtok_doc_sibling(const jtok_doc_t *doc,
+                                    const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Get the parent of a token
+ *
+ * @param doc the parsed document
+ * @param tkn token of the document
+ * @return const jtok_ctkn_t* NULL for the top-level object
+ */
+const jtok_ctkn_t *jtok_doc_parent(const jtok_doc_t *doc,
+                                   const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Get the length of a compact token
+ *
+ * @param doc the parsed document
+ * @param tkn token of the document
+ * @return size_t number of chars spanned by the token
+ */
+size_t jtok_doc_toklen(const jtok_doc_t *doc, const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Get the first char of a compact token
+ *
+ * @param doc the parsed document
+ * @param tkn token of the document
+ * @return const char* address of the token in the json string. Strings
+ * exclude their quotes
+ */
+const char *jtok_doc_tokstr(const jtok_doc_t *doc, const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Compare a compact token with a nul-terminated string
+ *
+ * @param doc the parsed document
+ * @param str the string to compare against
+ * @param tkn token of the document
+ * @return true if equal
+ * @return false if not equal
+ */
+bool jtok_doc_tokcmp(const jtok_doc_t *doc, const char *str,
+                     const jtok_ctkn_t *tkn);
+
+
+/**
+ * @brief Find the key of an object
+ *
+ * @param doc the parsed document
+ * @param obj object token of the document
+ * @param key_str the key to look for
+ * @return const jtok_ctkn_t* the key token, NULL if the object has no such
+ * key. The value is the child of the key
+ */
+const jtok_ctkn_t *jtok_doc_obj_has_key(const jtok_doc_t *doc,
+                                        const jtok_ctkn_t *obj,
+                                        const char *       key_str);
+
+
+/**
+ * @brief Parse the first len chars of a json string into a struct-of-arrays
+ * token pool
+ *
+ * @param soa token pool. The field arrays and cap must be set by the caller
+ * @param json json string to parse. Does not need to be nul-terminated and
+ * must outlive the token pool
+ * @param len number of chars in the json string
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note At most JTOK_SOA_POOL_MAX tokens are used
+ */
+JTOK_PARSE_STATUS_t jtok_soa_parse(jtok_soa_t *soa, const char *json,
+                                   size_t len);
+
+
+/**
+ * @brief Get the first child of a token in a struct-of-arrays pool
+ *
+ * @param soa the parsed token pool
+ * @param tkn index of the token
+ * @return jtok_soa_idx_t index of the first child, JTOK_SOA_NONE if none
+ */
+jtok_soa_idx_t jtok_soa_child(const jtok_soa_t *soa, jtok_soa_idx_t tkn);
+
+
+/**
+ * @brief Get the next sibling of a token in a struct-of-arrays pool
+ *
+ * @param soa the parsed token pool
+ * @param tkn index of the token
+ * @return jtok_soa_idx_t index of the next sibling, JTOK_SOA_NONE if none
+ */
+jtok_soa_idx_t jtok_soa_sibling(const jtok_soa_t *soa, jtok_soa_idx_t tkn);
+
+
+/**
+ * @brief Count the tokens of a type in a struct-of-arrays pool
+ *
+ * @param soa the parsed token pool
+ * @param type the type to count
+ * @return size_t number of tokens of that type
+ *
+ * @note Only the type array is read
+ */
+size_t jtok_soa_count_type(const jtok_soa_t *soa, JTOK_TYPE_t type);
+
+
+/**
+ * @brief Collect the indices of the tokens of a type in a struct-of-arrays
+ * pool
+ *
+ * @param soa the parsed token pool
+ * @param type the type to look for
+ * @param from index of the first token to consider
+ * @param out receives the indices of the matching tokens in pool order
+ * @param max number of elements in out
+ * @return size_t number of indices written to out. When equal to max, resume
+ * from out[max - 1] + 1 for the rest
+ *
+ * @note Only the type array is read
+ */
+size_t jtok_soa_find_type(const jtok_soa_t *soa, JTOK_TYPE_t type,
+                          size_t from, jtok_soa_idx_t *out, size_t max);
+
+
+/**
+ * @brief Parse the first len chars of a json string into a tape
+ *
+ * @param tape the tape. The words and cap must be set by the caller
+ * @param json json string to parse. Does not need to be nul-terminated and
+ * must outlive the tape
+ * @param len number of chars in the json string
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note Keys, strings and primitives take 2 words of the tape, objects and
+ * arrays take 4 (their start and end entries)
+ */
+JTOK_PARSE_STATUS_t jtok_tape_parse(jtok_tape_t *tape, const char *json,
+                                    size_t len);
+
+
+/**
+ * @brief Get the tag of a tape entry
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return char one of JTOK_TAPE_*, '\0' if i is out of range
+ */
+char jtok_tape_tag(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Get the index of the entry that follows an entry and, for
+ * containers, its whole subtree
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return size_t index of the next entry
+ *
+ * @note O(1) regardless of the size of the subtree
+ */
+size_t jtok_tape_skip(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Get the first child of an object, array or key. The child of a key
+ * is its value.
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return size_t index of the first child, JTOK_TAPE_NONE if none
+ */
+size_t jtok_tape_child(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Get the next entry that shares the same parent. The sibling of a
+ * key is the next key of the object.
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return size_t index of the next sibling, JTOK_TAPE_NONE if none
+ */
+size_t jtok_tape_sibling(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Get the length of a tape entry
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return size_t number of chars spanned by the entry. Containers include
+ * their braces, strings exclude their quotes
+ */
+size_t jtok_tape_toklen(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Get the first char of a tape entry
+ *
+ * @param tape the parsed tape
+ * @param i index of the entry
+ * @return const char* address of the entry in the json string. Strings
+ * exclude their quotes
+ */
+const char *jtok_tape_tokstr(const jtok_tape_t *tape, size_t i);
+
+
+/**
+ * @brief Compare a tape entry with a nul-terminated string
+ *
+ * @param tape the parsed tape
+ * @param str the string to compare against
+ * @param i index of the entry
+ * @return true if equal
+ * @return false if not equal
+ */
+bool jtok_tape_tokcmp(const jtok_tape_t *tape, const char *str, size_t i);
+
+
+/**
+ * @brief Find the key of an object on a tape
+ *
+ * @param tape the parsed tape
+ * @param obj index of the object entry
+ * @param key_str the key to look for
+ * @return size_t index of the key entry, JTOK_TAPE_NONE if the object has no
+ * such key. The value is the child of the key
+ *
+ * @note Values of other keys are skipped in O(1)
+ */
+size_t jtok_tape_obj_has_key(const jtok_tape_t *tape, size_t obj,
+                             const char *key_str);
+
+
+/**
+ * @brief Position a cursor on the top-level object of a json string
+ *
+ * @param cur the cursor
+ * @param json json string to navigate. Does not need to be nul-terminated and
+ * must outlive the cursor
+ * @param len number of chars in the json string
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success
+ *
+ * @note Nothing past the opening brace is scanned
+ */
+JTOK_PARSE_STATUS_t jtok_cursor_init(jtok_cursor_t *cur, const char *json,
+                                     size_t len);
+
+
+/**
+ * @brief Position a cursor on the first child of an object or array. The
+ * children of an object are its keys.
+ *
+ * @param agg cursor on an object or array
+ * @param child cursor to position. Its type is JTOK_UNASSIGNED_TOKEN if the
+ * aggregate is empty
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success, otherwise the
+ * parse error found
+ */
+JTOK_PARSE_STATUS_t jtok_cursor_first(const jtok_cursor_t *agg,
+                                      jtok_cursor_t *      child);
+
+
+/**
+ * @brief Advance a cursor to the next child of its parent. Cursors on a key
+ * or on the value of a key advance to the next key.
+ *
+ * @param cur the cursor. Its type is JTOK_UNASSIGNED_TOKEN once past the last
+ * child
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success, otherwise the
+ * parse error found
+ *
+ * @note Values stepped over are skipped by bracket matching and are only
+ * validated as far as their nesting
+ */
+JTOK_PARSE_STATUS_t jtok_cursor_next(jtok_cursor_t *cur);
+
+
+/**
+ * @brief Position a cursor on the value of a key
+ *
+ * @param key cursor on a key
+ * @param value cursor to position
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success, otherwise the
+ * parse error found
+ */
+JTOK_PARSE_STATUS_t jtok_cursor_value(const jtok_cursor_t *key,
+                                      jtok_cursor_t *      value);
+
+
+/**
+ * @brief Position a cursor on the value of a key of an object
+ *
+ * @param obj cursor on an object
+ * @param key_str the key to look for
+ * @param value cursor to position. Its type is JTOK_UNASSIGNED_TOKEN if the
+ * object has no such key
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success, otherwise the
+ * parse error found
+ */
+JTOK_PARSE_STATUS_t jtok_cursor_find_key(const jtok_cursor_t *obj,
+                                         const char *         key_str,
+                                         jtok_cursor_t *      value);
+
+
+/**
+ * @brief Get the length of the value under a cursor
+ *
+ * @param cur the cursor
+ * @return size_t number of chars spanned by the value. Objects and arrays
+ * include their brackets, strings exclude their quotes
+ */
+size_t jtok_cursor_toklen(const jtok_cursor_t *cur);
+
+
+/**
+ * @brief Compare the value under a cursor with a nul-terminated string
+ *
+ * @param str the string to compare against
+ * @param cur the cursor
+ * @return true if equal
+ * @return false if not equal
+ */
+bool jtok_cursor_tokcmp(const char *str, const jtok_cursor_t *cur);
+
+
+/**
+ * @brief Start iterating over the records of a newline-delimited json buffer
+ *
+ * @param nd the iterator
+ * @param buf buffer of records separated by '\n'. Does not need to be
+ * nul-terminated and must outlive the iterator
+ * @param len number of chars in the buffer
+ */
+void jtok_ndjson_init(jtok_ndjson_t *nd, const char *buf, size_t len);
+
+
+/**
+ * @brief Parse the next record of a newline-delimited json buffer into a
+ * token pool that is reused for every record
+ *
+ * @param nd the iterator
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool
+ * @param rec the record that was parsed
+ * @return true if a record was parsed, false at the end of the buffer
+ *
+ * @note Blank lines are skipped. A malformed record is returned with its
+ * error status and the iterator resumes at the next line, so one bad record
+ * never affects the records around it.
+ * @note An unterminated last line that ends mid-record is not consumed.
+ * nd->pos is left at its first char so a stream can carry it over to the
+ * next buffer.
+ */
+bool jtok_ndjson_next(jtok_ndjson_t *nd, jtok_tkn_t *tkns, size_t size,
+                      jtok_ndjson_rec_t *rec);
+
+
+/**
+ * @brief Parse every record of a newline-delimited json buffer and pass each
+ * one to a callback
+ *
+ * @param buf buffer of records separated by '\n'. Does not need to be
+ * nul-terminated
+ * @param len number of chars in the buffer
+ * @param tkns caller-provided pool of tokens, reused for every record
+ * @param size number of tokens in the token pool
+ * @param cb callback invoked for every record, including malformed ones
+ * @param ctx caller context passed to the callback
+ * @param consumed number of chars consumed (may be NULL). Less than len if
+ * the callback stopped early or the last line is cut off
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK, or the status of the
+ * first malformed record
+ */
+JTOK_PARSE_STATUS_t jtok_ndjson_parse(const char *buf, size_t len,
+                                      jtok_tkn_t *tkns, size_t size,
+                                      jtok_ndjson_cb_t cb, void *ctx,
+                                      size_t *consumed);
+
+
+#if JTOK_THREADS
+/**
+ * @brief Parse a newline-delimited json buffer on several threads
+ *
+ * @param buf buffer of records separated by '\n'. Does not need to be
+ * nul-terminated
+ * @param len number of chars in the buffer
+ * @param workers one worker per thread. Worker 0 runs on the calling thread
+ * @param nworkers number of workers
+ * @param chunk_size approximate number of chars per chunk, 0 for
+ * JTOK_BATCH_CHUNK_SIZE
+ * @param order the order records are delivered in
+ * @param cb callback invoked for every record, including malformed ones
+ * @param ctx caller context passed to the callback
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK, or the status of the
+ * first malformed record in buffer order
+ *
+ * @note The buffer is split into newline-aligned chunks that are dealt out
+ * to the workers. A worker that runs out of chunks steals half of the
+ * remaining chunks of another worker, so records of uneven size stay
+ * balanced.
+ * @note With JTOK_BATCH_ORDERED a worker holds up to nrecs records in its
+ * token pool until every chunk before its own has been delivered, and
+ * rec->index is the record number in the whole buffer. With
+ * JTOK_BATCH_UNORDERED rec->index only counts the records of a chunk.
+ * @note A last line that ends mid-record is delivered with
+ * JTOK_PARSE_STATUS_PARTIAL_TOKEN.
+ */
+JTOK_PARSE_STATUS_t jtok_batch_parse(const char *buf, size_t len,
+                                     jtok_batch_worker_t *workers,
+                                     size_t nworkers, size_t chunk_size,
+                                     JTOK_BATCH_ORDER_t order,
+                                     jtok_batch_cb_t cb, void *ctx);
+
+
+/**
+ * @brief Parse the first len chars of a json string on several threads
+ *
+ * @param json json string to parse. Does not need to be nul-terminated
+ * @param len number of chars in the json string
+ * @param tkns caller-provided pool of tokens
+ * @param size number of tokens in the token pool
+ * @param nthreads max number of threads, including the calling thread
+ * @param used number of tokens written to the pool (may be NULL)
+ * @return JTOK_PARSE_STATUS_t parse status. JTOK_PARSE_STATUS_OK == success
+ *
+ * @note The largest array directly inside the top-level object is split at
+ * element boundaries found by a structural pass. Each slice is tokenized by
+ * its own thread into a region of the pool sized by the slice's length,
+ * then the regions are moved together and their parent and sibling indices
+ * are fixed up. A slice whose region runs out counts the rest of its
+ * tokens and finishes in its final place, so a pool of exactly the tokens
+ * the document needs is enough. Everything else is parsed on the calling
+ * thread.
+ * @note The tokens and the status are the same as jtok_parse_n_used would
+ * produce. Documents that are too small to split, errors and pools that are
+ * too small for the document fall back to a single-threaded parse.
+ */
+JTOK_PARSE_STATUS_t jtok_parse_parallel(const char *json, size_t len,
+                                        jtok_tkn_t *tkns, size_t size,
+                                        size_t nthreads, size_t *used);
+#endif /* #if JTOK_THREADS */
+
+
 /**
  * @brief get the token length of a jtok_tkn_t;
  *
  * @param tok
- * @return uint32_t the length of the token
+ * @return size_t the length of the token
  */
-uint_least16_t jtok_toklen(const jtok_tkn_t *tok);
+size_t jtok_toklen(const jtok_tkn_t *tok);
 
 
 /**
@@ -184,7 +1242,7 @@ bool jtok_tokcmp(const char *str, const jtok_tkn_t *tok);
  * @return true if equal within bytecount
  * @return false if not equal within bytecount
  */
-bool jtok_tokncmp(const char *str, const jtok_tkn_t *tok, uint_least16_t n);
+bool jtok_tokncmp(const char *str, const jtok_tkn_t *tok, size_t n);
 
 
 /**
@@ -195,7 +1253,7 @@ bool jtok_tokncmp(const char *str, const jtok_tkn_t *tok, uint_least16_t n);
  * @param tkn jtok token to copy
  * @return char* NULL on error, otherwise, address of destination
  */
-char *jtok_tokcpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn);
+char *jtok_tokcpy(char *dst, size_t bufsize, const jtok_tkn_t *tkn);
 
 
 /**
@@ -206,8 +1264,170 @@ char *jtok_tokcpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn);
  * @param tkn jtok token to copy
  * @return char* NULL on error, otherwise, address of destination
  */
-char *jtok_tokncpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn,
-                   uint_least16_t n);
+char *jtok_tokncpy(char *dst, size_t bufsize, const jtok_tkn_t *tkn,
+                   size_t n);
+
+
+/**
+ * @brief Get the value of an integer token
+ *
+ * @param tkn the token, a JTOK_PRIMITIVE with subtype JTOK_SUBTYPE_INTEGER
+ * @param value the value. Left untouched if not converted
+ * @return true if converted
+ * @return false if the token is not an integer or does not fit in an int64_t
+ */
+bool jtok_tok_to_int64(const jtok_tkn_t *tkn, int64_t *value);
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Get the value of a number token, correctly rounded to a double
+ *
+ * @param tkn the token, a JTOK_PRIMITIVE with a number subtype
+ * @param value the value, +-HUGE_VAL or +-0 when out of range. Left
+ * untouched if not converted
+ * @return true if converted
+ * @return false if the token is not a number
+ *
+ * @note Does not depend on the locale, and is correctly rounded whatever the
+ * number of digits
+ */
+bool jtok_tok_to_double(const jtok_tkn_t *tkn, double *value);
+#endif /* #if JTOK_FLOAT */
+
+
+/**
+ * @brief Get the value of a number token as a Q16.16 fixed-point number,
+ * using integer arithmetic only
+ *
+ * @param tkn the token, a JTOK_PRIMITIVE with a number subtype
+ * @param value the value times 2^16, rounded to nearest with ties away from
+ * zero. Left untouched if not converted
+ * @return true if converted
+ * @return false if the token is not a number or is out of the range
+ * [-32768, 32768)
+ *
+ * @note Digits past the 19th significant one are ignored
+ */
+bool jtok_tok_to_q16_16(const jtok_tkn_t *tkn, int32_t *value);
+
+
+/**
+ * @brief Get the value of a number token scaled by a power of ten, using
+ * integer arithmetic only, eg: 12.345 with 2 decimals is 1235
+ *
+ * @param tkn the token, a JTOK_PRIMITIVE with a number subtype
+ * @param decimals number of decimal places kept
+ * @param value the value times 10^decimals, rounded to nearest with ties
+ * away from zero. Left untouched if not converted
+ * @return true if converted
+ * @return false if the token is not a number or the scaled value does not
+ * fit in an int64_t
+ *
+ * @note Digits past the 19th significant one are ignored
+ */
+bool jtok_tok_to_scaled(const jtok_tkn_t *tkn, unsigned int decimals,
+                        int64_t *value);
+
+
+/**
+ * @brief Get the value of a true or false token
+ *
+ * @param tkn the token, a JTOK_PRIMITIVE with subtype JTOK_SUBTYPE_TRUE or
+ * JTOK_SUBTYPE_FALSE
+ * @param value the value. Left untouched if not converted
+ * @return true if converted
+ * @return false if the token is not true or false
+ */
+bool jtok_tok_to_bool(const jtok_tkn_t *tkn, bool *value);
+
+
+/**
+ * @brief Convert every element of an array of integers into a buffer
+ *
+ * @param arr the array token, from a jtok_tkn_t pool
+ * @param dst the buffer
+ * @param size number of elements the buffer holds
+ * @param count set to the number of elements converted. May be NULL
+ * @return true if all elements were converted
+ * @return false if arr is not an array, has more than size elements, or an
+ * element is not an integer or does not fit in an int32_t. Elements before
+ * it are converted
+ *
+ * @note The elements are the tokens right after the array, so they are
+ * converted in one pass over the pool without following sibling links
+ */
+bool jtok_array_to_int32(const jtok_tkn_t *arr, int32_t *dst, size_t size,
+                         size_t *count);
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Convert every element of an array of numbers into a buffer of
+ * doubles
+ *
+ * @param arr the array token, from a jtok_tkn_t pool
+ * @param dst the buffer
+ * @param size number of elements the buffer holds
+ * @param count set to the number of elements converted. May be NULL
+ * @return true if all elements were converted
+ * @return false if arr is not an array, has more than size elements, or an
+ * element is not a number. Elements before it are converted
+ *
+ * @note Each element is rounded like jtok_tok_to_double rounds it
+ */
+bool jtok_array_to_double(const jtok_tkn_t *arr, double *dst, size_t size,
+                          size_t *count);
+#endif /* #if JTOK_FLOAT */
+
+
+/**
+ * @brief Convert every element of an array of true and false into a buffer
+ *
+ * @param arr the array token, from a jtok_tkn_t pool
+ * @param dst the buffer
+ * @param size number of elements the buffer holds
+ * @param count set to the number of elements converted. May be NULL
+ * @return true if all elements were converted
+ * @return false if arr is not an array, has more than size elements, or an
+ * element is not true or false. Elements before it are converted
+ */
+bool jtok_array_to_bool(const jtok_tkn_t *arr, bool *dst, size_t size,
+                        size_t *count);
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Convert nested arrays of numbers of the same length into a dense
+ * row-major buffer of doubles
+ *
+ * @param arr the outer array token, from a jtok_tkn_t pool
+ * @param dst the buffer
+ * @param size number of elements the buffer holds
+ * @param shape set to the shape of the tensor, also when false is returned
+ * because the buffer is too small
+ * @return true if all elements were converted
+ * @return false if arr is not an array, the nesting is deeper than
+ * JTOK_TENSOR_MAX_RANK, the arrays at one depth differ in length, an
+ * element is not a number, or the tensor has more than size elements
+ *
+ * @note The shape is that of the first array at each depth. The tokens of
+ * the tensor are then checked and converted in one pass over the pool
+ */
+bool jtok_array_to_tensor_double(const jtok_tkn_t *arr, double *dst,
+                                 size_t size, jtok_shape_t *shape);
+
+
+/**
+ * @brief Convert nested arrays of numbers of the same length into a dense
+ * row-major buffer of floats
+ *
+ * @note Same as jtok_array_to_tensor_double. Each element is rounded to a
+ * double and then to a float
+ */
+bool jtok_array_to_tensor_float(const jtok_tkn_t *arr, float *dst,
+                                size_t size, jtok_shape_t *shape);
+#endif /* #if JTOK_FLOAT */
 
 
 /**
@@ -261,7 +1481,9 @@ int jtok_token_tostr(char *buf, unsigned int size, const char *json,
  * @return true if tokens are equal
  * @return false if not equal.
  *
- * @note Tokens with different types are never equal
+ * @note Tokens with different types are never equal. Numbers are equal when
+ * their values are, eg: 1, 1.0 and 10e-1, and are compared exactly digit by
+ * digit without converting them
  */
 bool jtok_toktokcmp(const jtok_tkn_t *tkn1, const jtok_tkn_t *tkn2);
 
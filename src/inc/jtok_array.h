@@ -9,15 +9,26 @@ extern "C"
 
 #include "jtok.h"
 
+/* Parse states of an array frame, kept in jtok_frame_t.expecting */
+enum
+{
+    ARRAY_START,
+    ARRAY_VALUE,
+    ARRAY_COMMA
+};
+
 /**
- * @brief Parse and fill the next available jtok token as a jtok array,
- * recursing into sub-objects
+ * @brief Consume the json string for the array on top of the parser's
+ * nesting stack until it is closed or a child aggregate is opened
  *
  * @param parser the json parser
- * @param depth the parse nesting depth
  * @return JTOK_PARSE_STATUS_t parser status
+ *
+ * @note Child aggregates are pushed as new frames rather than parsed
+ * recursively, so the caller keeps dispatching on the top frame until the
+ * nesting stack is empty
  */
-JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser, int depth);
+JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser);
 
 /**
  * @brief Compare two jtok tokens with type JTOK_ARRAY for equality
@@ -0,0 +1,139 @@
+#ifndef __JTOK_INDEX_H__
+#define __JTOK_INDEX_H__
+#ifdef __cplusplus
+/* clang-format off */
+extern "C"
+{
+/* clang-format on */
+#endif /* Start C linkage */
+
+#include <stdint.h>
+
+#include "jtok.h"
+#include "jtok_kernel.h"
+
+/* Set to 1 for jtok_parse to skip whitespace with the stage-1 whitespace
+ * bitmap instead of a word at a time. Off by default: parsing was measured
+ * no faster with it */
+#ifndef JTOK_STRUCTURAL_INDEX
+#define JTOK_STRUCTURAL_INDEX 0
+#endif /* #ifndef JTOK_STRUCTURAL_INDEX */
+
+/* Set to 0 to build the portable kernels only. Otherwise the SSE2 and AVX2
+ * kernels are built on x86 and picked at run time */
+#ifndef JTOK_SIMD
+#define JTOK_SIMD 1
+#endif /* #ifndef JTOK_SIMD */
+
+#define JTOK_BLOCK_SIZE 64 /* number of chars classified per block */
+
+
+/**
+ * @brief Classify the 64 byte block of the json string starting at base
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param base index of the first char of the block. Must be a multiple of
+ * JTOK_BLOCK_SIZE
+ * @param blk the block index to populate
+ *
+ * @note chars past len are never read and are classified as nothing
+ */
+void jtok_index_block(const char *json, jtok_pos_t len, jtok_pos_t base,
+                      jtok_block_t *blk);
+
+
+/**
+ * @brief Reset the structural index of a parser so the next lookup
+ * reclassifies from the json string
+ *
+ * @param parser the json parser
+ */
+void jtok_index_reset(jtok_parser_t *parser);
+
+
+/**
+ * @brief Advance the parser to the next non-whitespace character
+ *
+ * @param parser the json parser
+ *
+ * @note parser->pos == parser->json_len if only whitespace remains
+ */
+void jtok_skip_whitespace(jtok_parser_t *parser);
+
+
+/**
+ * @brief Find the next structural, quote or backslash character of a json
+ * string
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start looking at
+ * @param blk block index cache. Set blk->base to JTOK_INVALID_ARRAY_INDEX
+ * before the first call
+ * @return jtok_pos_t index of the character, len if there is none
+ */
+jtok_pos_t jtok_index_next_special(const char *json, jtok_pos_t len,
+                                   jtok_pos_t pos, jtok_block_t *blk);
+
+
+/**
+ * @brief Find the next closing quote or backslash inside a string
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start looking at
+ * @param quote the quote char that opened the string
+ * @return jtok_pos_t index of the char, len if there is none
+ *
+ * @note Runs the kernel selected by jtok_init or jtok_set_kernel. Chars past
+ * len are never read
+ */
+jtok_pos_t jtok_index_next_string_special(const char *json, jtok_pos_t len,
+                                          jtok_pos_t pos, char quote);
+
+
+/**
+ * @brief Classify the brackets and string delimiters of the 64 chars of the
+ * json string starting at base
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param base index of the first char. Need not be block aligned
+ * @param blk the bracket block to populate
+ *
+ * @note chars past len are never read and are classified as nothing. Runs
+ * the kernel selected by jtok_init or jtok_set_kernel whatever
+ * JTOK_STRUCTURAL_INDEX
+ */
+void jtok_index_brackets(const char *json, jtok_pos_t len, jtok_pos_t base,
+                         jtok_bracket_block_t *blk);
+
+
+/**
+ * @brief Find the char that closes the aggregate a json string is inside,
+ * or the first comma between its children at or after an index. The chars
+ * inside strings are masked out of each 64 char block, and a block that
+ * can't bring the depth back to 0 is stepped over whole
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start looking at, outside of any string
+ * @param comma index of the first comma to stop at. len to only stop at the
+ * closing char
+ * @return jtok_pos_t index of the char, len if there is none
+ *
+ * @note Blocks with a single quote outside the double quoted strings are
+ * walked one char of interest at a time, since either quote may then open
+ * a string
+ */
+jtok_pos_t jtok_index_match(const char *json, jtok_pos_t len, jtok_pos_t pos,
+                            jtok_pos_t comma);
+
+
+#ifdef __cplusplus
+/* clang-format off */
+}
+/* clang-format on */
+#endif /* End C linkage */
+#endif /* __JTOK_INDEX_H__ */
@@ -0,0 +1,75 @@
+#ifndef __JTOK_KERNEL_H__
+#define __JTOK_KERNEL_H__
+#ifdef __cplusplus
+/* clang-format off */
+extern "C"
+{
+/* clang-format on */
+#endif /* Start C linkage */
+
+#include <stdint.h>
+
+#include "jtok.h"
+
+/**
+ * Brackets, commas and string delimiters of a 64 byte block, all the bracket
+ * matcher needs. Bit i of each mask describes the char at offset i
+ */
+typedef struct
+{
+    uint64_t open;      /* '{', '[' */
+    uint64_t close;     /* '}', ']' */
+    uint64_t comma;     /* ',' */
+    uint64_t quote;     /* '\"' */
+    uint64_t squote;    /* '\'' */
+    uint64_t backslash; /* '\\' */
+} jtok_bracket_block_t;
+
+/**
+ * Scanning functions of one kernel
+ */
+typedef struct
+{
+    /* classify 64 chars into the bitmaps of a block index */
+    void (*classify)(const char *blk, jtok_block_t *idx);
+
+    /* whitespace bitmap of 64 chars, all the parse path needs */
+    uint64_t (*whitespace)(const char *blk);
+
+    /* find the next closing quote or backslash inside a string */
+    jtok_pos_t (*next_string_special)(const char *json, jtok_pos_t len,
+                                      jtok_pos_t pos, char quote);
+
+    /* classify 64 chars into the bitmaps of a bracket block */
+    void (*brackets)(const char *blk, jtok_bracket_block_t *idx);
+} jtok_kernel_ops_t;
+
+
+/* Functions of the kernel in use */
+extern const jtok_kernel_ops_t *jtok_kernel_ops;
+
+
+/**
+ * @brief Count the trailing zero bits of a mask
+ *
+ * @param mask the mask, must not be 0
+ * @return unsigned int index of the lowest set bit
+ */
+unsigned int jtok_ctz64(uint64_t mask);
+
+
+/**
+ * @brief Count the set bits of a mask
+ *
+ * @param mask the mask
+ * @return unsigned int number of set bits
+ */
+unsigned int jtok_popcount64(uint64_t mask);
+
+
+#ifdef __cplusplus
+/* clang-format off */
+}
+/* clang-format on */
+#endif /* End C linkage */
+#endif /* __JTOK_KERNEL_H__ */
@@ -0,0 +1,158 @@
+#ifndef __JTOK_NUMBER_H__
+#define __JTOK_NUMBER_H__
+#ifdef __cplusplus
+/* clang-format off */
+extern "C"
+{
+/* clang-format on */
+#endif /* Start C linkage */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "jtok.h"
+
+#if JTOK_FLOAT
+/* Range of the decimal exponents in the table of powers of five. Outside it
+ * a double is 0 or infinite whatever its mantissa */
+#define JTOK_POW5_MIN (-342)
+#define JTOK_POW5_MAX (308)
+
+/* Significant digits a double conversion reads. The points half way between
+ * two doubles have at most 767, so the digits past these only tell whether
+ * the number is above such a point */
+#define JTOK_DOUBLE_DIGITS_MAX (768)
+
+/* 32 bit limbs of a big integer. Holds 10^768, and 2^54 * 5^1091 for the
+ * half way point below the smallest subnormal scaled to 768 digits */
+#define JTOK_BIGINT_LIMBS (86)
+#endif /* #if JTOK_FLOAT */
+
+/* Max number of significant digits a decimal mantissa holds exactly */
+#define JTOK_DECIMAL_DIGITS_MAX (19)
+
+/**
+ * Number split into a decimal mantissa and exponent:
+ * value = (-1)^negative * mantissa * 10^exp10
+ */
+typedef struct
+{
+    uint64_t mantissa;  /* first JTOK_DECIMAL_DIGITS_MAX significant digits */
+    int32_t  exp10;     /* power of ten of the last digit kept */
+    int      digits;    /* number of significant digits kept */
+    bool     negative;  /* the number has a minus sign */
+    bool     truncated; /* nonzero digits were dropped from the mantissa */
+} jtok_decimal_t;
+
+/* Max number of significant digits of an exponent that jtok_lexeme_t
+ * adds to exp10 */
+#define JTOK_LEXEME_EXP10_DIGITS (17)
+
+/**
+ * Significant digits of a number as a view into its text, with the leading
+ * and trailing zeros stripped: value = (-1)^negative * d.ddd * 10^exp10
+ *
+ * An exponent with more than JTOK_LEXEME_EXP10_DIGITS significant digits is
+ * left out of exp10 and only kept as text
+ */
+typedef struct
+{
+    const char *first;        /* first significant digit, NULL if 0 */
+    const char *last;         /* last significant digit */
+    const char *point;        /* the decimal point, NULL if there is none */
+    const char *exp_first;    /* first significant digit of the exponent */
+    const char *exp_end;      /* end of the digits of the exponent */
+    int64_t     exp10;        /* power of ten of the first significant digit */
+    bool        negative;     /* the number has a minus sign */
+    bool        exp_negative; /* the exponent has a minus sign */
+} jtok_lexeme_t;
+
+#if JTOK_FLOAT
+/**
+ * Unsigned big integer, least significant limb first
+ */
+typedef struct
+{
+    uint32_t limb[JTOK_BIGINT_LIMBS];
+    size_t   len; /* number of limbs in use, 0 for the value 0 */
+} jtok_bigint_t;
+
+/* 128 bit approximations of 5^q, high word first, for q in
+ * [JTOK_POW5_MIN, JTOK_POW5_MAX] */
+extern const uint64_t jtok_pow5_table[2 * (JTOK_POW5_MAX - JTOK_POW5_MIN + 1)];
+#endif /* #if JTOK_FLOAT */
+
+
+/**
+ * @brief Split the text of a number into a decimal mantissa and exponent
+ *
+ * @param str the number, eg: -12.5e3
+ * @param len number of chars of the number
+ * @param dec the decimal
+ * @return true if all len chars are one number, false otherwise
+ */
+bool jtok_number_decimal(const char *str, jtok_pos_t len, jtok_decimal_t *dec);
+
+
+/**
+ * @brief Convert the text of an integer to its value
+ *
+ * @param str the integer, eg: -12
+ * @param len number of chars of the integer
+ * @param value the value
+ * @return true if converted, false if not an integer or out of range
+ */
+bool jtok_number_to_int64(const char *str, jtok_pos_t len, int64_t *value);
+
+
+/**
+ * @brief Find the significant digits of the text of a number
+ *
+ * @param str the number, eg: -0012.50e3
+ * @param len number of chars of the number
+ * @param lex the lexeme, eg: digits 125 with exp10 4
+ * @return true if all len chars are one number, false otherwise
+ */
+bool jtok_number_lexeme(const char *str, jtok_pos_t len, jtok_lexeme_t *lex);
+
+
+/**
+ * @brief Compare the values of the texts of two numbers
+ *
+ * @param str1 the first number, eg: 1.0
+ * @param len1 number of chars of the first number
+ * @param str2 the second number, eg: 10e-1
+ * @param len2 number of chars of the second number
+ * @return true if both are numbers of the same value
+ *
+ * @note Exact for any number of digits. The sign, the power of ten of the
+ * first significant digit and then the significant digits are compared,
+ * without converting either number
+ */
+bool jtok_number_eq(const char *str1, jtok_pos_t len1, const char *str2,
+                    jtok_pos_t len2);
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Convert the text of a number to the nearest double
+ *
+ * @param str the number, eg: -12.5e3
+ * @param len number of chars of the number
+ * @param value the value
+ * @return true if converted, false if not a number
+ *
+ * @note Reads only the len chars and does not depend on the locale. When the
+ * digits past the 19th decide the rounding, up to JTOK_DOUBLE_DIGITS_MAX of
+ * them are compared with the half way point between the two nearest doubles
+ */
+bool jtok_number_to_double(const char *str, jtok_pos_t len, double *value);
+#endif /* #if JTOK_FLOAT */
+
+
+#ifdef __cplusplus
+/* clang-format off */
+}
+/* clang-format on */
+#endif /* End C linkage */
+#endif /* __JTOK_NUMBER_H__ */
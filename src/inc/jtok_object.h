@@ -12,14 +12,17 @@ extern "C"
 #include "jtok.h"
 
 /**
- * @brief Parse and fill the next available jtok token as a jtok object,
- * recursing into sub-objects
+ * @brief Consume the json string for the object on top of the parser's
+ * nesting stack until it is closed or a child aggregate is opened
  *
  * @param parser the json parser
- * @param depth the parse nesting depth
  * @return JTOK_PARSE_STATUS_t parser status
+ *
+ * @note Child aggregates are pushed as new frames rather than parsed
+ * recursively, so the caller keeps dispatching on the top frame until the
+ * nesting stack is empty
  */
-JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth);
+JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser);
 
 
 /**
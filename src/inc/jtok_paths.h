@@ -0,0 +1,37 @@
+#ifndef __JTOK_PATHS_H__
+#define __JTOK_PATHS_H__
+#ifdef __cplusplus
+/* clang-format off */
+extern "C"
+{
+/* clang-format on */
+#endif /* Start C linkage */
+
+#include <stdbool.h>
+
+#include "jtok.h"
+
+
+/**
+ * @brief Decide if the token the parser is about to allocate lies on one of
+ * its projection paths
+ *
+ * @param parser the json parser. parser->toksuper and the nesting stack
+ * describe where the token is
+ * @param start start index of the token
+ * @param end end index of the token
+ * @return true if the token is kept, false if it is only validated
+ *
+ * @note parser->sel_paths and parser->sel_all are updated with the paths the
+ * token matched so the frame of an aggregate value can inherit them
+ */
+bool jtok_paths_select(jtok_parser_t *parser, jtok_pos_t start,
+                       jtok_pos_t end);
+
+
+#ifdef __cplusplus
+/* clang-format off */
+}
+/* clang-format on */
+#endif /* End C linkage */
+#endif /* __JTOK_PATHS_H__ */
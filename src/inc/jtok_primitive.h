@@ -26,6 +26,10 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser);
  * @param tkn2 second token
  * @return true if equal
  * @return false if not equal
+ *
+ * @note Numbers are compared by value using the subtypes recorded by the
+ * parser: 1, +1, 1.0 and 1e0 are equal. true, false and null only equal
+ * themselves
  */
 bool jtok_toktokcmp_primitive(const jtok_tkn_t *tkn1, const jtok_tkn_t *tkn2);
 
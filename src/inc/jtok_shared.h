@@ -17,6 +17,71 @@ extern "C"
 
 #define HEXCHAR_ESCAPE_SEQ_COUNT 4 /* can escape 4 hex chars such as \uffea */
 
+/* Index of a token that a projection parsed but did not keep */
+#define JTOK_SKIPPED_TOKEN_IDX (-2)
+
+/**
+ * Class of a json char. The parse state machines switch on the class of a
+ * char rather than on the char itself
+ */
+typedef enum
+{
+    JTOK_CHAR_OTHER,      /* not part of the json grammar */
+    JTOK_CHAR_WHITESPACE, /* ' ', '\t', '\r', '\n' */
+    JTOK_CHAR_OBJ_OPEN,   /* '{' */
+    JTOK_CHAR_OBJ_CLOSE,  /* '}' */
+    JTOK_CHAR_ARR_OPEN,   /* '[' */
+    JTOK_CHAR_ARR_CLOSE,  /* ']' */
+    JTOK_CHAR_COLON,      /* ':' */
+    JTOK_CHAR_COMMA,      /* ',' */
+    JTOK_CHAR_QUOTE,      /* '\"', '\'' */
+    JTOK_CHAR_BACKSLASH,  /* '\\' */
+    JTOK_CHAR_DIGIT,      /* '0' ... '9' */
+    JTOK_CHAR_SIGN,       /* '+', '-' */
+    JTOK_CHAR_DOT,        /* '.' */
+    JTOK_CHAR_EXPONENT,   /* 'e', 'E' */
+    JTOK_CHAR_LITERAL,    /* 't', 'f', 'n' that start true, false and null */
+} JTOK_CHAR_CLASS_t;
+
+/* Bits of a jtok_char_table entry holding the JTOK_CHAR_CLASS_t */
+#define JTOK_CHAR_CLASS_MASK 0x1Fu
+
+/* Flag of a jtok_char_table entry for a hex digit of a \uXXXX escape */
+#define JTOK_CHAR_HEX 0x20u
+
+/* Flag of a jtok_char_table entry for a char that may follow a backslash in
+ * a string. \uXXXX escapes are checked separately */
+#define JTOK_CHAR_ESCAPE 0x40u
+
+/* Class of a char */
+#define JTOK_CHAR_CLASS(c)                                                     \
+    ((JTOK_CHAR_CLASS_t)(jtok_char_table[(unsigned char)(c)] &                \
+                         JTOK_CHAR_CLASS_MASK))
+
+/* True if a char has the JTOK_CHAR_HEX or JTOK_CHAR_ESCAPE flag */
+#define JTOK_CHAR_IS(c, flag)                                                  \
+    ((jtok_char_table[(unsigned char)(c)] & (flag)) != 0)
+
+/* Class and flags of every char, shared by every parse module */
+extern const uint8_t jtok_char_table[256];
+
+/**
+ * @brief Create a parser positioned at the start of a json string
+ *
+ * @param json_str the json string
+ * @param len number of chars in the json string
+ * @param tokens token pool. NULL if the parser writes another output or only
+ * counts tokens
+ * @param poolsize max number of tokens the parser may allocate
+ * @param frames nesting stack
+ * @param max_depth number of frames in the nesting stack
+ * @return jtok_parser_t the parser
+ */
+jtok_parser_t jtok_new_parser(const char *json_str, size_t len,
+                              jtok_tkn_t *tokens, size_t poolsize,
+                              jtok_frame_t *frames, size_t max_depth);
+
+
 /**
  * @brief Allocate fresh token from the token pool
  *
@@ -40,6 +105,86 @@ jtok_tkn_t *jtok_alloc_token(jtok_parser_t *parser);
 int jtok_fill_token(jtok_tkn_t *token, JTOK_TYPE_t type, int start, int end);
 
 
+/**
+ * @brief Allocate and fill the next token. Its parent is the parser's current
+ * superior token.
+ *
+ * @param parser the json parser
+ * @param type the token type
+ * @param start start index
+ * @param end end index
+ * @return jtok_pos_t index of the new token, JTOK_INVALID_ARRAY_INDEX if the
+ * token pool is exhausted or JTOK_SKIPPED_TOKEN_IDX if the parser projects
+ * onto paths the token is not on
+ *
+ * @note When the parser has no token pool, tokens are only counted
+ */
+jtok_pos_t jtok_new_token(jtok_parser_t *parser, JTOK_TYPE_t type,
+                          jtok_pos_t start, jtok_pos_t end);
+
+
+/**
+ * @brief Set the end index of a token
+ *
+ * @param parser the json parser
+ * @param tkn index of the token. Skipped tokens are ignored
+ * @param end end index
+ */
+void jtok_token_set_end(jtok_parser_t *parser, jtok_pos_t tkn, jtok_pos_t end);
+
+
+/**
+ * @brief Set the subtype of a primitive token
+ *
+ * @param parser the json parser
+ * @param tkn index of the token. Skipped tokens are ignored
+ * @param subtype the subtype
+ */
+void jtok_token_set_subtype(jtok_parser_t *parser, jtok_pos_t tkn,
+                            JTOK_SUBTYPE_t subtype);
+
+
+/**
+ * @brief Increase the number of child tokens of a token
+ *
+ * @param parser the json parser
+ * @param tkn index of the token. Skipped tokens are ignored
+ */
+void jtok_token_add_child(jtok_parser_t *parser, jtok_pos_t tkn);
+
+
+/**
+ * @brief Make a token the next sibling of another
+ *
+ * @param parser the json parser
+ * @param tkn index of the token
+ * @param sibling index of its next sibling
+ */
+void jtok_token_link(jtok_parser_t *parser, jtok_pos_t tkn,
+                     jtok_pos_t sibling);
+
+
+/**
+ * @brief Allocate the aggregate token starting at the current parser position
+ * and push a nesting frame for it
+ *
+ * @param parser the json parser
+ * @param type JTOK_OBJECT or JTOK_ARRAY
+ * @return JTOK_PARSE_STATUS_t parse status
+ */
+JTOK_PARSE_STATUS_t jtok_push_frame(jtok_parser_t *parser, JTOK_TYPE_t type);
+
+
+/**
+ * @brief Close the aggregate on top of the nesting stack at the current
+ * parser position and pop its frame
+ *
+ * @param parser the json parser
+ * @return JTOK_PARSE_STATUS_t parse status
+ */
+JTOK_PARSE_STATUS_t jtok_pop_frame(jtok_parser_t *parser);
+
+
 #ifdef __cplusplus
 /* clang-format off */
 }
@@ -0,0 +1,82 @@
+#ifndef __JTOK_SWAR_H__
+#define __JTOK_SWAR_H__
+#ifdef __cplusplus
+/* clang-format off */
+extern "C"
+{
+/* clang-format on */
+#endif /* Start C linkage */
+
+#include <stdint.h>
+
+#include "jtok.h"
+
+/* Width in bits of the words the SWAR kernels test at a time. Defaults to
+ * the width of a pointer. Set to 0 to test one char at a time */
+#ifndef JTOK_SWAR_WIDTH
+#if UINTPTR_MAX > 0xFFFFFFFFu
+#define JTOK_SWAR_WIDTH 64
+#else
+#define JTOK_SWAR_WIDTH 32
+#endif /* #if UINTPTR_MAX > 0xFFFFFFFFu */
+#endif /* #ifndef JTOK_SWAR_WIDTH */
+
+
+/**
+ * @brief Find the next closing quote or backslash inside a string, one word
+ * at a time
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start looking at
+ * @param quote the quote char that opened the string
+ * @return jtok_pos_t index of the char, len if there is none
+ */
+jtok_pos_t jtok_swar_next_string_special(const char *json, jtok_pos_t len,
+                                         jtok_pos_t pos, char quote);
+
+
+/**
+ * @brief Skip a run of whitespace, one word at a time
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start at
+ * @return jtok_pos_t index of the first char that is not whitespace, len if
+ * there is none
+ */
+jtok_pos_t jtok_swar_skip_whitespace(const char *json, jtok_pos_t len,
+                                     jtok_pos_t pos);
+
+
+/**
+ * @brief Skip a run of decimal digits, one word at a time
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param pos index to start at
+ * @return jtok_pos_t index of the first char that is not a digit, len if
+ * there is none
+ */
+jtok_pos_t jtok_swar_skip_digits(const char *json, jtok_pos_t len,
+                                 jtok_pos_t pos);
+
+
+/**
+ * @brief Convert a run of decimal digits to its value, one word at a time
+ *
+ * @param digits the digits
+ * @param count number of digits, at most 19 so the value cannot overflow
+ * @param value the value of the digits
+ * @return true if converted, false if one of the chars is not a digit
+ */
+bool jtok_swar_digits_value(const char *digits, jtok_pos_t count,
+                            uint64_t *value);
+
+
+#ifdef __cplusplus
+/* clang-format off */
+}
+/* clang-format on */
+#endif /* End C linkage */
+#endif /* __JTOK_SWAR_H__ */
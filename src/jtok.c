@@ -13,7 +13,6 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <ctype.h>
 #include <string.h>
 
 #include "jtok.h"
@@ -22,10 +21,16 @@
 #include "jtok_primitive.h"
 #include "jtok_string.h"
 #include "jtok_shared.h"
+#include "jtok_index.h"
 
 
-static jtok_parser_t jtok_new_parser(const char *json_str, jtok_tkn_t *tokens,
-                                     unsigned int poolsize);
+static JTOK_PARSE_STATUS_t jtok_parse_nested(jtok_parser_t *parser);
+static JTOK_PARSE_STATUS_t jtok_parse_pool(const char *json, size_t len,
+                                           jtok_tkn_t *tkns, size_t size,
+                                           jtok_frame_t *frames,
+                                           size_t max_depth,
+                                           const char *const *paths,
+                                           size_t npaths, size_t *used);
 static bool          jtok_is_type_aggregate(const jtok_tkn_t *const tkn);
 
 
@@ -64,6 +69,9 @@ static const char *jtokerr_messages[] = {
     [JTOK_PARSE_STATUS_NON_ARRAY]        = "JTOK_PARSE_STATUS_NON_ARRAY",
     [JTOK_PARSE_STATUS_EMPTY_KEY]        = "JTOK_PARSE_STATUS_EMPTY_KEY",
     [JTOK_PARSE_STATUS_BAD_STRING]       = "JTOK_PARSE_STATUS_BAD_STRING",
+    [JTOK_PARSE_STATUS_NULL_PARAM]       = "JTOK_PARSE_STATUS_NULL_PARAM",
+    [JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED] =
+        "JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED",
 };
 
 
@@ -123,6 +131,8 @@ char *jtok_jtokerr_messages(JTOK_PARSE_STATUS_t err)
         case JTOK_PARSE_STATUS_NON_ARRAY:
         case JTOK_PARSE_STATUS_EMPTY_KEY:
         case JTOK_PARSE_STATUS_BAD_STRING:
+        case JTOK_PARSE_STATUS_NULL_PARAM:
+        case JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED:
         {
             retval = (char *)jtokerr_messages[err];
         }
@@ -138,17 +148,12 @@ char *jtok_jtokerr_messages(JTOK_PARSE_STATUS_t err)
 }
 
 
-uint_least16_t jtok_toklen(const jtok_tkn_t *tok)
+size_t jtok_toklen(const jtok_tkn_t *tok)
 {
-    uint_least16_t len = 0;
-    if (tok != NULL)
+    size_t len = 0;
+    if (tok != NULL && tok->end > tok->start)
     {
-        uint_least64_t tokstart = tok->start;
-        uint_least64_t tokend   = tok->end;
-        if (tokend - tokstart < UINT16_MAX)
-        {
-            len = tokend - tokstart;
-        }
+        len = (size_t)(tok->end - tok->start);
     }
     return len;
 }
@@ -171,68 +176,60 @@ bool jtok_tokcmp(const char *str, const jtok_tkn_t *tok)
             result = true;
         }
     }
-    else
+    else if (tok != NULL)
     {
-        uint_least16_t least_size = jtok_toklen(tok);
-        uint_least16_t slen       = strlen(str);
-        if (least_size < slen)
-        {
-            least_size = slen;
-        }
-
-        /* actually compare them */
-        if (strncmp((const char *)str, (char *)&tok->json[tok->start],
-                    least_size) == 0)
+        /* The json string may not be nul-terminated, so never compare past
+         * the end of the token */
+        size_t toklen = jtok_toklen(tok);
+        if (strlen(str) == toklen &&
+            0 == memcmp(str, &tok->json[tok->start], toklen))
         {
             result = true;
         }
-        else
-        {
-            result = false;
-        }
     }
     return result;
 }
 
 
-bool jtok_tokncmp(const char *str, const jtok_tkn_t *tok, uint_least16_t n)
+bool jtok_tokncmp(const char *str, const jtok_tkn_t *tok, size_t n)
 {
     bool result = false;
     if (str != NULL && tok != NULL && tok->json != NULL)
     {
-        uint_least16_t least_size = jtok_toklen(tok);
-        uint_least16_t slen       = strlen(str);
-        if (least_size < slen)
-        {
-            least_size = slen;
-        }
-
-        if (least_size < n)
+        /* strncmp semantics, but the token ends at its end index rather than
+         * at a nul terminator */
+        size_t toklen = jtok_toklen(tok);
+        size_t i;
+        result = true;
+        for (i = 0; i < n; i++)
         {
-            least_size = n;
-        }
+            char c = '\0';
+            if (i < toklen)
+            {
+                c = tok->json[tok->start + i];
+            }
 
-        /* actually compare them */
-        if (strncmp((const char *)str, (char *)&tok->json[tok->start],
-                    least_size) == 0)
-        {
-            result = true;
-        }
-        else
-        {
-            result = false;
+            if (str[i] != c)
+            {
+                result = false;
+                break;
+            }
+            else if (c == '\0')
+            {
+                break;
+            }
         }
     }
     return result;
 }
 
 
-char *jtok_tokcpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn)
+char *jtok_tokcpy(char *dst, size_t bufsize, const jtok_tkn_t *tkn)
 {
     char *result = NULL;
     if (dst != NULL && tkn != NULL && tkn->json != NULL)
     {
-        uint_least16_t copy_count = jtok_toklen(tkn);
+        size_t copy_count = jtok_toklen(tkn);
         if (copy_count > bufsize)
         {
             copy_count = bufsize;
@@ -243,11 +240,10 @@ char *jtok_tokcpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn)
 }
 
 
-char *jtok_tokncpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn,
-                   uint_least16_t n)
+char *jtok_tokncpy(char *dst, size_t bufsize, const jtok_tkn_t *tkn, size_t n)
 {
-    char *         result = NULL;
-    uint_least16_t count  = bufsize;
+    char * result = NULL;
+    size_t count  = bufsize;
     if (bufsize > n)
     {
         count = n;
@@ -259,13 +255,232 @@ char *jtok_tokncpy(char *dst, uint_least16_t bufsize, const jtok_tkn_t *tkn,
 
 JTOK_PARSE_STATUS_t jtok_parse(const char *json, jtok_tkn_t *tkns, size_t size)
 {
-    jtok_parser_t       parser;
+    jtok_frame_t frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    return jtok_parse_with_stack(json, tkns, size, frames,
+                                 sizeof(frames) / sizeof(*frames));
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parse_with_stack(const char *json, jtok_tkn_t *tkns,
+                                          size_t size, jtok_frame_t *frames,
+                                          size_t max_depth)
+{
     JTOK_PARSE_STATUS_t status;
     if (NULL == json)
     {
         status = JTOK_PARSE_STATUS_NULL_PARAM;
     }
-    else if (tkns == NULL)
+    else
+    {
+        status = jtok_parse_n_with_stack(json, strlen(json), tkns, size, frames,
+                                         max_depth);
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parse_n(const char *json, size_t len, jtok_tkn_t *tkns,
+                                 size_t size)
+{
+    jtok_frame_t frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    return jtok_parse_n_with_stack(json, len, tkns, size, frames,
+                                   sizeof(frames) / sizeof(*frames));
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parse_n_with_stack(const char *json, size_t len,
+                                            jtok_tkn_t *tkns, size_t size,
+                                            jtok_frame_t *frames,
+                                            size_t max_depth)
+{
+    size_t              used   = 0;
+    JTOK_PARSE_STATUS_t status = jtok_parse_pool(json, len, tkns, size, frames,
+                                                 max_depth, NULL, 0, &used);
+
+    /* Terminate the used tokens instead of sweeping the whole pool. Callers
+     * that walk the pool until an unassigned token still stop in the right
+     * place, and the cost no longer depends on the size of the pool */
+    if (tkns != NULL && used < size)
+    {
+        tkns[used].type = JTOK_UNASSIGNED_TOKEN;
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parse_n_used(const char *json, size_t len,
+                                      jtok_tkn_t *tkns, size_t size,
+                                      size_t *used)
+{
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    size_t              ntkns = 0;
+    JTOK_PARSE_STATUS_t status;
+    status = jtok_parse_pool(json, len, tkns, size, frames,
+                             sizeof(frames) / sizeof(*frames), NULL, 0,
+                             &ntkns);
+    if (used != NULL)
+    {
+        *used = ntkns;
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parse_paths(const char *json, size_t len,
+                                     jtok_tkn_t *tkns, size_t size,
+                                     const char *const *paths, size_t npaths,
+                                     size_t *used)
+{
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    size_t              ntkns  = 0;
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (paths == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (npaths > JTOK_MAX_PATHS)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        for (size_t p = 0; p < npaths; p++)
+        {
+            if (paths[p] == NULL)
+            {
+                status = JTOK_PARSE_STATUS_NULL_PARAM;
+            }
+            else if (paths[p][0] != '\0' && paths[p][0] != '/')
+            {
+                status = JTOK_PARSE_STATUS_INVAL;
+            }
+        }
+    }
+
+    if (status == JTOK_PARSE_STATUS_OK)
+    {
+        status = jtok_parse_pool(json, len, tkns, size, frames,
+                                 sizeof(frames) / sizeof(*frames), paths,
+                                 npaths, &ntkns);
+        if (tkns != NULL && ntkns < size)
+        {
+            tkns[ntkns].type = JTOK_UNASSIGNED_TOKEN;
+        }
+    }
+
+    if (used != NULL)
+    {
+        *used = ntkns;
+    }
+    return status;
+}
+
+
+void jtok_clear_tokens(jtok_tkn_t *tkns, size_t from, size_t size)
+{
+    if (tkns != NULL)
+    {
+        for (size_t x = from; x < size; x++)
+        {
+            tkns[x].type = JTOK_UNASSIGNED_TOKEN;
+        }
+    }
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parser_init(jtok_parser_t *parser, jtok_tkn_t *tkns,
+                                     size_t size, jtok_frame_t *frames,
+                                     size_t max_depth)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (parser == NULL || tkns == NULL || frames == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else
+    {
+        *parser = jtok_new_parser(NULL, 0, tkns, size, frames, max_depth);
+        if (size < 1)
+        {
+            status = JTOK_PARSE_STATUS_NOMEM;
+        }
+        parser->status = status;
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_parser_feed(jtok_parser_t *parser, const char *json,
+                                     size_t len)
+{
+    JTOK_PARSE_STATUS_t status;
+    if (parser == NULL || json == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (parser->status != JTOK_PARSE_STATUS_OK &&
+             parser->status != JTOK_PARSE_STATUS_PARTIAL_TOKEN)
+    {
+        status = parser->status;
+    }
+    else if (len > INT_MAX || (jtok_pos_t)len < parser->json_len)
+    {
+        /* Token boundaries are stored as int and chunks only ever grow the
+         * json string */
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        /* The buffer may have moved and the tail block was only partially
+         * classified, so the structural index is stale */
+        parser->json     = (char *)json;
+        parser->json_len = (jtok_pos_t)len;
+        jtok_index_reset(parser);
+        status = jtok_parse_nested(parser);
+    }
+
+    if (parser != NULL)
+    {
+        parser->status = status;
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_count_tokens(const char *json, size_t len,
+                                      size_t *count)
+{
+    jtok_parser_t       parser;
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    JTOK_PARSE_STATUS_t status;
+    if (json == NULL || count == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (len > JTOK_POS_MAX)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        /* Without a token pool the parser only counts the tokens it would
+         * have allocated */
+        parser = jtok_new_parser(json, len, NULL, JTOK_POS_MAX, frames,
+                                 sizeof(frames) / sizeof(*frames));
+        status = jtok_parse_nested(&parser);
+        *count = (size_t)parser.toknext;
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_doc_parse(jtok_doc_t *doc, const char *json,
+                                   size_t len, jtok_ctkn_t *tkns, size_t size)
+{
+    jtok_parser_t       parser;
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    JTOK_PARSE_STATUS_t status;
+    if (doc == NULL || json == NULL || tkns == NULL)
     {
         status = JTOK_PARSE_STATUS_NULL_PARAM;
     }
@@ -273,24 +488,115 @@ JTOK_PARSE_STATUS_t jtok_parse(const char *json, jtok_tkn_t *tkns, size_t size)
     {
         status = JTOK_PARSE_STATUS_NOMEM;
     }
+    else if (len > JTOK_OFF_MAX || len > JTOK_POS_MAX)
+    {
+        /* Token boundaries wouldn't fit the compact tokens */
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
     else
     {
-        parser = jtok_new_parser(json, tkns, size);
+        if (size > JTOK_CTKN_POOL_MAX)
+        {
+            /* Compact token links can't address the rest of the pool */
+            size = JTOK_CTKN_POOL_MAX;
+        }
+        parser = jtok_new_parser(json, len, NULL, size, frames,
+                                 sizeof(frames) / sizeof(*frames));
+        parser.output    = JTOK_OUTPUT_COMPACT;
+        parser.ctkn_pool = tkns;
+        status           = jtok_parse_nested(&parser);
+
+        doc->json  = json;
+        doc->len   = len;
+        doc->tkns  = tkns;
+        doc->size  = size;
+        doc->count = (size_t)parser.toknext;
+    }
+    return status;
+}
+
 
-        /* Skip leading whitespace */
-        while (isspace((int)json[parser.pos]))
+JTOK_PARSE_STATUS_t jtok_soa_parse(jtok_soa_t *soa, const char *json,
+                                   size_t len)
+{
+    jtok_parser_t       parser;
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    JTOK_PARSE_STATUS_t status;
+    if (soa == NULL || json == NULL || soa->type == NULL ||
+        soa->start == NULL || soa->end == NULL || soa->size == NULL ||
+        soa->parent == NULL || soa->sibling == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (soa->cap < 1)
+    {
+        status = JTOK_PARSE_STATUS_NOMEM;
+    }
+    else if (len > JTOK_OFF_MAX || len > JTOK_POS_MAX)
+    {
+        /* Token boundaries wouldn't fit the offset arrays */
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        size_t size = soa->cap;
+        if (size > JTOK_SOA_POOL_MAX)
         {
-            parser.pos++;
+            /* Links can't address the rest of the arrays */
+            size = JTOK_SOA_POOL_MAX;
         }
-        status = jtok_parse_object(&parser, 0);
+        parser = jtok_new_parser(json, len, NULL, size, frames,
+                                 sizeof(frames) / sizeof(*frames));
+        parser.output = JTOK_OUTPUT_SOA;
+        parser.soa    = soa;
+        status        = jtok_parse_nested(&parser);
+
+        soa->json  = json;
+        soa->len   = len;
+        soa->count = (size_t)parser.toknext;
     }
+    return status;
+}
 
-  // Populates remaining unused tokens with JTOK_UNASSIGNED_TOKEN
-  // - Alex
-  for (int x = parser.toknext; x < size; x++) {
-    tkns[x].type = JTOK_UNASSIGNED_TOKEN;
-  }
 
+JTOK_PARSE_STATUS_t jtok_tape_parse(jtok_tape_t *tape, const char *json,
+                                    size_t len)
+{
+    jtok_parser_t       parser;
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    JTOK_PARSE_STATUS_t status;
+    if (tape == NULL || json == NULL || tape->words == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (tape->cap < 4)
+    {
+        /* Not even room for an empty top-level object */
+        status = JTOK_PARSE_STATUS_NOMEM;
+    }
+    else if (len > JTOK_POS_MAX)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        /* Tape entries are addressed by parser positions */
+        size_t cap = tape->cap;
+        if (cap > (size_t)JTOK_POS_MAX)
+        {
+            tape->cap = (size_t)JTOK_POS_MAX;
+        }
+        tape->count = 0;
+        parser = jtok_new_parser(json, len, NULL, JTOK_POS_MAX, frames,
+                                 sizeof(frames) / sizeof(*frames));
+        parser.output = JTOK_OUTPUT_TAPE;
+        parser.tape   = tape;
+        status        = jtok_parse_nested(&parser);
+
+        tape->cap  = cap;
+        tape->json = json;
+        tape->len  = len;
+    }
     return status;
 }
 
@@ -341,9 +647,9 @@ int jtok_token_tostr(char *buf, unsigned int size, const char *json,
 bool jtok_toktokcmp(const jtok_tkn_t *tkn1, const jtok_tkn_t *tkn2)
 {
     bool is_equal = false;
-    if (tkn1->type == tkn2->type)
+    if (tkn1->type == tkn2->type && tokcmp_funcs[tkn1->type] != NULL)
     {
-        return tokcmp_funcs[tkn1->type];
+        is_equal = tokcmp_funcs[tkn1->type](tkn1, tkn2);
     }
     return is_equal;
 }
@@ -421,19 +727,93 @@ jtok_tkn_t *jtok_get_next_sibling(const jtok_tkn_t *child)
 }
 
 
-static jtok_parser_t jtok_new_parser(const char *json_str, jtok_tkn_t *tokens,
-                                     unsigned int poolsize)
+static JTOK_PARSE_STATUS_t jtok_parse_pool(const char *json, size_t len,
+                                           jtok_tkn_t *tkns, size_t size,
+                                           jtok_frame_t *frames,
+                                           size_t max_depth,
+                                           const char *const *paths,
+                                           size_t npaths, size_t *used)
+{
+    jtok_parser_t       parser;
+    JTOK_PARSE_STATUS_t status;
+    if (NULL == json)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (tkns == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (frames == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (size < 1)
+    {
+        status = JTOK_PARSE_STATUS_NOMEM;
+    }
+    else if (len > INT_MAX)
+    {
+        /* Token boundaries are stored as int */
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        if (size > INT_MAX)
+        {
+            /* Token links are stored as int */
+            size = INT_MAX;
+        }
+        parser        = jtok_new_parser(json, len, tkns, size, frames,
+                                        max_depth);
+        parser.paths  = paths;
+        parser.npaths = npaths;
+        status        = jtok_parse_nested(&parser);
+        *used         = (size_t)parser.toknext;
+    }
+    return status;
+}
+
+
+static JTOK_PARSE_STATUS_t jtok_parse_nested(jtok_parser_t *parser)
 {
-    jtok_parser_t parser;
-    parser.pos        = 0;
-    parser.toknext    = 0;
-    parser.toksuper   = JTOK_NO_PARENT_IDX;
-    parser.json       = (char *)json_str;
-    parser.json_len   = strlen(json_str);
-    parser.last_child = JTOK_NO_CHILD_IDX;
-    parser.tkn_pool   = tokens;
-    parser.pool_size  = poolsize;
-    return parser;
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (parser->toknext == 0)
+    {
+        /* Top-level object has not been opened yet. Skip leading whitespace
+         */
+        jtok_skip_whitespace(parser);
+        if (parser->pos >= parser->json_len)
+        {
+            /* Nothing but whitespace so far */
+            status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
+        else if (parser->json[parser->pos] != '{')
+        {
+            /* eg: "key" : 123 (literally missing the top-level object braces)
+             */
+            status = JTOK_PARSE_STATUS_NON_OBJECT;
+        }
+        else
+        {
+            status = jtok_push_frame(parser, JTOK_OBJECT);
+        }
+    }
+
+    /* Dispatch on the innermost open aggregate until the top-level object
+     * is closed. Each aggregate returns when it opens a child or closes */
+    while (status == JTOK_PARSE_STATUS_OK && parser->depth > 0)
+    {
+        if (parser->frames[parser->depth - 1].type == JTOK_OBJECT)
+        {
+            status = jtok_parse_object(parser);
+        }
+        else
+        {
+            status = jtok_parse_array(parser);
+        }
+    }
+    return status;
 }
 
 
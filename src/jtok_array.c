@@ -10,262 +10,141 @@
  */
 
 #include <assert.h>
+#include <stdint.h>
 
 #include "jtok_array.h"
 #include "jtok_object.h"
 #include "jtok_shared.h"
+#include "jtok_index.h"
 #include "jtok_string.h"
 #include "jtok_primitive.h"
-
-JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser, int depth)
+#include "jtok_number.h"
+
+static const jtok_tkn_t *jtok_array_elements(const jtok_tkn_t *arr,
+                                             const void *dst, size_t size);
+#if JTOK_FLOAT
+static bool jtok_array_shape(const jtok_tkn_t *arr, jtok_shape_t *shape);
+static bool jtok_array_to_tensor(const jtok_tkn_t *arr, void *dst,
+                                 size_t size, jtok_shape_t *shape,
+                                 bool single);
+#endif /* #if JTOK_FLOAT */
+
+JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser)
 {
-    JTOK_PARSE_STATUS_t status             = JTOK_PARSE_STATUS_OK;
-    jtok_tkn_t *        tokens             = parser->tkn_pool;
-    unsigned int        start              = parser->pos;
-    const char *        json               = parser->json;
-    bool                element_type_found = false;
-    JTOK_TYPE_t         element_type       = JTOK_UNASSIGNED_TOKEN;
-    enum
-    {
-        ARRAY_START,
-        ARRAY_VALUE,
-        ARRAY_COMMA
-    } expecting = ARRAY_START;
-
-    if (depth > JTOK_MAX_RECURSE_DEPTH)
-    {
-        status = JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED;
-        return status;
-    }
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    jtok_frame_t *      frame  = &parser->frames[parser->depth - 1];
+    const char *        json   = parser->json;
+    JTOK_TYPE_t         element_type;
 
-    if (json[parser->pos] != '[')
-    {
-        return JTOK_PARSE_STATUS_NON_ARRAY;
-    }
+    assert(frame->type == JTOK_ARRAY);
 
-    jtok_tkn_t *token = jtok_alloc_token(parser);
-    if (token == NULL)
+    while (status == JTOK_PARSE_STATUS_OK)
     {
-        /*
-         * Do not reset parser->pos because we want
-         * caller to see which token maxed out the
-         * pool
-         */
-        status = JTOK_PARSE_STATUS_NOMEM;
-        return status;
-    }
-
-    token->parent    = parser->toksuper;
-    parser->toksuper = parser->toknext - 1;
-
-    /* Index of current top level token is the current superior token */
-    /* We need to preserve the index of top level token in the currenet
-     * stack frame because parsing a sub-object changes the value of
-     * parser->toksuper
-     */
-    int array_token_index = parser->toksuper;
-
-    /* end of token will be populated when we find the closing brace */
-    jtok_fill_token(token, JTOK_ARRAY, parser->pos, JTOK_INVALID_ARRAY_INDEX);
-
-    /* go inside the object */
-    parser->pos++;
-
-    /* all arrays start with no children (since they can be empty) */
-    parser->last_child = JTOK_NO_CHILD_IDX;
+        /* Step over whitespace runs, a block at a time with the structural
+         * index */
+        jtok_skip_whitespace(parser);
+        if (parser->pos >= parser->json_len)
+        {
+            return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
 
-    for (; parser->pos < parser->json_len && json[parser->pos] != '\0' &&
-           status == JTOK_PARSE_STATUS_OK;
-         parser->pos++)
-    {
-        switch (json[parser->pos])
+        JTOK_CHAR_CLASS_t cls = JTOK_CHAR_CLASS(json[parser->pos]);
+        switch (cls)
         {
-            case '{':
+            case JTOK_CHAR_OBJ_OPEN:
+            case JTOK_CHAR_ARR_OPEN:
+            case JTOK_CHAR_QUOTE:
+            case JTOK_CHAR_SIGN:
+            case JTOK_CHAR_DIGIT:
+            case JTOK_CHAR_LITERAL:
             {
-                switch (expecting)
+                switch (cls)
                 {
-                    case ARRAY_START:
-                    case ARRAY_VALUE:
-                    {
-                        if (element_type_found)
-                        {
-                            if (element_type != JTOK_OBJECT)
-                            {
-                                status = JTOK_STATUS_MIXED_ARRAY;
-                            }
-                        }
-                        else
-                        {
-                            element_type_found = true;
-                            element_type       = JTOK_OBJECT;
-                        }
-
-                        int parent_array_idx = parser->toksuper;
-                        status = jtok_parse_object(parser, depth + 1);
-                        if (status == JTOK_PARSE_STATUS_OK)
-                        {
-                            if (parser->last_child != JTOK_NO_CHILD_IDX)
-                            {
-                                /* Link previous child to current child */
-                                tokens[parser->last_child].sibling =
-                                    parser->toknext - 1;
-                            }
-
-                            /* Update last child and increase parent size */
-                            parser->last_child = parser->toknext - 1;
-                            tokens[parent_array_idx].size++;
-
-                            expecting = ARRAY_COMMA;
-
-                            /* Restore superior token node */
-                            parser->toksuper = parent_array_idx;
-                        }
-                    }
-                    break;
-                    case ARRAY_COMMA:
+                    case JTOK_CHAR_OBJ_OPEN:
                     {
-                        status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
+                        element_type = JTOK_OBJECT;
                     }
                     break;
-                    default:
-                    {
-                        status = JTOK_PARSE_STATUS_INVAL;
-                    }
-                    break;
-                }
-            }
-            break;
-            case '[':
-            {
-                switch (expecting)
-                {
-                    case ARRAY_START:
-                    case ARRAY_VALUE:
+                    case JTOK_CHAR_ARR_OPEN:
                     {
-                        if (element_type_found)
-                        {
-                            if (element_type != JTOK_ARRAY)
-                            {
-                                status = JTOK_STATUS_MIXED_ARRAY;
-                            }
-                        }
-                        else
-                        {
-                            element_type_found = true;
-                            element_type       = JTOK_ARRAY;
-                        }
-
-                        int parent_array_idx = parser->toksuper;
-                        status = jtok_parse_array(parser, depth + 1);
-                        if (status == JTOK_PARSE_STATUS_OK)
-                        {
-                            if (parser->last_child != JTOK_NO_CHILD_IDX)
-                            {
-                                /* Link previous child to current child */
-                                tokens[parser->last_child].sibling =
-                                    parser->toknext - 1;
-                            }
-
-                            /* Update last child and increase parent size */
-                            parser->last_child = parser->toknext - 1;
-                            tokens[parent_array_idx].size++;
-
-                            expecting = ARRAY_COMMA;
-
-                            /* Restore superior token node */
-                            parser->toksuper = parent_array_idx;
-                        }
+                        element_type = JTOK_ARRAY;
                     }
                     break;
-                    case ARRAY_COMMA:
+                    case JTOK_CHAR_QUOTE:
                     {
-                        status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
+                        element_type = JTOK_STRING;
                     }
                     break;
                     default:
                     {
-                        status = JTOK_PARSE_STATUS_INVAL;
+                        element_type = JTOK_PRIMITIVE;
                     }
                     break;
                 }
-            }
-            break;
-            case ']':
-            {
-                switch (expecting)
+
+                switch (frame->expecting)
                 {
-                    case ARRAY_COMMA:
                     case ARRAY_START:
+                    case ARRAY_VALUE:
                     {
-                        jtok_tkn_t *parent_arr = &tokens[array_token_index];
-                        if (parent_arr->type != JTOK_ARRAY ||
-                            parser->toknext == 0)
+                        if (frame->element_type == JTOK_UNASSIGNED_TOKEN)
                         {
-                            parser->pos = start;
-                            status      = JTOK_PARSE_STATUS_INVAL;
+                            frame->element_type = element_type;
                         }
-                        else
+                        else if (frame->element_type != element_type)
                         {
-                            parent_arr->end  = parser->pos + 1;
-                            parser->toksuper = parent_arr->parent;
+                            /* eg : { "key" : [123, "123"]} */
+                            status = JTOK_STATUS_MIXED_ARRAY;
+                            break;
                         }
 
-                        return status;
-                    }
-                    break;
-                    default:
-                    {
-                        status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
-                    }
-                    break;
-                }
-                return status;
-            }
-            break;
-            case '\"':
-            {
-                switch (expecting)
-                {
-                    case ARRAY_START:
-                    case ARRAY_VALUE:
-                    {
-                        if (element_type_found)
+                        parser->toksuper = frame->tkn;
+                        if (element_type == JTOK_OBJECT ||
+                            element_type == JTOK_ARRAY)
                         {
-                            if (element_type != JTOK_OBJECT)
-                            {
-                                status = JTOK_STATUS_MIXED_ARRAY;
-                            }
+                            status = jtok_push_frame(parser, element_type);
+                        }
+                        else if (element_type == JTOK_STRING)
+                        {
+                            status = jtok_parse_string(parser);
                         }
                         else
                         {
-                            element_type_found = true;
-                            element_type       = JTOK_OBJECT;
+                            status = jtok_parse_primitive(parser);
                         }
 
-                        int super = parser->toksuper;
-                        status    = jtok_parse_string(parser);
                         if (status == JTOK_PARSE_STATUS_OK)
                         {
-                            if (parser->last_child != JTOK_NO_CHILD_IDX)
+                            jtok_pos_t element = parser->toklast;
+                            if (element != JTOK_SKIPPED_TOKEN_IDX)
                             {
-                                /* Link previous child to current child */
-                                tokens[parser->last_child].sibling =
-                                    parser->toknext - 1;
+                                if (frame->last_child != JTOK_NO_CHILD_IDX)
+                                {
+                                    /* Link previous child to current child */
+                                    jtok_token_link(parser, frame->last_child,
+                                                    element);
+                                }
+
+                                /* Update last child and parent size */
+                                frame->last_child = element;
+                                jtok_token_add_child(parser, frame->tkn);
                             }
+                            frame->expecting = ARRAY_COMMA;
 
-                            /* Update last child and increase parent size */
-                            parser->last_child = parser->toknext - 1;
-                            if (super != JTOK_NO_PARENT_IDX)
+                            if (element_type == JTOK_OBJECT ||
+                                element_type == JTOK_ARRAY)
                             {
-                                tokens[super].size++;
+                                /* The new frame takes over until it is closed
+                                 * and its opening char was already consumed
+                                 */
+                                return status;
                             }
-
-                            expecting = ARRAY_COMMA;
                         }
                     }
                     break;
                     case ARRAY_COMMA:
                     {
+                        /* eg { "key" : [123 123]} */
                         status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
                     }
                     break;
@@ -277,97 +156,36 @@ JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser, int depth)
                 }
             }
             break;
-            case '\t':
-            case '\r':
-            case '\n':
-            case ' ':
-                continue; /* skip whitespce */
-            case ',':
+            case JTOK_CHAR_ARR_CLOSE:
             {
-                switch (expecting)
+                switch (frame->expecting)
                 {
                     case ARRAY_COMMA:
-                    {
-                        expecting = ARRAY_VALUE;
-                    }
-                    break;
                     case ARRAY_START:
-                    case ARRAY_VALUE:
                     {
-                        status = JTOK_PARSE_STATUS_STRAY_COMMA;
+                        return jtok_pop_frame(parser);
                     }
                     break;
                     default:
                     {
-                        status = JTOK_PARSE_STATUS_INVAL;
+                        /* eg { "key" : [123, ]} */
+                        status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
                     }
                     break;
                 }
             }
             break;
-            case '+':
-            case '-':
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case 't':
-            case 'f':
-            case 'n':
+            case JTOK_CHAR_COMMA:
             {
-                switch (expecting)
+                switch (frame->expecting)
                 {
-                    case ARRAY_START:
-                    case ARRAY_VALUE:
+                    case ARRAY_COMMA:
                     {
-                        if (element_type_found)
-                        {
-                            if (element_type != JTOK_PRIMITIVE)
-                            {
-                                status = JTOK_STATUS_MIXED_ARRAY;
-                            }
-                        }
-                        else
-                        {
-                            element_type_found = true;
-                            element_type       = JTOK_PRIMITIVE;
-                        }
-
-                        if (status == JTOK_PARSE_STATUS_OK)
-                        {
-                            int super = parser->toksuper;
-                            status    = jtok_parse_primitive(parser);
-                            if (status == JTOK_PARSE_STATUS_OK)
-                            {
-                                if (parser->last_child != JTOK_NO_CHILD_IDX)
-                                {
-                                    /* Link previous child to current child
-                                     */
-                                    tokens[parser->last_child].sibling =
-                                        parser->toknext - 1;
-                                }
-
-                                /* Update last child and increase parent
-                                 * size */
-                                parser->last_child = parser->toknext - 1;
-                                if (super != JTOK_NO_PARENT_IDX)
-                                {
-                                    tokens[super].size++;
-                                }
-
-                                expecting = ARRAY_COMMA;
-                            }
-                            parser->toksuper = super;
-                        }
+                        frame->expecting = ARRAY_VALUE;
                     }
                     break;
-                    case ARRAY_COMMA:
+                    case ARRAY_START:
+                    case ARRAY_VALUE:
                     {
                         status = JTOK_PARSE_STATUS_STRAY_COMMA;
                     }
@@ -380,13 +198,17 @@ JTOK_PARSE_STATUS_t jtok_parse_array(jtok_parser_t *parser, int depth)
                 }
             }
             break;
+            default:
+            {
+                /* Arrays have always stepped over stray characters */
+            }
+            break;
         }
-    }
 
-    if (status == JTOK_PARSE_STATUS_OK)
-    {
-        parser->pos = start;
-        status      = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        if (status == JTOK_PARSE_STATUS_OK)
+        {
+            parser->pos++;
+        }
     }
 
     return status;
@@ -452,3 +274,235 @@ bool jtok_toktokcmp_array(const jtok_tkn_t *arr1, const jtok_tkn_t *arr2)
 
     return is_equal;
 }
+
+
+bool jtok_array_to_int32(const jtok_tkn_t *arr, int32_t *dst, size_t size,
+                         size_t *count)
+{
+    const jtok_tkn_t *elem = jtok_array_elements(arr, dst, size);
+    size_t            i    = 0;
+    if (elem != NULL)
+    {
+        for (; i < (size_t)arr->size; i++, elem++)
+        {
+            int64_t value;
+            if (elem->subtype != JTOK_SUBTYPE_INTEGER ||
+                !jtok_number_to_int64(&elem->json[elem->start],
+                                      elem->end - elem->start, &value) ||
+                value < INT32_MIN || value > INT32_MAX)
+            {
+                break;
+            }
+            dst[i] = (int32_t)value;
+        }
+    }
+
+    if (count != NULL)
+    {
+        *count = i;
+    }
+    return elem != NULL && i == (size_t)arr->size;
+}
+
+
+#if JTOK_FLOAT
+bool jtok_array_to_double(const jtok_tkn_t *arr, double *dst, size_t size,
+                          size_t *count)
+{
+    const jtok_tkn_t *elem = jtok_array_elements(arr, dst, size);
+    size_t            i    = 0;
+    if (elem != NULL)
+    {
+        for (; i < (size_t)arr->size; i++, elem++)
+        {
+            if (!jtok_tok_to_double(elem, &dst[i]))
+            {
+                break;
+            }
+        }
+    }
+
+    if (count != NULL)
+    {
+        *count = i;
+    }
+    return elem != NULL && i == (size_t)arr->size;
+}
+#endif /* #if JTOK_FLOAT */
+
+
+bool jtok_array_to_bool(const jtok_tkn_t *arr, bool *dst, size_t size,
+                        size_t *count)
+{
+    const jtok_tkn_t *elem = jtok_array_elements(arr, dst, size);
+    size_t            i    = 0;
+    if (elem != NULL)
+    {
+        for (; i < (size_t)arr->size; i++, elem++)
+        {
+            if (elem->subtype != JTOK_SUBTYPE_TRUE &&
+                elem->subtype != JTOK_SUBTYPE_FALSE)
+            {
+                break;
+            }
+            dst[i] = (elem->subtype == JTOK_SUBTYPE_TRUE);
+        }
+    }
+
+    if (count != NULL)
+    {
+        *count = i;
+    }
+    return elem != NULL && i == (size_t)arr->size;
+}
+
+
+#if JTOK_FLOAT
+bool jtok_array_to_tensor_double(const jtok_tkn_t *arr, double *dst,
+                                 size_t size, jtok_shape_t *shape)
+{
+    return jtok_array_to_tensor(arr, dst, size, shape, false);
+}
+
+
+bool jtok_array_to_tensor_float(const jtok_tkn_t *arr, float *dst,
+                                size_t size, jtok_shape_t *shape)
+{
+    return jtok_array_to_tensor(arr, dst, size, shape, true);
+}
+#endif /* #if JTOK_FLOAT */
+
+
+/**
+ * @brief Find the elements of an array to convert into a buffer
+ *
+ * @param arr the array token
+ * @param dst the buffer
+ * @param size number of elements the buffer holds
+ * @return const jtok_tkn_t* first element, NULL if arr is not an array or
+ * does not fit in the buffer
+ *
+ * @note Elements that are primitives have no child tokens, so all of them are
+ * the tokens right after the array. The subtype check of each element fails
+ * on the first aggregate or string, before its children could be mistaken
+ * for elements
+ */
+static const jtok_tkn_t *jtok_array_elements(const jtok_tkn_t *arr,
+                                             const void *dst, size_t size)
+{
+    const jtok_tkn_t *elem = NULL;
+    if (arr != NULL && dst != NULL && arr->type == JTOK_ARRAY &&
+        (size_t)arr->size <= size)
+    {
+        elem = &arr[1];
+    }
+    return elem;
+}
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Find the shape of nested arrays from the first array at each depth
+ *
+ * @param arr the outer array token
+ * @param shape the shape
+ * @return true if found, false if arr is not an array or the nesting is
+ * deeper than JTOK_TENSOR_MAX_RANK
+ */
+static bool jtok_array_shape(const jtok_tkn_t *arr, jtok_shape_t *shape)
+{
+    const jtok_tkn_t *tkn = arr;
+    shape->rank           = 0;
+    shape->count          = 1;
+    while (tkn->type == JTOK_ARRAY)
+    {
+        if (shape->rank == JTOK_TENSOR_MAX_RANK ||
+            (tkn->size > 0 && shape->count > SIZE_MAX / (size_t)tkn->size))
+        {
+            return false;
+        }
+        shape->shape[shape->rank++] = (size_t)tkn->size;
+        shape->count *= (size_t)tkn->size;
+        if (tkn->size == 0)
+        {
+            break;
+        }
+
+        /* The first child is the token right after its parent */
+        tkn++;
+    }
+    return shape->rank > 0;
+}
+
+
+/**
+ * @brief Check the tokens of nested arrays against their shape and convert
+ * the elements into a dense row-major buffer
+ *
+ * @param arr the outer array token
+ * @param dst buffer of doubles, or of floats if single is true
+ * @param size number of elements the buffer holds
+ * @param shape the shape
+ * @param single convert to floats
+ * @return true if all elements were converted
+ *
+ * @note The tokens of nested arrays are laid out depth first, so walking
+ * them in pool order while counting the children left at each depth visits
+ * the elements in row-major order
+ */
+static bool jtok_array_to_tensor(const jtok_tkn_t *arr, void *dst,
+                                 size_t size, jtok_shape_t *shape,
+                                 bool single)
+{
+    size_t            left[JTOK_TENSOR_MAX_RANK];
+    size_t            depth = 1;
+    size_t            out   = 0;
+    const jtok_tkn_t *tkn;
+
+    if (arr == NULL || dst == NULL || shape == NULL ||
+        !jtok_array_shape(arr, shape) || shape->count > size)
+    {
+        return false;
+    }
+
+    left[0] = shape->shape[0];
+    for (tkn = &arr[1]; depth > 0;)
+    {
+        if (left[depth - 1] == 0)
+        {
+            /* Last child of the array at this depth */
+            depth--;
+        }
+        else if (depth < shape->rank)
+        {
+            if (tkn->type != JTOK_ARRAY ||
+                (size_t)tkn->size != shape->shape[depth])
+            {
+                return false;
+            }
+            left[depth - 1]--;
+            left[depth++] = (size_t)tkn->size;
+            tkn++;
+        }
+        else
+        {
+            double value;
+            if (!jtok_tok_to_double(tkn, &value))
+            {
+                return false;
+            }
+            if (single)
+            {
+                ((float *)dst)[out++] = (float)value;
+            }
+            else
+            {
+                ((double *)dst)[out++] = value;
+            }
+            left[depth - 1]--;
+            tkn++;
+        }
+    }
+    return true;
+}
+#endif /* #if JTOK_FLOAT */
@@ -0,0 +1,453 @@
+/**
+ * @file jtok_batch.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to parse newline-delimited json (NDJSON) buffers on
+ * several threads with a work-stealing scheduler
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+typedef struct
+{
+    const char *         buf;        /* buffer of newline separated records */
+    size_t               len;        /* number of chars in the buffer */
+    size_t               chunk_size; /* nominal number of chars per chunk */
+    size_t               nchunks;    /* number of chunks */
+    jtok_batch_worker_t *workers;    /* the workers */
+    size_t               nworkers;   /* number of workers */
+    JTOK_BATCH_ORDER_t   order;      /* delivery order */
+    jtok_batch_cb_t      cb;         /* record callback */
+    void *               ctx;        /* caller context of the callback */
+    atomic_bool          stop;       /* a callback asked every worker to stop */
+    pthread_mutex_t      lock;       /* guards the fields below */
+    pthread_cond_t       cond;       /* signalled when started or turn change */
+    bool                 started;    /* chunks have been dealt out */
+    size_t               turn;       /* ordered: next chunk to deliver */
+    size_t               records;    /* ordered: records delivered so far */
+    const char *         err_at;     /* first malformed record */
+    JTOK_PARSE_STATUS_t  err;        /* status of the first malformed record */
+} jtok_batch_t;
+
+
+static void * jtok_batch_thread(void *arg);
+static void   jtok_batch_run(jtok_batch_worker_t *worker);
+static bool   jtok_batch_take(jtok_batch_worker_t *worker, size_t *chunk);
+static void   jtok_batch_chunk(jtok_batch_worker_t *worker, size_t chunk);
+static size_t jtok_batch_chunk_start(const jtok_batch_t *batch, size_t chunk);
+static bool   jtok_batch_next(jtok_ndjson_t *nd, jtok_tkn_t *tkns,
+                              size_t size, jtok_ndjson_rec_t *rec);
+static void   jtok_batch_flush(jtok_batch_worker_t *worker, size_t chunk,
+                               size_t held);
+static void   jtok_batch_deliver(jtok_batch_worker_t *worker,
+                                 jtok_ndjson_rec_t *rec, jtok_tkn_t *tkns);
+
+
+JTOK_PARSE_STATUS_t jtok_batch_parse(const char *buf, size_t len,
+                                     jtok_batch_worker_t *workers,
+                                     size_t nworkers, size_t chunk_size,
+                                     JTOK_BATCH_ORDER_t order,
+                                     jtok_batch_cb_t cb, void *ctx)
+{
+    jtok_batch_t batch;
+    size_t       running;
+    size_t       i;
+
+    if (buf == NULL || workers == NULL || cb == NULL)
+    {
+        return JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (nworkers == 0)
+    {
+        return JTOK_PARSE_STATUS_INVAL;
+    }
+
+    for (i = 0; i < nworkers; i++)
+    {
+        if (workers[i].tkns == NULL ||
+            (workers[i].recs == NULL && workers[i].nrecs > 0))
+        {
+            return JTOK_PARSE_STATUS_NULL_PARAM;
+        }
+    }
+
+    batch.buf        = buf;
+    batch.len        = len;
+    batch.chunk_size = (chunk_size == 0) ? JTOK_BATCH_CHUNK_SIZE : chunk_size;
+    batch.nchunks    = (len + batch.chunk_size - 1) / batch.chunk_size;
+    batch.workers    = workers;
+    batch.nworkers   = nworkers;
+    batch.order      = order;
+    batch.cb         = cb;
+    batch.ctx        = ctx;
+    batch.started    = false;
+    batch.turn       = 0;
+    batch.records    = 0;
+    batch.err_at     = NULL;
+    batch.err        = JTOK_PARSE_STATUS_OK;
+    atomic_init(&batch.stop, false);
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.cond, NULL);
+
+    for (i = 0; i < nworkers; i++)
+    {
+        workers[i].lo    = 0;
+        workers[i].hi    = 0;
+        workers[i].batch = &batch;
+        workers[i].id    = i;
+        pthread_mutex_init(&workers[i].lock, NULL);
+    }
+
+    /* Chunks are only dealt out to the workers that actually started, so
+     * every chunk has an owner that is running */
+    for (running = 1; running < nworkers; running++)
+    {
+        if (pthread_create(&workers[running].thread, NULL, jtok_batch_thread,
+                           &workers[running]) != 0)
+        {
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&batch.lock);
+    for (i = 0; i < running; i++)
+    {
+        workers[i].lo = i * batch.nchunks / running;
+        workers[i].hi = (i + 1) * batch.nchunks / running;
+    }
+    batch.started = true;
+    pthread_cond_broadcast(&batch.cond);
+    pthread_mutex_unlock(&batch.lock);
+
+    jtok_batch_run(&workers[0]);
+    for (i = 1; i < running; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < nworkers; i++)
+    {
+        pthread_mutex_destroy(&workers[i].lock);
+    }
+    pthread_cond_destroy(&batch.cond);
+    pthread_mutex_destroy(&batch.lock);
+    return batch.err;
+}
+
+
+/**
+ * @brief Entry point of the worker threads. Waits until the chunks are dealt
+ * out before running the worker
+ *
+ * @param arg the worker
+ * @return void* NULL
+ */
+static void *jtok_batch_thread(void *arg)
+{
+    jtok_batch_worker_t *worker = arg;
+    jtok_batch_t *       batch  = worker->batch;
+
+    pthread_mutex_lock(&batch->lock);
+    while (!batch->started)
+    {
+        pthread_cond_wait(&batch->cond, &batch->lock);
+    }
+    pthread_mutex_unlock(&batch->lock);
+
+    jtok_batch_run(worker);
+    return NULL;
+}
+
+
+/**
+ * @brief Parse chunks until there are none left to take or steal
+ *
+ * @param worker the worker
+ */
+static void jtok_batch_run(jtok_batch_worker_t *worker)
+{
+    jtok_batch_t *batch = worker->batch;
+    size_t        chunk;
+    while (!atomic_load(&batch->stop) && jtok_batch_take(worker, &chunk))
+    {
+        jtok_batch_chunk(worker, chunk);
+    }
+}
+
+
+/**
+ * @brief Take the next chunk of a worker's deque, or steal the upper half of
+ * another worker's deque if it is empty
+ *
+ * @param worker the worker
+ * @param chunk the chunk to parse
+ * @return true if a chunk was found
+ *
+ * @note The owner takes chunks from the bottom of its deque and thieves from
+ * the top, so the chunk a worker parses is always below the rest of its
+ * deque. Ordered delivery relies on this to never wait on a chunk that no
+ * running worker will parse.
+ */
+static bool jtok_batch_take(jtok_batch_worker_t *worker, size_t *chunk)
+{
+    jtok_batch_t *batch = worker->batch;
+    bool          found = false;
+    size_t        k;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->lo < worker->hi)
+    {
+        *chunk = worker->lo++;
+        found  = true;
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    for (k = 1; !found && k < batch->nworkers; k++)
+    {
+        jtok_batch_worker_t *victim =
+            &batch->workers[(worker->id + k) % batch->nworkers];
+        size_t first = 0;
+        size_t last  = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        if (victim->lo < victim->hi)
+        {
+            last       = victim->hi;
+            first      = last - (victim->hi - victim->lo + 1) / 2;
+            victim->hi = first;
+            found      = true;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (found)
+        {
+            pthread_mutex_lock(&worker->lock);
+            worker->lo = first + 1;
+            worker->hi = last;
+            pthread_mutex_unlock(&worker->lock);
+            *chunk = first;
+        }
+    }
+    return found;
+}
+
+
+/**
+ * @brief Parse the records of a chunk and deliver them
+ *
+ * @param worker the worker
+ * @param chunk the chunk
+ */
+static void jtok_batch_chunk(jtok_batch_worker_t *worker, size_t chunk)
+{
+    jtok_batch_t *    batch     = worker->batch;
+    size_t            start     = jtok_batch_chunk_start(batch, chunk);
+    size_t            end       = jtok_batch_chunk_start(batch, chunk + 1);
+    bool              have_turn = (batch->order != JTOK_BATCH_ORDERED);
+    size_t            held      = 0;
+    size_t            off       = 0;
+    jtok_ndjson_t     nd;
+    jtok_ndjson_rec_t rec;
+
+    jtok_ndjson_init(&nd, &batch->buf[start], end - start);
+    while (!atomic_load(&batch->stop))
+    {
+        jtok_ndjson_t resume = nd;
+        jtok_tkn_t *  tkns   = &worker->tkns[off];
+
+        if (!have_turn && held == worker->nrecs)
+        {
+            /* No room to hold another record until this chunk's turn */
+            jtok_batch_flush(worker, chunk, held);
+            have_turn = true;
+            held      = 0;
+            off       = 0;
+            continue;
+        }
+
+        if (!jtok_batch_next(&nd, tkns, worker->size - off, &rec))
+        {
+            break;
+        }
+
+        if (have_turn)
+        {
+            jtok_batch_deliver(worker, &rec, tkns);
+        }
+        else if (rec.status == JTOK_PARSE_STATUS_NOMEM && held > 0)
+        {
+            /* The held records filled the pool. Deliver them and parse this
+             * record again with the whole pool */
+            nd = resume;
+            jtok_batch_flush(worker, chunk, held);
+            have_turn = true;
+            held      = 0;
+            off       = 0;
+        }
+        else
+        {
+            /* Each held record keeps the sentinel after its tokens */
+            worker->recs[held++] = rec;
+            off += rec.used + 1;
+            if (off > worker->size)
+            {
+                off = worker->size;
+            }
+        }
+    }
+
+    if (batch->order == JTOK_BATCH_ORDERED)
+    {
+        if (!have_turn)
+        {
+            jtok_batch_flush(worker, chunk, held);
+        }
+
+        pthread_mutex_lock(&batch->lock);
+        batch->turn = chunk + 1;
+        pthread_cond_broadcast(&batch->cond);
+        pthread_mutex_unlock(&batch->lock);
+    }
+}
+
+
+/**
+ * @brief Find the first char of a chunk
+ *
+ * @param batch the batch
+ * @param chunk the chunk
+ * @return size_t index of the first record starting at or after the nominal
+ * start of the chunk
+ */
+static size_t jtok_batch_chunk_start(const jtok_batch_t *batch, size_t chunk)
+{
+    size_t start = chunk * batch->chunk_size;
+    if (chunk == 0)
+    {
+        start = 0;
+    }
+    else if (start >= batch->len)
+    {
+        start = batch->len;
+    }
+    else
+    {
+        const char *nl = memchr(&batch->buf[start - 1], '\n',
+                                batch->len - (start - 1));
+        start = (nl == NULL) ? batch->len : (size_t)(nl - batch->buf) + 1;
+    }
+    return start;
+}
+
+
+/**
+ * @brief Parse the next record of a chunk
+ *
+ * @param nd iterator over the chunk
+ * @param tkns token pool
+ * @param size number of tokens in the pool
+ * @param rec the record
+ * @return true if there was a record
+ *
+ * @note Unlike jtok_ndjson_next, a last line that ends mid-record is returned
+ * as malformed since the whole buffer is available
+ */
+static bool jtok_batch_next(jtok_ndjson_t *nd, jtok_tkn_t *tkns, size_t size,
+                            jtok_ndjson_rec_t *rec)
+{
+    bool found = jtok_ndjson_next(nd, tkns, size, rec);
+    if (!found && nd->pos < nd->len)
+    {
+        rec->json   = &nd->buf[nd->pos];
+        rec->len    = nd->len - nd->pos;
+        rec->index  = nd->records++;
+        rec->used   = 0;
+        rec->status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        nd->pos     = nd->len;
+        found       = true;
+    }
+    return found;
+}
+
+
+/**
+ * @brief Wait for the turn of a chunk and deliver the records held for it
+ *
+ * @param worker the worker
+ * @param chunk the chunk
+ * @param held number of records held
+ */
+static void jtok_batch_flush(jtok_batch_worker_t *worker, size_t chunk,
+                             size_t held)
+{
+    jtok_batch_t *batch = worker->batch;
+    size_t        off   = 0;
+    size_t        i;
+
+    pthread_mutex_lock(&batch->lock);
+    while (batch->turn != chunk && !atomic_load(&batch->stop))
+    {
+        pthread_cond_wait(&batch->cond, &batch->lock);
+    }
+    pthread_mutex_unlock(&batch->lock);
+
+    for (i = 0; i < held && !atomic_load(&batch->stop); i++)
+    {
+        jtok_batch_deliver(worker, &worker->recs[i], &worker->tkns[off]);
+        off += worker->recs[i].used + 1;
+        if (off > worker->size)
+        {
+            off = worker->size;
+        }
+    }
+}
+
+
+/**
+ * @brief Pass a record to the callback
+ *
+ * @param worker the worker that parsed the record
+ * @param rec the record
+ * @param tkns the tokens of the record
+ */
+static void jtok_batch_deliver(jtok_batch_worker_t *worker,
+                               jtok_ndjson_rec_t *rec, jtok_tkn_t *tkns)
+{
+    jtok_batch_t *batch = worker->batch;
+    if (batch->order == JTOK_BATCH_ORDERED)
+    {
+        /* Only the worker holding the turn delivers */
+        rec->index = batch->records++;
+    }
+
+    if (rec->status != JTOK_PARSE_STATUS_OK)
+    {
+        pthread_mutex_lock(&batch->lock);
+        if (batch->err_at == NULL || rec->json < batch->err_at)
+        {
+            batch->err_at = rec->json;
+            batch->err    = rec->status;
+        }
+        pthread_mutex_unlock(&batch->lock);
+    }
+
+    if (!batch->cb(rec, tkns, worker->id, batch->ctx))
+    {
+        pthread_mutex_lock(&batch->lock);
+        atomic_store(&batch->stop, true);
+        pthread_cond_broadcast(&batch->cond);
+        pthread_mutex_unlock(&batch->lock);
+    }
+}
+
+#endif /* #if JTOK_THREADS */
@@ -0,0 +1,558 @@
+/**
+ * @file jtok_cursor.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module for the on-demand cursor. Scalars are validated by
+ * the same routines as jtok_parse, aggregates are skipped by bracket matching
+ * over 64 char blocks classified by the scanning kernels.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <string.h>
+
+#include "jtok.h"
+#include "jtok_shared.h"
+#include "jtok_index.h"
+#include "jtok_swar.h"
+#include "jtok_string.h"
+#include "jtok_primitive.h"
+
+
+static JTOK_PARSE_STATUS_t jtok_cursor_at(jtok_cursor_t *cur, jtok_pos_t pos);
+static JTOK_PARSE_STATUS_t jtok_cursor_key_at(jtok_cursor_t *cur,
+                                              jtok_pos_t     pos);
+static JTOK_PARSE_STATUS_t jtok_cursor_after(const jtok_cursor_t *cur,
+                                             jtok_pos_t *         after);
+static JTOK_PARSE_STATUS_t jtok_cursor_match(const char *json, jtok_pos_t len,
+                                             jtok_pos_t  pos,
+                                             jtok_pos_t *after);
+static jtok_pos_t jtok_cursor_skip_ws(const jtok_cursor_t *cur, jtok_pos_t pos);
+static JTOK_PARSE_STATUS_t jtok_cursor_colon_error(char c);
+
+
+JTOK_PARSE_STATUS_t jtok_cursor_init(jtok_cursor_t *cur, const char *json,
+                                     size_t len)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (cur == NULL || json == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (len > JTOK_POS_MAX)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        cur->json   = json;
+        cur->len    = (jtok_pos_t)len;
+        cur->parent = JTOK_UNASSIGNED_TOKEN;
+        cur->key    = false;
+        cur->type   = JTOK_UNASSIGNED_TOKEN;
+        cur->pos    = jtok_cursor_skip_ws(cur, 0);
+        if (cur->pos >= cur->len)
+        {
+            status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
+        else if (json[cur->pos] != '{')
+        {
+            status = JTOK_PARSE_STATUS_NON_OBJECT;
+        }
+        else
+        {
+            status = jtok_cursor_at(cur, cur->pos);
+        }
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_cursor_first(const jtok_cursor_t *agg,
+                                      jtok_cursor_t *      child)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (agg == NULL || child == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (agg->type != JTOK_OBJECT && agg->type != JTOK_ARRAY)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        jtok_pos_t pos = jtok_cursor_skip_ws(agg, agg->pos + 1);
+        child->json    = agg->json;
+        child->len     = agg->len;
+        child->parent  = agg->type;
+        child->key     = false;
+        child->type    = JTOK_UNASSIGNED_TOKEN;
+        child->pos     = pos;
+        if (pos >= agg->len)
+        {
+            status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
+        else if (agg->json[pos] == (agg->type == JTOK_OBJECT ? '}' : ']'))
+        {
+            /* Empty aggregate */
+        }
+        else if (agg->type == JTOK_OBJECT)
+        {
+            status = jtok_cursor_key_at(child, pos);
+        }
+        else
+        {
+            status = jtok_cursor_at(child, pos);
+        }
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_cursor_next(jtok_cursor_t *cur)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    jtok_pos_t          after  = JTOK_INVALID_ARRAY_INDEX;
+    if (cur == NULL)
+    {
+        return JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (cur->type == JTOK_UNASSIGNED_TOKEN)
+    {
+        /* Already past the last child */
+        return JTOK_PARSE_STATUS_OK;
+    }
+    else if (cur->parent != JTOK_OBJECT && cur->parent != JTOK_ARRAY)
+    {
+        /* The top-level object has no siblings */
+        return JTOK_PARSE_STATUS_INVAL;
+    }
+
+    if (cur->key)
+    {
+        /* Step over the value of the key */
+        jtok_cursor_t value;
+        status = jtok_cursor_value(cur, &value);
+        if (status == JTOK_PARSE_STATUS_OK)
+        {
+            status = jtok_cursor_after(&value, &after);
+        }
+    }
+    else
+    {
+        status = jtok_cursor_after(cur, &after);
+    }
+
+    if (status == JTOK_PARSE_STATUS_OK)
+    {
+        jtok_pos_t pos   = jtok_cursor_skip_ws(cur, after);
+        char       close = (cur->parent == JTOK_OBJECT) ? '}' : ']';
+        cur->pos         = pos;
+        if (pos >= cur->len)
+        {
+            status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
+        else if (cur->json[pos] == close)
+        {
+            cur->type = JTOK_UNASSIGNED_TOKEN;
+            cur->key  = false;
+        }
+        else if (cur->json[pos] != ',')
+        {
+            /* eg { "key" : 123 "key2"...} or { "key" : [123 123]} */
+            status = (cur->parent == JTOK_OBJECT)
+                         ? JTOK_PARSE_STATUS_VAL_NO_COMMA
+                         : JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
+        }
+        else
+        {
+            pos = jtok_cursor_skip_ws(cur, pos + 1);
+            if (pos >= cur->len)
+            {
+                status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+            }
+            else if (cur->parent == JTOK_OBJECT)
+            {
+                if (cur->json[pos] == '}')
+                {
+                    /* eg : {\"key1\" : \"value1\", } */
+                    status = JTOK_PARSE_STATUS_COMMA_NO_KEY;
+                }
+                else
+                {
+                    status = jtok_cursor_key_at(cur, pos);
+                }
+            }
+            else if (cur->json[pos] == ']')
+            {
+                /* eg { "key" : [123, ]} */
+                status = JTOK_PARSE_STATUS_ARRAY_SEPARATOR;
+            }
+            else if (cur->json[pos] == ',')
+            {
+                /* eg: { "key" : [123,, 123]} */
+                status = JTOK_PARSE_STATUS_STRAY_COMMA;
+            }
+            else
+            {
+                status = jtok_cursor_at(cur, pos);
+            }
+        }
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_cursor_value(const jtok_cursor_t *key,
+                                      jtok_cursor_t *      value)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    if (key == NULL || value == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (!key->key || key->type != JTOK_STRING)
+    {
+        status = JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        /* Keys end at their closing quote */
+        jtok_pos_t pos = jtok_cursor_skip_ws(key, key->end + 1);
+        value->json    = key->json;
+        value->len     = key->len;
+        value->parent  = JTOK_OBJECT;
+        value->key     = false;
+        value->type    = JTOK_UNASSIGNED_TOKEN;
+        value->pos     = pos;
+        if (pos >= key->len)
+        {
+            status = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
+        else if (key->json[pos] != ':')
+        {
+            status = jtok_cursor_colon_error(key->json[pos]);
+        }
+        else
+        {
+            pos = jtok_cursor_skip_ws(key, pos + 1);
+            if (pos < key->len && key->json[pos] == '}')
+            {
+                /* key is missing value. ex: {"key" : } */
+                status = JTOK_PARSE_STATUS_KEY_NO_VAL;
+            }
+            else if (pos < key->len && key->json[pos] == ',')
+            {
+                status = JTOK_PARSE_STATUS_OBJ_NOKEY;
+            }
+            else
+            {
+                status = jtok_cursor_at(value, pos);
+            }
+        }
+    }
+    return status;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_cursor_find_key(const jtok_cursor_t *obj,
+                                         const char *         key_str,
+                                         jtok_cursor_t *      value)
+{
+    JTOK_PARSE_STATUS_t status;
+    jtok_cursor_t       key;
+    if (obj == NULL || key_str == NULL || value == NULL)
+    {
+        return JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else if (obj->type != JTOK_OBJECT)
+    {
+        return JTOK_PARSE_STATUS_INVAL;
+    }
+
+    status = jtok_cursor_first(obj, &key);
+    while (status == JTOK_PARSE_STATUS_OK && key.type != JTOK_UNASSIGNED_TOKEN)
+    {
+        if (jtok_cursor_tokcmp(key_str, &key))
+        {
+            return jtok_cursor_value(&key, value);
+        }
+        status = jtok_cursor_next(&key);
+    }
+
+    /* No such key */
+    *value      = key;
+    value->type = JTOK_UNASSIGNED_TOKEN;
+    return status;
+}
+
+
+size_t jtok_cursor_toklen(const jtok_cursor_t *cur)
+{
+    size_t len = 0;
+    if (cur != NULL)
+    {
+        jtok_pos_t end = cur->end;
+        if (cur->type == JTOK_OBJECT || cur->type == JTOK_ARRAY)
+        {
+            if (jtok_cursor_match(cur->json, cur->len, cur->pos, &end) !=
+                JTOK_PARSE_STATUS_OK)
+            {
+                end = JTOK_INVALID_ARRAY_INDEX;
+            }
+        }
+
+        if (cur->type != JTOK_UNASSIGNED_TOKEN && end > cur->start)
+        {
+            len = (size_t)(end - cur->start);
+        }
+    }
+    return len;
+}
+
+
+bool jtok_cursor_tokcmp(const char *str, const jtok_cursor_t *cur)
+{
+    bool result = false;
+    if (str != NULL && cur != NULL && cur->type != JTOK_UNASSIGNED_TOKEN)
+    {
+        /* The json string may not be nul-terminated, so never compare past
+         * the end of the value */
+        size_t toklen = jtok_cursor_toklen(cur);
+        if (strlen(str) == toklen &&
+            0 == memcmp(str, &cur->json[cur->start], toklen))
+        {
+            result = true;
+        }
+    }
+    return result;
+}
+
+
+/**
+ * @brief Position a cursor on the value starting at pos
+ *
+ * @param cur the cursor
+ * @param pos index of the first char of the value
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK if the value is valid
+ */
+static JTOK_PARSE_STATUS_t jtok_cursor_at(jtok_cursor_t *cur, jtok_pos_t pos)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    jtok_parser_t       parser;
+
+    /* Scalars are validated exactly like jtok_parse does, without a pool */
+    parser     = jtok_new_parser(cur->json, (size_t)cur->len, NULL, 1, NULL, 0);
+    parser.pos = pos;
+
+    cur->pos   = pos;
+    cur->start = pos;
+    cur->end   = JTOK_INVALID_ARRAY_INDEX;
+    cur->type  = JTOK_UNASSIGNED_TOKEN;
+    if (pos >= cur->len)
+    {
+        return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+    }
+
+    switch (JTOK_CHAR_CLASS(cur->json[pos]))
+    {
+        case JTOK_CHAR_OBJ_OPEN:
+        {
+            cur->type = JTOK_OBJECT;
+        }
+        break;
+        case JTOK_CHAR_ARR_OPEN:
+        {
+            cur->type = JTOK_ARRAY;
+        }
+        break;
+        case JTOK_CHAR_QUOTE:
+        {
+            status = jtok_parse_string(&parser);
+            if (status == JTOK_PARSE_STATUS_OK)
+            {
+                /* Strings end at their closing quote */
+                cur->type  = JTOK_STRING;
+                cur->start = pos + 1;
+                cur->end   = parser.pos;
+            }
+        }
+        break;
+        case JTOK_CHAR_SIGN:
+        case JTOK_CHAR_DIGIT:
+        case JTOK_CHAR_LITERAL:
+        {
+            status = jtok_parse_primitive(&parser);
+            if (status == JTOK_PARSE_STATUS_OK)
+            {
+                /* Primitives stop on their last char */
+                cur->type = JTOK_PRIMITIVE;
+                cur->end  = parser.pos + 1;
+            }
+        }
+        break;
+        default: /* unexpected character */
+        {
+            status = JTOK_PARSE_STATUS_INVAL;
+        }
+        break;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Position a cursor on the key starting at pos
+ *
+ * @param cur the cursor
+ * @param pos index of the opening quote of the key
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK if the key is valid
+ */
+static JTOK_PARSE_STATUS_t jtok_cursor_key_at(jtok_cursor_t *cur,
+                                              jtok_pos_t     pos)
+{
+    JTOK_PARSE_STATUS_t status;
+    switch (JTOK_CHAR_CLASS(cur->json[pos]))
+    {
+        case JTOK_CHAR_QUOTE:
+        {
+            status = jtok_cursor_at(cur, pos);
+            if (status == JTOK_PARSE_STATUS_OK && cur->end == cur->start)
+            {
+                /* eg {"" : "value"} */
+                status = JTOK_PARSE_STATUS_EMPTY_KEY;
+            }
+        }
+        break;
+        case JTOK_CHAR_OBJ_OPEN:
+        case JTOK_CHAR_ARR_OPEN:
+        case JTOK_CHAR_COMMA:
+        {
+            /* { {...}} jtok_string must be first token inside object */
+            status = JTOK_PARSE_STATUS_OBJ_NOKEY;
+        }
+        break;
+        default:
+        {
+            status = JTOK_PARSE_STATUS_INVAL;
+        }
+        break;
+    }
+
+    cur->key = (status == JTOK_PARSE_STATUS_OK);
+    if (status != JTOK_PARSE_STATUS_OK)
+    {
+        cur->type = JTOK_UNASSIGNED_TOKEN;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Find the index after the value under a cursor
+ *
+ * @param cur the cursor
+ * @param after index of the first char after the value
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_OK on success
+ */
+static JTOK_PARSE_STATUS_t jtok_cursor_after(const jtok_cursor_t *cur,
+                                             jtok_pos_t *         after)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    switch (cur->type)
+    {
+        case JTOK_OBJECT:
+        case JTOK_ARRAY:
+        {
+            status = jtok_cursor_match(cur->json, cur->len, cur->pos, after);
+        }
+        break;
+        case JTOK_STRING:
+        {
+            *after = cur->end + 1;
+        }
+        break;
+        default:
+        {
+            *after = cur->end;
+        }
+        break;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Find the bracket matching the one at pos
+ *
+ * @param json the json string
+ * @param len number of chars in the json string
+ * @param pos index of the opening bracket
+ * @param after index after the matching bracket
+ * @return JTOK_PARSE_STATUS_t JTOK_PARSE_STATUS_PARTIAL_TOKEN if the json
+ * string ends first
+ */
+static JTOK_PARSE_STATUS_t jtok_cursor_match(const char *json, jtok_pos_t len,
+                                             jtok_pos_t  pos,
+                                             jtok_pos_t *after)
+{
+    jtok_pos_t close = jtok_index_match(json, len, pos + 1, len);
+    if (close >= len)
+    {
+        return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+    }
+    *after = close + 1;
+    return JTOK_PARSE_STATUS_OK;
+}
+
+
+static jtok_pos_t jtok_cursor_skip_ws(const jtok_cursor_t *cur, jtok_pos_t pos)
+{
+    return jtok_swar_skip_whitespace(cur->json, cur->len, pos);
+}
+
+
+/**
+ * @brief Get the error jtok_parse reports for a char found instead of the
+ * colon after a key
+ *
+ * @param c the char found
+ * @return JTOK_PARSE_STATUS_t the parse error
+ */
+static JTOK_PARSE_STATUS_t jtok_cursor_colon_error(char c)
+{
+    JTOK_PARSE_STATUS_t status;
+    switch (JTOK_CHAR_CLASS(c))
+    {
+        case JTOK_CHAR_OBJ_OPEN:
+        case JTOK_CHAR_ARR_OPEN:
+        case JTOK_CHAR_QUOTE:
+        {
+            /* eg : { "key" "value "} */
+            status = JTOK_PARSE_STATUS_VAL_NO_COLON;
+        }
+        break;
+        case JTOK_CHAR_OBJ_CLOSE:
+        case JTOK_CHAR_SIGN:
+        case JTOK_CHAR_DIGIT:
+        case JTOK_CHAR_LITERAL:
+        {
+            status = JTOK_PARSE_STATUS_KEY_NO_VAL;
+        }
+        break;
+        case JTOK_CHAR_COMMA:
+        {
+            status = JTOK_PARSE_STATUS_OBJ_NOKEY;
+        }
+        break;
+        default:
+        {
+            status = JTOK_PARSE_STATUS_INVAL;
+        }
+        break;
+    }
+    return status;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file jtok_doc.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module for navigating documents of compact jtok tokens
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <string.h>
+
+#include "jtok.h"
+
+
+const jtok_ctkn_t *jtok_doc_root(const jtok_doc_t *doc)
+{
+    const jtok_ctkn_t *root = NULL;
+    if (doc != NULL && doc->count > 0)
+    {
+        root = &doc->tkns[0];
+    }
+    return root;
+}
+
+
+const jtok_ctkn_t *jtok_doc_child(const jtok_doc_t *doc, const jtok_ctkn_t *tkn)
+{
+    const jtok_ctkn_t *child = NULL;
+    if (doc != NULL && tkn != NULL && tkn->size > 0)
+    {
+        /* Tokens are allocated in document order so the first child
+         * is RIGHT AFTER its parent */
+        child = tkn + 1;
+    }
+    return child;
+}
+
+
+const jtok_ctkn_t *jtok_doc_sibling(const jtok_doc_t *doc,
+                                    const jtok_ctkn_t *tkn)
+{
+    const jtok_ctkn_t *sibling = NULL;
+    if (doc != NULL && tkn != NULL && tkn->sibling != JTOK_CTKN_NONE)
+    {
+        sibling = &doc->tkns[tkn->sibling];
+    }
+    return sibling;
+}
+
+
+const jtok_ctkn_t *jtok_doc_parent(const jtok_doc_t *doc,
+                                   const jtok_ctkn_t *tkn)
+{
+    const jtok_ctkn_t *parent = NULL;
+    if (doc != NULL && tkn != NULL && tkn->parent != JTOK_CTKN_NONE)
+    {
+        parent = &doc->tkns[tkn->parent];
+    }
+    return parent;
+}
+
+
+size_t jtok_doc_toklen(const jtok_doc_t *doc, const jtok_ctkn_t *tkn)
+{
+    size_t len = 0;
+    if (doc != NULL && tkn != NULL && tkn->end > tkn->start &&
+        tkn->end <= doc->len)
+    {
+        len = tkn->end - tkn->start;
+    }
+    return len;
+}
+
+
+const char *jtok_doc_tokstr(const jtok_doc_t *doc, const jtok_ctkn_t *tkn)
+{
+    const char *str = NULL;
+    if (doc != NULL && tkn != NULL)
+    {
+        str = &doc->json[tkn->start];
+    }
+    return str;
+}
+
+
+bool jtok_doc_tokcmp(const jtok_doc_t *doc, const char *str,
+                     const jtok_ctkn_t *tkn)
+{
+    bool result = false;
+    if (doc != NULL && str != NULL && tkn != NULL)
+    {
+        /* The json string may not be nul-terminated, so never compare past
+         * the end of the token */
+        size_t toklen = jtok_doc_toklen(doc, tkn);
+        if (strlen(str) == toklen &&
+            0 == memcmp(str, jtok_doc_tokstr(doc, tkn), toklen))
+        {
+            result = true;
+        }
+    }
+    return result;
+}
+
+
+const jtok_ctkn_t *jtok_doc_obj_has_key(const jtok_doc_t *doc,
+                                        const jtok_ctkn_t *obj,
+                                        const char *       key_str)
+{
+    const jtok_ctkn_t *key = NULL;
+    if (obj != NULL && obj->type == JTOK_OBJECT)
+    {
+        const jtok_ctkn_t *cur_key_tkn = jtok_doc_child(doc, obj);
+        while (cur_key_tkn != NULL)
+        {
+            if (jtok_doc_tokcmp(doc, key_str, cur_key_tkn))
+            {
+                key = cur_key_tkn;
+                break;
+            }
+            cur_key_tkn = jtok_doc_sibling(doc, cur_key_tkn);
+        }
+    }
+    return key;
+}
@@ -0,0 +1,326 @@
+/**
+ * @file jtok_index.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Stage-1 structural indexer. Classifies the json string 64 chars at
+ * a time into bitmaps so the cursor and the parallel splitter can match
+ * brackets and jump from one structural char to the next, whatever the
+ * build options. The object and array state machines only ever need the
+ * whitespace bitmap, and only classify it when built with
+ * JTOK_STRUCTURAL_INDEX.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "jtok_index.h"
+#include "jtok_kernel.h"
+#include "jtok_shared.h"
+#include "jtok_swar.h"
+
+static uint64_t jtok_index_escaped(uint64_t backslash, uint64_t *carry);
+static uint64_t jtok_prefix_xor(uint64_t mask);
+#if JTOK_STRUCTURAL_INDEX
+static void jtok_index_whitespace(const char *json, jtok_pos_t len,
+                                  jtok_pos_t base, jtok_block_t *blk);
+#endif /* #if JTOK_STRUCTURAL_INDEX */
+
+
+void jtok_index_block(const char *json, jtok_pos_t len, jtok_pos_t base,
+                      jtok_block_t *blk)
+{
+    blk->base = base;
+    if (len - base >= JTOK_BLOCK_SIZE)
+    {
+        jtok_kernel_ops->classify(&json[base], blk);
+    }
+    else
+    {
+        /* Don't read past the end of the caller's string. Tail chars are
+         * padded with nul which is classified as nothing */
+        char tail[JTOK_BLOCK_SIZE] = {0};
+        if (len > base)
+        {
+            memcpy(tail, &json[base], (size_t)(len - base));
+        }
+        jtok_kernel_ops->classify(tail, blk);
+    }
+}
+
+
+#if JTOK_STRUCTURAL_INDEX
+/**
+ * @brief Fill only the whitespace bitmap of the 64 byte block of the json
+ * string starting at base. The other bitmaps are left cleared
+ *
+ * @param json the json string
+ * @param len length of the json string
+ * @param base index of the first char of the block
+ * @param blk the block index to populate
+ */
+static void jtok_index_whitespace(const char *json, jtok_pos_t len,
+                                  jtok_pos_t base, jtok_block_t *blk)
+{
+    blk->base = base;
+    if (len - base >= JTOK_BLOCK_SIZE)
+    {
+        blk->whitespace = jtok_kernel_ops->whitespace(&json[base]);
+    }
+    else
+    {
+        /* Tail chars are padded with nul which is not whitespace */
+        char tail[JTOK_BLOCK_SIZE] = {0};
+        if (len > base)
+        {
+            memcpy(tail, &json[base], (size_t)(len - base));
+        }
+        blk->whitespace = jtok_kernel_ops->whitespace(tail);
+    }
+}
+#endif /* #if JTOK_STRUCTURAL_INDEX */
+
+
+void jtok_index_reset(jtok_parser_t *parser)
+{
+    parser->block.base       = JTOK_INVALID_ARRAY_INDEX;
+    parser->block.whitespace = 0;
+    parser->block.structural = 0;
+    parser->block.quote      = 0;
+    parser->block.backslash  = 0;
+}
+
+
+void jtok_skip_whitespace(jtok_parser_t *parser)
+{
+#if JTOK_STRUCTURAL_INDEX
+    /* Compact json has no whitespace between most tokens */
+    if (parser->pos < parser->json_len &&
+        JTOK_CHAR_CLASS(parser->json[parser->pos]) != JTOK_CHAR_WHITESPACE)
+    {
+        return;
+    }
+
+    while (parser->pos < parser->json_len)
+    {
+        jtok_pos_t offset = parser->pos - parser->block.base;
+        if (parser->block.base == JTOK_INVALID_ARRAY_INDEX || offset < 0 ||
+            offset >= JTOK_BLOCK_SIZE)
+        {
+            jtok_index_whitespace(parser->json, parser->json_len,
+                                  parser->pos & ~(JTOK_BLOCK_SIZE - 1),
+                                  &parser->block);
+            offset = parser->pos - parser->block.base;
+        }
+
+        uint64_t candidates = ~parser->block.whitespace & (~0ULL << offset);
+        if (candidates != 0)
+        {
+            parser->pos = parser->block.base + jtok_ctz64(candidates);
+            if (parser->pos > parser->json_len)
+            {
+                parser->pos = parser->json_len;
+            }
+            return;
+        }
+        parser->pos = parser->block.base + JTOK_BLOCK_SIZE;
+    }
+    parser->pos = parser->json_len;
+#else
+    parser->pos = jtok_swar_skip_whitespace(parser->json, parser->json_len,
+                                            parser->pos);
+#endif /* #if JTOK_STRUCTURAL_INDEX */
+}
+
+
+jtok_pos_t jtok_index_next_special(const char *json, jtok_pos_t len,
+                                   jtok_pos_t pos, jtok_block_t *blk)
+{
+    while (pos < len)
+    {
+        jtok_pos_t offset = pos - blk->base;
+        if (blk->base == JTOK_INVALID_ARRAY_INDEX || offset < 0 ||
+            offset >= JTOK_BLOCK_SIZE)
+        {
+            jtok_index_block(json, len, pos & ~(JTOK_BLOCK_SIZE - 1), blk);
+            offset = pos - blk->base;
+        }
+
+        /* Chars past len are classified as nothing */
+        uint64_t candidates = (blk->structural | blk->quote | blk->backslash) &
+                              (~0ULL << offset);
+        if (candidates != 0)
+        {
+            return blk->base + jtok_ctz64(candidates);
+        }
+        pos = blk->base + JTOK_BLOCK_SIZE;
+    }
+    return len;
+}
+
+
+jtok_pos_t jtok_index_next_string_special(const char *json, jtok_pos_t len,
+                                          jtok_pos_t pos, char quote)
+{
+    return jtok_kernel_ops->next_string_special(json, len, pos, quote);
+}
+
+
+void jtok_index_brackets(const char *json, jtok_pos_t len, jtok_pos_t base,
+                         jtok_bracket_block_t *blk)
+{
+    if (len - base >= JTOK_BLOCK_SIZE)
+    {
+        jtok_kernel_ops->brackets(&json[base], blk);
+    }
+    else
+    {
+        /* Tail chars are padded with nul which is classified as nothing */
+        char tail[JTOK_BLOCK_SIZE] = {0};
+        if (len > base)
+        {
+            memcpy(tail, &json[base], (size_t)(len - base));
+        }
+        jtok_kernel_ops->brackets(tail, blk);
+    }
+}
+
+
+jtok_pos_t jtok_index_match(const char *json, jtok_pos_t len, jtok_pos_t pos,
+                            jtok_pos_t comma)
+{
+    jtok_bracket_block_t blk;
+    jtok_pos_t           depth = 0;    /* aggregates opened since pos */
+    char                 quote = '\0'; /* quote of the open string */
+    uint64_t             carry = 0;    /* first char of the block escaped */
+
+    for (; pos < len; pos += JTOK_BLOCK_SIZE)
+    {
+        uint64_t   escaped;
+        uint64_t   inside;
+        uint64_t   opens;
+        uint64_t   closes;
+        uint64_t   commas = 0;
+        jtok_pos_t ncloses;
+
+        jtok_index_brackets(json, len, pos, &blk);
+        escaped = jtok_index_escaped(blk.backslash, &carry);
+        if (comma < pos + JTOK_BLOCK_SIZE)
+        {
+            commas = blk.comma & ((comma > pos) ? ~0ULL << (comma - pos)
+                                                : ~0ULL);
+        }
+
+        /* Between a double quote and the next, the last quote included */
+        inside = jtok_prefix_xor(blk.quote & ~escaped);
+        inside ^= (quote == '\"') ? ~0ULL : 0;
+        if (quote != '\'' && (blk.squote & ~escaped & ~inside) == 0)
+        {
+            opens   = blk.open & ~inside;
+            closes  = blk.close & ~inside;
+            commas &= ~inside;
+            quote   = (inside >> 63) ? '\"' : '\0';
+            ncloses = (jtok_pos_t)jtok_popcount64(closes);
+            if (depth > ncloses || (depth == ncloses && commas == 0))
+            {
+                /* Never back at depth 0 with a comma, never below it */
+                depth += (jtok_pos_t)jtok_popcount64(opens) - ncloses;
+                continue;
+            }
+            for (uint64_t hits = opens | closes | commas; hits != 0;
+                 hits &= hits - 1)
+            {
+                uint64_t bit = hits & (~hits + 1);
+                if (opens & bit)
+                {
+                    depth++;
+                }
+                else if (depth == 0)
+                {
+                    return pos + (jtok_pos_t)jtok_ctz64(hits);
+                }
+                else if (closes & bit)
+                {
+                    depth--;
+                }
+            }
+            continue;
+        }
+
+        for (uint64_t hits = (blk.open | blk.close | blk.quote | blk.squote |
+                              commas) &
+                             ~escaped;
+             hits != 0; hits &= hits - 1)
+        {
+            jtok_pos_t at = pos + (jtok_pos_t)jtok_ctz64(hits);
+            char       c  = json[at];
+            if (quote != '\0')
+            {
+                quote = (c == quote) ? '\0' : quote;
+            }
+            else if (JTOK_CHAR_CLASS(c) == JTOK_CHAR_QUOTE)
+            {
+                quote = c;
+            }
+            else if (c == '{' || c == '[')
+            {
+                depth++;
+            }
+            else if (depth == 0)
+            {
+                return at;
+            }
+            else if (c != ',')
+            {
+                depth--;
+            }
+        }
+    }
+    return len;
+}
+
+
+/**
+ * @brief Find the chars of a block escaped by a backslash
+ *
+ * @param backslash the backslashes of the block
+ * @param carry 1 if the first char of the block is escaped. Set for the next
+ * block
+ * @return uint64_t the escaped chars
+ */
+static uint64_t jtok_index_escaped(uint64_t backslash, uint64_t *carry)
+{
+    uint64_t escaped = *carry;
+    *carry           = 0;
+    for (; backslash != 0; backslash &= backslash - 1)
+    {
+        uint64_t bit = backslash & (~backslash + 1);
+        if ((bit & escaped) == 0)
+        {
+            if (bit == (1ULL << 63))
+            {
+                *carry = 1;
+            }
+            escaped |= bit << 1;
+        }
+    }
+    return escaped;
+}
+
+
+/**
+ * @brief Set each bit of a mask to the parity of the bits up to it
+ */
+static uint64_t jtok_prefix_xor(uint64_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
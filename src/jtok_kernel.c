@@ -0,0 +1,569 @@
+/**
+ * @file jtok_kernel.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module of the scanning kernels and of the dispatch that
+ * picks one at run time. On x86 the SSE2 and AVX2 kernels are built whatever
+ * the compiler targets and selected once the CPU has been probed.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "jtok_kernel.h"
+#include "jtok_index.h"
+#include "jtok_shared.h"
+#include "jtok_swar.h"
+
+/* x86 vector kernels are built with target attributes and only run once
+ * jtok_init found them supported by the CPU */
+#if JTOK_SIMD && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JTOK_KERNEL_DISPATCH 1
+#define JTOK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define JTOK_KERNEL_DISPATCH 0
+#define JTOK_TARGET(isa)
+#endif /* #if JTOK_SIMD && defined(__GNUC__) && ... */
+
+#if JTOK_KERNEL_DISPATCH || (JTOK_SIMD && defined(__SSE2__))
+#define JTOK_HAVE_SSE2 1
+#else
+#define JTOK_HAVE_SSE2 0
+#endif
+
+#if JTOK_KERNEL_DISPATCH || (JTOK_SIMD && defined(__AVX2__))
+#define JTOK_HAVE_AVX2 1
+#else
+#define JTOK_HAVE_AVX2 0
+#endif
+
+#if JTOK_HAVE_SSE2 || JTOK_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+
+static void       jtok_scalar_classify(const char *blk, jtok_block_t *idx);
+static uint64_t   jtok_scalar_whitespace(const char *blk);
+static jtok_pos_t jtok_scalar_next_string_special(const char *json,
+                                                  jtok_pos_t len,
+                                                  jtok_pos_t pos, char quote);
+static void jtok_scalar_brackets(const char *blk, jtok_bracket_block_t *idx);
+static bool       jtok_kernel_supported(JTOK_KERNEL_t kernel);
+
+#if JTOK_HAVE_SSE2
+static void       jtok_sse2_classify(const char *blk, jtok_block_t *idx);
+static uint64_t   jtok_sse2_whitespace(const char *blk);
+static jtok_pos_t jtok_sse2_next_string_special(const char *json,
+                                                jtok_pos_t len, jtok_pos_t pos,
+                                                char quote);
+static void jtok_sse2_brackets(const char *blk, jtok_bracket_block_t *idx);
+#endif /* #if JTOK_HAVE_SSE2 */
+
+#if JTOK_HAVE_AVX2
+static void       jtok_avx2_classify(const char *blk, jtok_block_t *idx);
+static uint64_t   jtok_avx2_whitespace(const char *blk);
+static jtok_pos_t jtok_avx2_next_string_special(const char *json,
+                                                jtok_pos_t len, jtok_pos_t pos,
+                                                char quote);
+static void jtok_avx2_brackets(const char *blk, jtok_bracket_block_t *idx);
+#endif /* #if JTOK_HAVE_AVX2 */
+
+
+#define JTOK_KERNEL_COUNT (JTOK_KERNEL_AVX2 + 1)
+
+/* Kernels missing from the build have no functions */
+static const jtok_kernel_ops_t jtok_kernels[JTOK_KERNEL_COUNT] = {
+    [JTOK_KERNEL_SCALAR] = {jtok_scalar_classify, jtok_scalar_whitespace,
+                            jtok_scalar_next_string_special,
+                            jtok_scalar_brackets},
+#if JTOK_SWAR_WIDTH
+    [JTOK_KERNEL_SWAR] = {jtok_scalar_classify, jtok_scalar_whitespace,
+                          jtok_swar_next_string_special, jtok_scalar_brackets},
+#endif /* #if JTOK_SWAR_WIDTH */
+#if JTOK_HAVE_SSE2
+    [JTOK_KERNEL_SSE2] = {jtok_sse2_classify, jtok_sse2_whitespace,
+                          jtok_sse2_next_string_special, jtok_sse2_brackets},
+#endif /* #if JTOK_HAVE_SSE2 */
+#if JTOK_HAVE_AVX2
+    [JTOK_KERNEL_AVX2] = {jtok_avx2_classify, jtok_avx2_whitespace,
+                          jtok_avx2_next_string_special, jtok_avx2_brackets},
+#endif /* #if JTOK_HAVE_AVX2 */
+};
+
+/* Before jtok_init, the fastest kernel every CPU the compiler targets has */
+#if JTOK_SIMD && defined(__AVX2__)
+#define JTOK_KERNEL_DEFAULT JTOK_KERNEL_AVX2
+#elif JTOK_SIMD && defined(__SSE2__)
+#define JTOK_KERNEL_DEFAULT JTOK_KERNEL_SSE2
+#elif JTOK_SWAR_WIDTH
+#define JTOK_KERNEL_DEFAULT JTOK_KERNEL_SWAR
+#else
+#define JTOK_KERNEL_DEFAULT JTOK_KERNEL_SCALAR
+#endif /* #if JTOK_SIMD && defined(__AVX2__) */
+
+const jtok_kernel_ops_t *jtok_kernel_ops = &jtok_kernels[JTOK_KERNEL_DEFAULT];
+static JTOK_KERNEL_t     jtok_kernel     = JTOK_KERNEL_DEFAULT;
+
+
+JTOK_KERNEL_t jtok_init(void)
+{
+    int kernel;
+    for (kernel = JTOK_KERNEL_COUNT - 1; kernel > JTOK_KERNEL_SCALAR; kernel--)
+    {
+        if (jtok_set_kernel((JTOK_KERNEL_t)kernel))
+        {
+            return (JTOK_KERNEL_t)kernel;
+        }
+    }
+    jtok_set_kernel(JTOK_KERNEL_SCALAR);
+    return JTOK_KERNEL_SCALAR;
+}
+
+
+bool jtok_set_kernel(JTOK_KERNEL_t kernel)
+{
+    if (!jtok_kernel_supported(kernel))
+    {
+        return false;
+    }
+    jtok_kernel_ops = &jtok_kernels[kernel];
+    jtok_kernel     = kernel;
+    return true;
+}
+
+
+JTOK_KERNEL_t jtok_get_kernel(void)
+{
+    return jtok_kernel;
+}
+
+
+const char *jtok_kernel_name(JTOK_KERNEL_t kernel)
+{
+    switch (kernel)
+    {
+        case JTOK_KERNEL_SCALAR:
+        {
+            return "scalar";
+        }
+        break;
+        case JTOK_KERNEL_SWAR:
+        {
+            return "swar";
+        }
+        break;
+        case JTOK_KERNEL_SSE2:
+        {
+            return "sse2";
+        }
+        break;
+        case JTOK_KERNEL_AVX2:
+        {
+            return "avx2";
+        }
+        break;
+        default:
+        {
+            return "unknown";
+        }
+        break;
+    }
+}
+
+
+unsigned int jtok_ctz64(uint64_t mask)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctzll(mask);
+#else
+    unsigned int n = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+#endif /* #if defined(__GNUC__) */
+}
+
+
+unsigned int jtok_popcount64(uint64_t mask)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_popcountll(mask);
+#else
+    unsigned int n = 0;
+    for (; mask != 0; mask &= mask - 1)
+    {
+        n++;
+    }
+    return n;
+#endif /* #if defined(__GNUC__) */
+}
+
+
+/**
+ * @brief Check that a kernel is built and that the CPU can run it
+ */
+static bool jtok_kernel_supported(JTOK_KERNEL_t kernel)
+{
+    if ((unsigned int)kernel >= JTOK_KERNEL_COUNT ||
+        jtok_kernels[kernel].classify == NULL)
+    {
+        return false;
+    }
+
+#if JTOK_KERNEL_DISPATCH
+    __builtin_cpu_init();
+    switch (kernel)
+    {
+        case JTOK_KERNEL_SSE2:
+        {
+            return __builtin_cpu_supports("sse2");
+        }
+        break;
+        case JTOK_KERNEL_AVX2:
+        {
+            /* Also false if the OS does not save the AVX registers */
+            return __builtin_cpu_supports("avx2");
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+#endif /* #if JTOK_KERNEL_DISPATCH */
+    return true;
+}
+
+
+static void jtok_scalar_classify(const char *blk, jtok_block_t *idx)
+{
+    int i;
+    idx->whitespace = 0;
+    idx->structural = 0;
+    idx->quote      = 0;
+    idx->backslash  = 0;
+    for (i = 0; i < JTOK_BLOCK_SIZE; i++)
+    {
+        uint64_t bit = 1ULL << i;
+        switch (JTOK_CHAR_CLASS(blk[i]))
+        {
+            case JTOK_CHAR_WHITESPACE:
+            {
+                idx->whitespace |= bit;
+            }
+            break;
+            case JTOK_CHAR_OBJ_OPEN:
+            case JTOK_CHAR_OBJ_CLOSE:
+            case JTOK_CHAR_ARR_OPEN:
+            case JTOK_CHAR_ARR_CLOSE:
+            case JTOK_CHAR_COLON:
+            case JTOK_CHAR_COMMA:
+            {
+                idx->structural |= bit;
+            }
+            break;
+            case JTOK_CHAR_QUOTE:
+            {
+                idx->quote |= bit;
+            }
+            break;
+            case JTOK_CHAR_BACKSLASH:
+            {
+                idx->backslash |= bit;
+            }
+            break;
+            default:
+            {
+            }
+            break;
+        }
+    }
+}
+
+
+static uint64_t jtok_scalar_whitespace(const char *blk)
+{
+    uint64_t mask = 0;
+    int      i;
+    for (i = 0; i < JTOK_BLOCK_SIZE; i++)
+    {
+        if (JTOK_CHAR_CLASS(blk[i]) == JTOK_CHAR_WHITESPACE)
+        {
+            mask |= 1ULL << i;
+        }
+    }
+    return mask;
+}
+
+
+static jtok_pos_t jtok_scalar_next_string_special(const char *json,
+                                                  jtok_pos_t len,
+                                                  jtok_pos_t pos, char quote)
+{
+    for (; pos < len; pos++)
+    {
+        if (json[pos] == quote || json[pos] == '\\')
+        {
+            return pos;
+        }
+    }
+    return len;
+}
+
+
+static void jtok_scalar_brackets(const char *blk, jtok_bracket_block_t *idx)
+{
+    int i;
+    idx->open      = 0;
+    idx->close     = 0;
+    idx->comma     = 0;
+    idx->quote     = 0;
+    idx->squote    = 0;
+    idx->backslash = 0;
+    for (i = 0; i < JTOK_BLOCK_SIZE; i++)
+    {
+        uint64_t bit = 1ULL << i;
+        switch (JTOK_CHAR_CLASS(blk[i]))
+        {
+            case JTOK_CHAR_OBJ_OPEN:
+            case JTOK_CHAR_ARR_OPEN:
+            {
+                idx->open |= bit;
+            }
+            break;
+            case JTOK_CHAR_OBJ_CLOSE:
+            case JTOK_CHAR_ARR_CLOSE:
+            {
+                idx->close |= bit;
+            }
+            break;
+            case JTOK_CHAR_COMMA:
+            {
+                idx->comma |= bit;
+            }
+            break;
+            case JTOK_CHAR_QUOTE:
+            {
+                if (blk[i] == '\"')
+                {
+                    idx->quote |= bit;
+                }
+                else
+                {
+                    idx->squote |= bit;
+                }
+            }
+            break;
+            case JTOK_CHAR_BACKSLASH:
+            {
+                idx->backslash |= bit;
+            }
+            break;
+            default:
+            {
+            }
+            break;
+        }
+    }
+}
+
+
+#if JTOK_HAVE_SSE2
+
+JTOK_TARGET("sse2")
+static uint64_t jtok_sse2_eq_mask(const __m128i v[4], char c)
+{
+    __m128i  needle = _mm_set1_epi8(c);
+    uint64_t mask   = 0;
+    int      i;
+    for (i = 0; i < 4; i++)
+    {
+        uint64_t m = (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[i], needle));
+        mask |= m << (16 * i);
+    }
+    return mask;
+}
+
+
+JTOK_TARGET("sse2")
+static void jtok_sse2_classify(const char *blk, jtok_block_t *idx)
+{
+    __m128i v[4];
+    int     i;
+    for (i = 0; i < 4; i++)
+    {
+        v[i] = _mm_loadu_si128((const __m128i *)&blk[16 * i]);
+    }
+
+    idx->whitespace = jtok_sse2_eq_mask(v, ' ') | jtok_sse2_eq_mask(v, '\t') |
+                      jtok_sse2_eq_mask(v, '\r') | jtok_sse2_eq_mask(v, '\n');
+    idx->structural = jtok_sse2_eq_mask(v, '{') | jtok_sse2_eq_mask(v, '}') |
+                      jtok_sse2_eq_mask(v, '[') | jtok_sse2_eq_mask(v, ']') |
+                      jtok_sse2_eq_mask(v, ':') | jtok_sse2_eq_mask(v, ',');
+    idx->quote     = jtok_sse2_eq_mask(v, '\"') | jtok_sse2_eq_mask(v, '\'');
+    idx->backslash = jtok_sse2_eq_mask(v, '\\');
+}
+
+
+JTOK_TARGET("sse2")
+static uint64_t jtok_sse2_whitespace(const char *blk)
+{
+    __m128i v[4];
+    int     i;
+    for (i = 0; i < 4; i++)
+    {
+        v[i] = _mm_loadu_si128((const __m128i *)&blk[16 * i]);
+    }
+    return jtok_sse2_eq_mask(v, ' ') | jtok_sse2_eq_mask(v, '\t') |
+           jtok_sse2_eq_mask(v, '\r') | jtok_sse2_eq_mask(v, '\n');
+}
+
+
+JTOK_TARGET("sse2")
+static jtok_pos_t jtok_sse2_next_string_special(const char *json,
+                                                jtok_pos_t len, jtok_pos_t pos,
+                                                char quote)
+{
+    const __m128i q_needle = _mm_set1_epi8(quote);
+    const __m128i b_needle = _mm_set1_epi8('\\');
+    while (len - pos >= 16)
+    {
+        __m128i  v    = _mm_loadu_si128((const __m128i *)&json[pos]);
+        __m128i  hits = _mm_or_si128(_mm_cmpeq_epi8(v, q_needle),
+                                    _mm_cmpeq_epi8(v, b_needle));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask != 0)
+        {
+            return pos + jtok_ctz64(mask);
+        }
+        pos += 16;
+    }
+
+    /* Tail shorter than a vector */
+    return jtok_swar_next_string_special(json, len, pos, quote);
+}
+
+
+JTOK_TARGET("sse2")
+static void jtok_sse2_brackets(const char *blk, jtok_bracket_block_t *idx)
+{
+    const __m128i lower = _mm_set1_epi8(0x20);
+    __m128i       v[4];
+    __m128i       l[4];
+    int           i;
+    for (i = 0; i < 4; i++)
+    {
+        v[i] = _mm_loadu_si128((const __m128i *)&blk[16 * i]);
+        l[i] = _mm_or_si128(v[i], lower);
+    }
+
+    /* '[' and ']' are '{' and '}' without the 0x20 bit */
+    idx->open      = jtok_sse2_eq_mask(l, '{');
+    idx->close     = jtok_sse2_eq_mask(l, '}');
+    idx->comma     = jtok_sse2_eq_mask(v, ',');
+    idx->quote     = jtok_sse2_eq_mask(v, '\"');
+    idx->squote    = jtok_sse2_eq_mask(v, '\'');
+    idx->backslash = jtok_sse2_eq_mask(v, '\\');
+}
+
+#endif /* #if JTOK_HAVE_SSE2 */
+
+
+#if JTOK_HAVE_AVX2
+
+JTOK_TARGET("avx2")
+static uint64_t jtok_avx2_eq_mask(__m256i lo, __m256i hi, char c)
+{
+    __m256i  needle = _mm256_set1_epi8(c);
+    uint32_t m_lo   = (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(lo, needle));
+    uint32_t m_hi = (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(hi, needle));
+    return (uint64_t)m_lo | ((uint64_t)m_hi << 32);
+}
+
+
+JTOK_TARGET("avx2")
+static void jtok_avx2_classify(const char *blk, jtok_block_t *idx)
+{
+    __m256i lo = _mm256_loadu_si256((const __m256i *)&blk[0]);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)&blk[32]);
+
+    idx->whitespace = jtok_avx2_eq_mask(lo, hi, ' ') |
+                      jtok_avx2_eq_mask(lo, hi, '\t') |
+                      jtok_avx2_eq_mask(lo, hi, '\r') |
+                      jtok_avx2_eq_mask(lo, hi, '\n');
+    idx->structural = jtok_avx2_eq_mask(lo, hi, '{') |
+                      jtok_avx2_eq_mask(lo, hi, '}') |
+                      jtok_avx2_eq_mask(lo, hi, '[') |
+                      jtok_avx2_eq_mask(lo, hi, ']') |
+                      jtok_avx2_eq_mask(lo, hi, ':') |
+                      jtok_avx2_eq_mask(lo, hi, ',');
+    idx->quote     = jtok_avx2_eq_mask(lo, hi, '\"') |
+                     jtok_avx2_eq_mask(lo, hi, '\'');
+    idx->backslash = jtok_avx2_eq_mask(lo, hi, '\\');
+}
+
+
+JTOK_TARGET("avx2")
+static uint64_t jtok_avx2_whitespace(const char *blk)
+{
+    __m256i lo = _mm256_loadu_si256((const __m256i *)&blk[0]);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)&blk[32]);
+
+    return jtok_avx2_eq_mask(lo, hi, ' ') | jtok_avx2_eq_mask(lo, hi, '\t') |
+           jtok_avx2_eq_mask(lo, hi, '\r') | jtok_avx2_eq_mask(lo, hi, '\n');
+}
+
+
+JTOK_TARGET("avx2")
+static jtok_pos_t jtok_avx2_next_string_special(const char *json,
+                                                jtok_pos_t len, jtok_pos_t pos,
+                                                char quote)
+{
+    const __m256i q_needle = _mm256_set1_epi8(quote);
+    const __m256i b_needle = _mm256_set1_epi8('\\');
+    while (len - pos >= 32)
+    {
+        __m256i  v    = _mm256_loadu_si256((const __m256i *)&json[pos]);
+        __m256i  hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, q_needle),
+                                       _mm256_cmpeq_epi8(v, b_needle));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hits);
+        if (mask != 0)
+        {
+            return pos + jtok_ctz64(mask);
+        }
+        pos += 32;
+    }
+
+    /* Tail shorter than a vector */
+    return jtok_swar_next_string_special(json, len, pos, quote);
+}
+
+
+JTOK_TARGET("avx2")
+static void jtok_avx2_brackets(const char *blk, jtok_bracket_block_t *idx)
+{
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    __m256i       lo    = _mm256_loadu_si256((const __m256i *)&blk[0]);
+    __m256i       hi    = _mm256_loadu_si256((const __m256i *)&blk[32]);
+    __m256i       l_lo  = _mm256_or_si256(lo, lower);
+    __m256i       l_hi  = _mm256_or_si256(hi, lower);
+
+    /* '[' and ']' are '{' and '}' without the 0x20 bit */
+    idx->open      = jtok_avx2_eq_mask(l_lo, l_hi, '{');
+    idx->close     = jtok_avx2_eq_mask(l_lo, l_hi, '}');
+    idx->comma     = jtok_avx2_eq_mask(lo, hi, ',');
+    idx->quote     = jtok_avx2_eq_mask(lo, hi, '\"');
+    idx->squote    = jtok_avx2_eq_mask(lo, hi, '\'');
+    idx->backslash = jtok_avx2_eq_mask(lo, hi, '\\');
+}
+
+#endif /* #if JTOK_HAVE_AVX2 */
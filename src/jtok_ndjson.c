@@ -0,0 +1,142 @@
+/**
+ * @file jtok_ndjson.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to parse newline-delimited json (NDJSON) buffers one
+ * record at a time into a reusable token pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <string.h>
+
+#include "jtok.h"
+
+
+static size_t jtok_ndjson_skip_ws(const char *line, size_t pos, size_t len);
+
+
+void jtok_ndjson_init(jtok_ndjson_t *nd, const char *buf, size_t len)
+{
+    if (nd != NULL)
+    {
+        nd->buf     = buf;
+        nd->len     = (buf == NULL) ? 0 : len;
+        nd->pos     = 0;
+        nd->records = 0;
+    }
+}
+
+
+bool jtok_ndjson_next(jtok_ndjson_t *nd, jtok_tkn_t *tkns, size_t size,
+                      jtok_ndjson_rec_t *rec)
+{
+    if (nd == NULL || rec == NULL)
+    {
+        return false;
+    }
+
+    while (nd->pos < nd->len)
+    {
+        /* Records are bounded by the newline before they are parsed so a
+         * record cut off mid-object cannot swallow the one after it */
+        const char *line    = &nd->buf[nd->pos];
+        size_t      avail   = nd->len - nd->pos;
+        const char *nl      = memchr(line, '\n', avail);
+        size_t      linelen = (nl == NULL) ? avail : (size_t)(nl - line);
+        size_t      next    = nd->pos + linelen + ((nl == NULL) ? 0 : 1);
+
+        if (jtok_ndjson_skip_ws(line, 0, linelen) == linelen)
+        {
+            /* Blank line */
+            nd->pos = next;
+            continue;
+        }
+
+        rec->json   = line;
+        rec->len    = linelen;
+        rec->index  = nd->records;
+        rec->used   = 0;
+        rec->status = jtok_parse_n_used(line, linelen, tkns, size, &rec->used);
+        if (rec->status == JTOK_PARSE_STATUS_PARTIAL_TOKEN && nl == NULL)
+        {
+            /* The rest of the record has not arrived yet */
+            return false;
+        }
+
+        if (rec->status == JTOK_PARSE_STATUS_OK &&
+            jtok_ndjson_skip_ws(line, (size_t)tkns[0].end, linelen) != linelen)
+        {
+            /* eg: {"a":1} {"b":2} on one line */
+            rec->status = JTOK_PARSE_STATUS_INVAL;
+        }
+
+        if (tkns != NULL && rec->used < size)
+        {
+            tkns[rec->used].type = JTOK_UNASSIGNED_TOKEN;
+        }
+        nd->pos = next;
+        nd->records++;
+        return true;
+    }
+    return false;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_ndjson_parse(const char *buf, size_t len,
+                                      jtok_tkn_t *tkns, size_t size,
+                                      jtok_ndjson_cb_t cb, void *ctx,
+                                      size_t *consumed)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    jtok_ndjson_t       nd;
+    jtok_ndjson_rec_t   rec;
+
+    jtok_ndjson_init(&nd, buf, len);
+    if (buf == NULL || tkns == NULL || cb == NULL)
+    {
+        status = JTOK_PARSE_STATUS_NULL_PARAM;
+    }
+    else
+    {
+        while (jtok_ndjson_next(&nd, tkns, size, &rec))
+        {
+            if (status == JTOK_PARSE_STATUS_OK)
+            {
+                status = rec.status;
+            }
+
+            if (!cb(&rec, tkns, ctx))
+            {
+                break;
+            }
+        }
+    }
+
+    if (consumed != NULL)
+    {
+        *consumed = nd.pos;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Find the first char of a line that is not whitespace
+ *
+ * @param line the line
+ * @param pos index to start looking at
+ * @param len number of chars in the line
+ * @return size_t index of the char, len if there is none
+ */
+static size_t jtok_ndjson_skip_ws(const char *line, size_t pos, size_t len)
+{
+    while (pos < len &&
+           (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+    {
+        pos++;
+    }
+    return pos;
+}
@@ -0,0 +1,1150 @@
+/**
+ * @file jtok_number.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to convert primitive tokens to C values. Integers
+ * are converted a word of digits at a time, doubles with the Clinger fast
+ * path then the Eisel-Lemire algorithm, and fixed-point values with integer
+ * arithmetic only, so none copies the token or depends on the locale.
+ * Numbers are compared digit by digit, without converting them.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <string.h>
+#if JTOK_FLOAT
+#include <float.h>
+#endif /* #if JTOK_FLOAT */
+
+#include "jtok_number.h"
+#include "jtok_shared.h"
+#include "jtok_swar.h"
+
+/* Fraction bits of a Q16.16 value */
+#define JTOK_Q16_16_FRAC_BITS (16)
+
+#if JTOK_FLOAT
+/* binary64 layout */
+#define JTOK_DOUBLE_MANTISSA_BITS (52)
+#define JTOK_DOUBLE_MIN_EXPONENT (-1023)
+#define JTOK_DOUBLE_INFINITE_POWER (0x7FF)
+#define JTOK_DOUBLE_HIDDEN_BIT (UINT64_C(1) << JTOK_DOUBLE_MANTISSA_BITS)
+
+/* Largest power of ten and mantissa a double holds exactly */
+#define JTOK_DOUBLE_EXACT_POW10 (22)
+#define JTOK_DOUBLE_EXACT_MANTISSA (UINT64_C(1) << 53)
+#define JTOK_DOUBLE_EXACT_DIGITS (15)
+#endif /* #if JTOK_FLOAT */
+
+/* Decimal exponents are saturated here while being read */
+#define JTOK_EXP10_LIMIT (100000)
+
+/* Exponents further apart than this stay apart whatever the position of
+ * the first significant digit of the mantissas */
+#define JTOK_LEXEME_EXP10_LIMIT (INT64_C(100000000000000000))
+
+static const char *jtok_number_digits(const char *p, const char *end,
+                                      jtok_decimal_t *dec, bool fraction);
+static bool       jtok_tok_decimal(const jtok_tkn_t *tkn, jtok_decimal_t *dec);
+static bool       jtok_lexeme_exp10_eq(const jtok_lexeme_t *lex1,
+                                       const jtok_lexeme_t *lex2);
+static bool jtok_decimal_to_binary_fixed(const jtok_decimal_t *dec,
+                                         unsigned int frac_bits, uint64_t limit,
+                                         uint64_t *magnitude);
+static bool jtok_decimal_to_scaled(const jtok_decimal_t *dec,
+                                   unsigned int decimals, uint64_t limit,
+                                   uint64_t *magnitude);
+#if JTOK_FLOAT
+static bool     jtok_double_fast_path(const jtok_decimal_t *dec, double *value);
+static uint64_t jtok_double_eisel_lemire(uint64_t w, int32_t q);
+static void jtok_mul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo);
+static unsigned int jtok_clz64(uint64_t x);
+static uint64_t jtok_double_digit_compare(const char *str, jtok_pos_t len,
+                                          uint64_t bits);
+static void     jtok_bigint_set(jtok_bigint_t *b, uint64_t value);
+static void jtok_bigint_muladd(jtok_bigint_t *b, uint32_t mul, uint32_t add);
+static void jtok_bigint_mul_pow5(jtok_bigint_t *b, uint32_t e);
+static void jtok_bigint_shl(jtok_bigint_t *b, uint32_t bits);
+static int  jtok_bigint_cmp(const jtok_bigint_t *a, const jtok_bigint_t *b);
+#endif /* #if JTOK_FLOAT */
+
+static const uint64_t jtok_pow10_u64[JTOK_DECIMAL_DIGITS_MAX + 1] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL,
+};
+
+
+bool jtok_tok_to_int64(const jtok_tkn_t *tkn, int64_t *value)
+{
+    bool converted = false;
+    if (tkn != NULL && value != NULL && tkn->type == JTOK_PRIMITIVE &&
+        tkn->subtype == JTOK_SUBTYPE_INTEGER)
+    {
+        converted = jtok_number_to_int64(&tkn->json[tkn->start],
+                                         tkn->end - tkn->start, value);
+    }
+    return converted;
+}
+
+
+#if JTOK_FLOAT
+bool jtok_tok_to_double(const jtok_tkn_t *tkn, double *value)
+{
+    bool converted = false;
+    if (tkn != NULL && value != NULL && tkn->type == JTOK_PRIMITIVE)
+    {
+        switch (tkn->subtype)
+        {
+            case JTOK_SUBTYPE_INTEGER:
+            {
+                /* Up to 15 digits convert exactly through an integer. Not
+                 * 0, which would lose the sign of -0 */
+                int64_t integer;
+                if (tkn->end - tkn->start <= JTOK_DOUBLE_EXACT_DIGITS &&
+                    jtok_number_to_int64(&tkn->json[tkn->start],
+                                         tkn->end - tkn->start, &integer) &&
+                    integer != 0)
+                {
+                    *value    = (double)integer;
+                    converted = true;
+                    break;
+                }
+            }
+            /* fall through */
+            case JTOK_SUBTYPE_DECIMAL:
+            case JTOK_SUBTYPE_EXPONENT:
+            {
+                converted = jtok_number_to_double(&tkn->json[tkn->start],
+                                                  tkn->end - tkn->start, value);
+            }
+            break;
+            default:
+            {
+            }
+            break;
+        }
+    }
+    return converted;
+}
+#endif /* #if JTOK_FLOAT */
+
+
+bool jtok_tok_to_q16_16(const jtok_tkn_t *tkn, int32_t *value)
+{
+    jtok_decimal_t dec;
+    uint64_t       magnitude;
+    bool           converted = false;
+    if (value != NULL && jtok_tok_decimal(tkn, &dec))
+    {
+        /* One more for the magnitude of INT32_MIN */
+        converted = jtok_decimal_to_binary_fixed(
+            &dec, JTOK_Q16_16_FRAC_BITS, (uint64_t)INT32_MAX + dec.negative,
+            &magnitude);
+        if (converted)
+        {
+            *value = (int32_t)(dec.negative ? -(int64_t)magnitude
+                                            : (int64_t)magnitude);
+        }
+    }
+    return converted;
+}
+
+
+bool jtok_tok_to_scaled(const jtok_tkn_t *tkn, unsigned int decimals,
+                        int64_t *value)
+{
+    jtok_decimal_t dec;
+    uint64_t       magnitude;
+    bool           converted = false;
+    if (value != NULL && jtok_tok_decimal(tkn, &dec))
+    {
+        converted = jtok_decimal_to_scaled(
+            &dec, decimals, (uint64_t)INT64_MAX + dec.negative, &magnitude);
+        if (converted)
+        {
+            *value = (magnitude == (uint64_t)INT64_MAX + 1)
+                         ? INT64_MIN
+                         : (dec.negative ? -(int64_t)magnitude
+                                         : (int64_t)magnitude);
+        }
+    }
+    return converted;
+}
+
+
+bool jtok_tok_to_bool(const jtok_tkn_t *tkn, bool *value)
+{
+    bool converted = false;
+    if (tkn != NULL && value != NULL && tkn->type == JTOK_PRIMITIVE)
+    {
+        if (tkn->subtype == JTOK_SUBTYPE_TRUE ||
+            tkn->subtype == JTOK_SUBTYPE_FALSE)
+        {
+            *value    = (tkn->subtype == JTOK_SUBTYPE_TRUE);
+            converted = true;
+        }
+    }
+    return converted;
+}
+
+
+bool jtok_number_decimal(const char *str, jtok_pos_t len, jtok_decimal_t *dec)
+{
+    const char *p   = str;
+    const char *end = str + len;
+    const char *mantissa;
+
+    memset(dec, 0, sizeof(*dec));
+    if (p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_SIGN)
+    {
+        dec->negative = (*p == '-');
+        p++;
+    }
+
+    mantissa = p;
+    p        = jtok_number_digits(p, end, dec, false);
+    if (p < end && *p == '.')
+    {
+        p = jtok_number_digits(p + 1, end, dec, true);
+    }
+    if (p == mantissa || (p == mantissa + 1 && *mantissa == '.'))
+    {
+        /* No digits at all */
+        return false;
+    }
+
+    if (p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_EXPONENT)
+    {
+        bool    negative = false;
+        int32_t exp10    = 0;
+        if (++p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_SIGN)
+        {
+            negative = (*p == '-');
+            p++;
+        }
+        if (p == end)
+        {
+            return false;
+        }
+        for (; p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_DIGIT; p++)
+        {
+            if (exp10 < JTOK_EXP10_LIMIT)
+            {
+                exp10 = exp10 * 10 + (*p - '0');
+            }
+        }
+        dec->exp10 += negative ? -exp10 : exp10;
+    }
+    return p == end;
+}
+
+
+bool jtok_number_to_int64(const char *str, jtok_pos_t len, int64_t *value)
+{
+    const char *end      = str + len;
+    bool        negative = false;
+    uint64_t    magnitude;
+    jtok_pos_t  count;
+
+    if (len > 0 && JTOK_CHAR_CLASS(*str) == JTOK_CHAR_SIGN)
+    {
+        negative = (*str == '-');
+        str++;
+    }
+    if (str == end)
+    {
+        return false;
+    }
+    while (str < end - 1 && *str == '0')
+    {
+        str++;
+    }
+
+    /* 19 digits never overflow a uint64_t but may overflow an int64_t */
+    count = (jtok_pos_t)(end - str);
+    if (count > JTOK_DECIMAL_DIGITS_MAX ||
+        !jtok_swar_digits_value(str, count, &magnitude))
+    {
+        return false;
+    }
+
+    if (negative)
+    {
+        if (magnitude > (uint64_t)INT64_MAX + 1)
+        {
+            return false;
+        }
+        *value = (magnitude == (uint64_t)INT64_MAX + 1) ? INT64_MIN
+                                                        : -(int64_t)magnitude;
+    }
+    else
+    {
+        if (magnitude > (uint64_t)INT64_MAX)
+        {
+            return false;
+        }
+        *value = (int64_t)magnitude;
+    }
+    return true;
+}
+
+
+bool jtok_number_lexeme(const char *str, jtok_pos_t len, jtok_lexeme_t *lex)
+{
+    const char *p   = str;
+    const char *end = str + len;
+    const char *integer;
+    const char *integer_end;
+    const char *mantissa_end;
+    int64_t     exp10 = 0;
+
+    lex->point        = NULL;
+    lex->exp_first    = end;
+    lex->exp_end      = end;
+    lex->negative     = false;
+    lex->exp_negative = false;
+    if (p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_SIGN)
+    {
+        lex->negative = (*p == '-');
+        p++;
+    }
+
+    integer = p;
+    p += jtok_swar_skip_digits(p, (jtok_pos_t)(end - p), 0);
+    integer_end = p;
+    if (p < end && *p == '.')
+    {
+        lex->point = p++;
+        p += jtok_swar_skip_digits(p, (jtok_pos_t)(end - p), 0);
+    }
+    mantissa_end = p;
+    if (mantissa_end == integer ||
+        (mantissa_end == integer + 1 && lex->point == integer))
+    {
+        /* No digits at all */
+        return false;
+    }
+
+    if (p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_EXPONENT)
+    {
+        if (++p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_SIGN)
+        {
+            lex->exp_negative = (*p == '-');
+            p++;
+        }
+        if (p == end)
+        {
+            return false;
+        }
+        for (; p < end && *p == '0'; p++)
+        {
+        }
+        lex->exp_first = p;
+        for (; p < end && JTOK_CHAR_CLASS(*p) == JTOK_CHAR_DIGIT; p++)
+        {
+            if (p - lex->exp_first < JTOK_LEXEME_EXP10_DIGITS)
+            {
+                exp10 = exp10 * 10 + (*p - '0');
+            }
+        }
+        lex->exp_end = p;
+        if (lex->exp_end - lex->exp_first > JTOK_LEXEME_EXP10_DIGITS)
+        {
+            /* Too many digits for exp10, the exponent is compared as text */
+            exp10 = 0;
+        }
+        exp10 = lex->exp_negative ? -exp10 : exp10;
+    }
+    if (p != end)
+    {
+        return false;
+    }
+
+    /* Leading and trailing zeros are not significant */
+    for (lex->first = integer; lex->first < mantissa_end; lex->first++)
+    {
+        if (*lex->first != '0' && *lex->first != '.')
+        {
+            break;
+        }
+    }
+    if (lex->first == mantissa_end)
+    {
+        lex->first = NULL;
+        lex->last  = NULL;
+        return true;
+    }
+    for (lex->last = mantissa_end - 1; *lex->last == '0' || *lex->last == '.';
+         lex->last--)
+    {
+    }
+
+    if (lex->first < integer_end)
+    {
+        exp10 += (int64_t)(integer_end - lex->first) - 1;
+    }
+    else
+    {
+        exp10 -= (int64_t)(lex->first - lex->point);
+    }
+    lex->exp10 = exp10;
+    return true;
+}
+
+
+bool jtok_number_eq(const char *str1, jtok_pos_t len1, const char *str2,
+                    jtok_pos_t len2)
+{
+    jtok_lexeme_t lex1;
+    jtok_lexeme_t lex2;
+    const char *  p1;
+    const char *  p2;
+
+    if (!jtok_number_lexeme(str1, len1, &lex1) ||
+        !jtok_number_lexeme(str2, len2, &lex2))
+    {
+        return false;
+    }
+
+    /* 0 has no significant digits whatever its sign and exponent */
+    if (lex1.first == NULL || lex2.first == NULL)
+    {
+        return lex1.first == lex2.first;
+    }
+    if (lex1.negative != lex2.negative || !jtok_lexeme_exp10_eq(&lex1, &lex2))
+    {
+        return false;
+    }
+
+    /* Same power of ten for the first digit, so the digits line up */
+    p1 = lex1.first;
+    p2 = lex2.first;
+    for (;;)
+    {
+        if (*p1 != *p2)
+        {
+            return false;
+        }
+        if (p1 == lex1.last || p2 == lex2.last)
+        {
+            return p1 == lex1.last && p2 == lex2.last;
+        }
+        p1++;
+        p2++;
+        p1 += (*p1 == '.');
+        p2 += (*p2 == '.');
+    }
+}
+
+
+#if JTOK_FLOAT
+bool jtok_number_to_double(const char *str, jtok_pos_t len, double *value)
+{
+    jtok_decimal_t dec;
+    uint64_t       bits;
+
+    if (!jtok_number_decimal(str, len, &dec))
+    {
+        return false;
+    }
+
+    if (jtok_double_fast_path(&dec, value))
+    {
+        return true;
+    }
+
+    bits = jtok_double_eisel_lemire(dec.mantissa, dec.exp10);
+    if (dec.truncated &&
+        bits != jtok_double_eisel_lemire(dec.mantissa + 1, dec.exp10))
+    {
+        /* The dropped digits decide the rounding */
+        bits = jtok_double_digit_compare(str, len, bits);
+    }
+
+    bits |= (uint64_t)dec.negative << 63;
+    memcpy(value, &bits, sizeof(*value));
+    return true;
+}
+#endif /* #if JTOK_FLOAT */
+
+
+/**
+ * @brief Add a run of digits to the mantissa of a decimal
+ *
+ * @param p first char of the run
+ * @param end end of the number
+ * @param dec the decimal
+ * @param fraction the run is after the decimal point
+ * @return const char* first char after the run
+ *
+ * @note Leading zeros are not significant. Digits after the first
+ * JTOK_DECIMAL_DIGITS_MAX significant ones are dropped
+ */
+static const char *jtok_number_digits(const char *p, const char *end,
+                                      jtok_decimal_t *dec, bool fraction)
+{
+    const char *stop = p + jtok_swar_skip_digits(p, (jtok_pos_t)(end - p), 0);
+    jtok_pos_t  take;
+    uint64_t    value;
+
+    if (dec->digits == 0)
+    {
+        for (; p < stop && *p == '0'; p++)
+        {
+            dec->exp10 -= fraction;
+        }
+    }
+
+    take = (jtok_pos_t)(stop - p);
+    if (take > JTOK_DECIMAL_DIGITS_MAX - dec->digits)
+    {
+        take = JTOK_DECIMAL_DIGITS_MAX - dec->digits;
+    }
+    jtok_swar_digits_value(p, take, &value);
+    dec->mantissa = dec->mantissa * jtok_pow10_u64[take] + value;
+    dec->digits += (int)take;
+    dec->exp10 -= fraction ? (int32_t)take : 0;
+    p += take;
+
+    /* Dropped digits of the integer part still scale the value */
+    dec->exp10 += fraction ? 0 : (int32_t)(stop - p);
+    for (; p < stop; p++)
+    {
+        dec->truncated |= (*p != '0');
+    }
+    return stop;
+}
+
+
+/**
+ * @brief Compare the powers of ten of the first significant digits of two
+ * lexemes, also when their exponents have too many digits for exp10
+ *
+ * @param lex1 the first lexeme
+ * @param lex2 the second lexeme
+ * @return true if the powers of ten are equal
+ */
+static bool jtok_lexeme_exp10_eq(const jtok_lexeme_t *lex1,
+                                 const jtok_lexeme_t *lex2)
+{
+    jtok_pos_t n1   = (jtok_pos_t)(lex1->exp_end - lex1->exp_first);
+    jtok_pos_t n2   = (jtok_pos_t)(lex2->exp_end - lex2->exp_first);
+    jtok_pos_t n    = (n1 > n2) ? n1 : n2;
+    int64_t    e1   = 0; /* exponents, while they fit */
+    int64_t    e2   = 0;
+    int64_t    diff = 0; /* first exponent minus the second */
+    int64_t    shift1;
+    int64_t    shift2;
+    jtok_pos_t i;
+
+    if (n1 <= JTOK_LEXEME_EXP10_DIGITS && n2 <= JTOK_LEXEME_EXP10_DIGITS)
+    {
+        return lex1->exp10 == lex2->exp10;
+    }
+    if (lex1->exp_negative != lex2->exp_negative)
+    {
+        /* At least one exponent is past JTOK_LEXEME_EXP10_LIMIT */
+        return false;
+    }
+
+    /* Subtract the exponents digit by digit, aligned on their last digit */
+    for (i = 0; i < n; i++)
+    {
+        int d1 = (i < n - n1) ? 0 : lex1->exp_first[i - (n - n1)] - '0';
+        int d2 = (i < n - n2) ? 0 : lex2->exp_first[i - (n - n2)] - '0';
+        diff   = diff * 10 + d1 - d2;
+        if (diff > JTOK_LEXEME_EXP10_LIMIT || diff < -JTOK_LEXEME_EXP10_LIMIT)
+        {
+            /* Only grows from here */
+            return false;
+        }
+        e1 = (n1 <= JTOK_LEXEME_EXP10_DIGITS) ? e1 * 10 + d1 : 0;
+        e2 = (n2 <= JTOK_LEXEME_EXP10_DIGITS) ? e2 * 10 + d2 : 0;
+    }
+
+    /* exp10 holds the exponent only if it has few digits. The rest is the
+     * position of the first significant digit of the mantissa */
+    shift1 = lex1->exp10 - (lex1->exp_negative ? -e1 : e1);
+    shift2 = lex2->exp10 - (lex2->exp_negative ? -e2 : e2);
+    return (lex1->exp_negative ? -diff : diff) == shift2 - shift1;
+}
+
+
+/**
+ * @brief Split a number token into a decimal mantissa and exponent
+ *
+ * @return true if split, false if the token is not a number
+ */
+static bool jtok_tok_decimal(const jtok_tkn_t *tkn, jtok_decimal_t *dec)
+{
+    bool split = false;
+    if (tkn != NULL && tkn->type == JTOK_PRIMITIVE &&
+        (tkn->subtype == JTOK_SUBTYPE_INTEGER ||
+         tkn->subtype == JTOK_SUBTYPE_DECIMAL ||
+         tkn->subtype == JTOK_SUBTYPE_EXPONENT))
+    {
+        split = jtok_number_decimal(&tkn->json[tkn->start],
+                                    tkn->end - tkn->start, dec);
+    }
+    return split;
+}
+
+
+/**
+ * @brief Scale a decimal by a power of two and round it to an integer
+ *
+ * @param dec the decimal
+ * @param frac_bits the power of two, at most 18
+ * @param limit largest magnitude allowed
+ * @param magnitude |dec| * 2^frac_bits, rounded to nearest with ties away
+ * from zero
+ * @return true if converted, false if the magnitude is over the limit
+ *
+ * @note The integer part is split off with one division by a power of ten
+ * and the fraction is then turned into frac_bits bits by doubling it, so
+ * nothing wider than 64 bits is needed
+ */
+static bool jtok_decimal_to_binary_fixed(const jtok_decimal_t *dec,
+                                         unsigned int frac_bits, uint64_t limit,
+                                         uint64_t *magnitude)
+{
+    uint64_t     integer;
+    uint64_t     rest  = 0;
+    uint64_t     denom = 1;
+    unsigned int i;
+
+    if (dec->mantissa == 0)
+    {
+        integer = 0;
+    }
+    else if (dec->exp10 >= 0)
+    {
+        if (dec->exp10 > JTOK_DECIMAL_DIGITS_MAX ||
+            dec->mantissa > (limit >> frac_bits) / jtok_pow10_u64[dec->exp10])
+        {
+            return false;
+        }
+        integer = dec->mantissa * jtok_pow10_u64[dec->exp10];
+    }
+    else if (dec->exp10 >= -JTOK_DECIMAL_DIGITS_MAX)
+    {
+        denom   = jtok_pow10_u64[-dec->exp10];
+        integer = dec->mantissa / denom;
+        rest    = dec->mantissa % denom;
+    }
+    else
+    {
+        /* Half way points are multiples of 2^-(frac_bits + 1), so have at
+         * most 19 decimals. Cutting the fraction after 19 decimals never
+         * moves it across one */
+        int32_t cut = -dec->exp10 - JTOK_DECIMAL_DIGITS_MAX;
+        denom       = jtok_pow10_u64[JTOK_DECIMAL_DIGITS_MAX];
+        integer     = 0;
+        rest        = (cut > JTOK_DECIMAL_DIGITS_MAX)
+                          ? 0
+                          : dec->mantissa / jtok_pow10_u64[cut];
+    }
+
+    if (integer > (limit >> frac_bits))
+    {
+        return false;
+    }
+
+    /* rest < denom, so neither rest + rest nor rest - (denom - rest)
+     * overflows */
+    for (i = 0; i < frac_bits; i++)
+    {
+        integer <<= 1;
+        if (rest >= denom - rest)
+        {
+            integer |= 1;
+            rest -= denom - rest;
+        }
+        else
+        {
+            rest += rest;
+        }
+    }
+    if (rest >= denom - rest)
+    {
+        integer++;
+    }
+
+    if (integer > limit)
+    {
+        return false;
+    }
+    *magnitude = integer;
+    return true;
+}
+
+
+/**
+ * @brief Scale a decimal by a power of ten and round it to an integer
+ *
+ * @param dec the decimal
+ * @param decimals the power of ten
+ * @param limit largest magnitude allowed
+ * @param magnitude |dec| * 10^decimals, rounded to nearest with ties away
+ * from zero
+ * @return true if converted, false if the magnitude is over the limit
+ */
+static bool jtok_decimal_to_scaled(const jtok_decimal_t *dec,
+                                   unsigned int decimals, uint64_t limit,
+                                   uint64_t *magnitude)
+{
+    int64_t  exp10 = (int64_t)dec->exp10 + decimals;
+    uint64_t scaled;
+
+    if (dec->mantissa == 0)
+    {
+        scaled = 0;
+    }
+    else if (exp10 >= 0)
+    {
+        if (exp10 > JTOK_DECIMAL_DIGITS_MAX ||
+            dec->mantissa > limit / jtok_pow10_u64[exp10])
+        {
+            return false;
+        }
+        scaled = dec->mantissa * jtok_pow10_u64[exp10];
+    }
+    else if (exp10 >= -JTOK_DECIMAL_DIGITS_MAX)
+    {
+        uint64_t denom = jtok_pow10_u64[-exp10];
+        uint64_t rest  = dec->mantissa % denom;
+        scaled         = dec->mantissa / denom + (rest >= denom - rest);
+    }
+    else
+    {
+        /* The mantissa is under 10^19, so the scaled value under 0.1 */
+        scaled = 0;
+    }
+
+    if (scaled > limit)
+    {
+        return false;
+    }
+    *magnitude = scaled;
+    return true;
+}
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Convert a decimal with one correctly rounded operation when both
+ * its mantissa and power of ten are exact doubles (Clinger's fast path)
+ *
+ * @return true if converted, false if the decimal needs the slow path
+ */
+static bool jtok_double_fast_path(const jtok_decimal_t *dec, double *value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double pow10[JTOK_DOUBLE_EXACT_POW10 + 1] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    double d;
+    if (dec->truncated || dec->mantissa > JTOK_DOUBLE_EXACT_MANTISSA ||
+        dec->exp10 < -JTOK_DOUBLE_EXACT_POW10 ||
+        dec->exp10 > JTOK_DOUBLE_EXACT_POW10)
+    {
+        return false;
+    }
+
+    d = (double)dec->mantissa;
+    if (dec->exp10 < 0)
+    {
+        d /= pow10[-dec->exp10];
+    }
+    else
+    {
+        d *= pow10[dec->exp10];
+    }
+    *value = dec->negative ? -d : d;
+    return true;
+#else
+    /* Extended precision intermediates round twice */
+    (void)dec;
+    (void)value;
+    return false;
+#endif /* #if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0 */
+}
+
+
+/**
+ * @brief Round w * 10^q to the nearest double
+ *
+ * @param w decimal mantissa
+ * @param q decimal exponent
+ * @return uint64_t bits of the positive double
+ *
+ * @note Eisel-Lemire: w * 5^q is approximated by a 128 bit product with the
+ * table of powers of five, and 2^q goes straight into the binary exponent.
+ * The product is always precise enough to round correctly when w is exact
+ */
+static uint64_t jtok_double_eisel_lemire(uint64_t w, int32_t q)
+{
+    uint64_t     hi;
+    uint64_t     lo;
+    uint64_t     mantissa;
+    int32_t      power2;
+    unsigned int lz;
+    unsigned int upperbit;
+    size_t       index;
+
+    if (w == 0 || q < JTOK_POW5_MIN)
+    {
+        return 0;
+    }
+    if (q > JTOK_POW5_MAX)
+    {
+        return (uint64_t)JTOK_DOUBLE_INFINITE_POWER
+               << JTOK_DOUBLE_MANTISSA_BITS;
+    }
+
+    lz = jtok_clz64(w);
+    w <<= lz;
+    index = 2 * (size_t)(q - JTOK_POW5_MIN);
+    jtok_mul64(w, jtok_pow5_table[index], &hi, &lo);
+    if ((hi & 0x1FF) == 0x1FF)
+    {
+        /* The bits below the mantissa and rounding bit are all ones. The low
+         * word of the power may carry into them */
+        uint64_t hi2;
+        uint64_t lo2;
+        jtok_mul64(w, jtok_pow5_table[index + 1], &hi2, &lo2);
+        lo += hi2;
+        hi += (hi2 > lo);
+    }
+
+    /* floor(log2(10^q)) + 63, with a floor division for negative q */
+    upperbit = (unsigned int)(hi >> 63);
+    mantissa = hi >> (upperbit + 9);
+    power2   = (217706 * q - (q < 0 ? 65535 : 0)) / 65536 + 63;
+    power2 += (int32_t)upperbit - (int32_t)lz - JTOK_DOUBLE_MIN_EXPONENT;
+
+    if (power2 <= 0)
+    {
+        /* Subnormal, or normal only once rounded up */
+        if (-power2 + 1 >= 64)
+        {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = (mantissa < JTOK_DOUBLE_HIDDEN_BIT) ? 0 : 1;
+        return mantissa | ((uint64_t)power2 << JTOK_DOUBLE_MANTISSA_BITS);
+    }
+
+    /* Exactly half way between two doubles: round to even. Only possible
+     * for small powers of ten */
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << (upperbit + 9)) == hi)
+    {
+        mantissa &= ~(uint64_t)1;
+    }
+
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= (JTOK_DOUBLE_HIDDEN_BIT << 1))
+    {
+        mantissa = JTOK_DOUBLE_HIDDEN_BIT;
+        power2++;
+    }
+    mantissa &= ~JTOK_DOUBLE_HIDDEN_BIT;
+    if (power2 >= JTOK_DOUBLE_INFINITE_POWER)
+    {
+        power2   = JTOK_DOUBLE_INFINITE_POWER;
+        mantissa = 0;
+    }
+    return mantissa | ((uint64_t)power2 << JTOK_DOUBLE_MANTISSA_BITS);
+}
+
+
+/**
+ * @brief Full 128 bit product of two 64 bit words
+ */
+static void jtok_mul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ unsigned __int128 r = (unsigned __int128)a * b;
+    *hi                               = (uint64_t)(r >> 64);
+    *lo                               = (uint64_t)r;
+#else
+    uint64_t a_lo = (uint32_t)a;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b;
+    uint64_t b_hi = b >> 32;
+    uint64_t p0   = a_lo * b_lo;
+    uint64_t p1   = a_lo * b_hi;
+    uint64_t p2   = a_hi * b_lo;
+    uint64_t mid  = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    *lo           = (mid << 32) | (uint32_t)p0;
+    *hi           = a_hi * b_hi + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif /* #if defined(__SIZEOF_INT128__) */
+}
+
+
+/**
+ * @brief Count the leading zero bits of a word, which must not be 0
+ */
+static unsigned int jtok_clz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_clzll(x);
+#else
+    unsigned int n = 0;
+    while ((x & (UINT64_C(1) << 63)) == 0)
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif /* #if defined(__GNUC__) */
+}
+
+
+/**
+ * @brief Round a number whose first 19 digits leave two doubles to choose
+ * from, by comparing all its digits with the point half way between them
+ *
+ * @param str the number
+ * @param len number of chars of the number
+ * @param bits bits of the lower of the two positive doubles
+ * @return uint64_t bits of the nearest positive double
+ *
+ * @note The digits are read into a big integer N with value N * 10^k and the
+ * half way point is (2m + 1) * 2^(e - 1) for the lower double m * 2^e. Both
+ * sides are scaled by the powers of five and two until they are integers
+ */
+static uint64_t jtok_double_digit_compare(const char *str, jtok_pos_t len,
+                                          uint64_t bits)
+{
+    jtok_lexeme_t lex;
+    jtok_bigint_t digits;
+    jtok_bigint_t half;
+    const char *  p;
+    uint32_t      chunk        = 0;
+    unsigned int  chunk_digits = 0;
+    int64_t       count        = 0;
+    int64_t       exp10;
+    int64_t       exp2;
+    int64_t       shift;
+    uint64_t      mantissa;
+    uint64_t      power2;
+    bool          sticky;
+    int           cmp;
+
+    if (!jtok_number_lexeme(str, len, &lex) || lex.first == NULL)
+    {
+        return bits;
+    }
+
+    jtok_bigint_set(&digits, 0);
+    for (p = lex.first; p <= lex.last && count < JTOK_DOUBLE_DIGITS_MAX; p++)
+    {
+        if (*p == '.')
+        {
+            continue;
+        }
+        chunk = chunk * 10 + (uint32_t)(*p - '0');
+        count++;
+        if (++chunk_digits == 9)
+        {
+            jtok_bigint_muladd(&digits, 1000000000u, chunk);
+            chunk        = 0;
+            chunk_digits = 0;
+        }
+    }
+    if (chunk_digits > 0)
+    {
+        jtok_bigint_muladd(&digits, (uint32_t)jtok_pow10_u64[chunk_digits],
+                           chunk);
+    }
+
+    /* The last digit is not 0, so any digit left is above the point */
+    sticky = (p <= lex.last);
+    exp10  = lex.exp10 - (count - 1);
+
+    power2   = bits >> JTOK_DOUBLE_MANTISSA_BITS;
+    mantissa = bits & (JTOK_DOUBLE_HIDDEN_BIT - 1);
+    if (power2 == 0)
+    {
+        exp2 = 1 + JTOK_DOUBLE_MIN_EXPONENT - JTOK_DOUBLE_MANTISSA_BITS;
+    }
+    else
+    {
+        mantissa |= JTOK_DOUBLE_HIDDEN_BIT;
+        exp2 = (int64_t)power2 + JTOK_DOUBLE_MIN_EXPONENT -
+               JTOK_DOUBLE_MANTISSA_BITS;
+    }
+    jtok_bigint_set(&half, 2 * mantissa + 1);
+
+    /* N * 10^k against (2m + 1) * 2^(e - 1), both divided by 2^k */
+    if (exp10 >= 0)
+    {
+        jtok_bigint_mul_pow5(&digits, (uint32_t)exp10);
+    }
+    else
+    {
+        jtok_bigint_mul_pow5(&half, (uint32_t)-exp10);
+    }
+    shift = exp2 - 1 - exp10;
+    if (shift >= 0)
+    {
+        jtok_bigint_shl(&half, (uint32_t)shift);
+    }
+    else
+    {
+        jtok_bigint_shl(&digits, (uint32_t)-shift);
+    }
+
+    cmp = jtok_bigint_cmp(&digits, &half);
+    if (cmp > 0 || (cmp == 0 && (sticky || (bits & 1))))
+    {
+        /* Also carries into the exponent, up to infinity */
+        bits++;
+    }
+    return bits;
+}
+
+
+/**
+ * @brief Set a big integer to a 64 bit value
+ */
+static void jtok_bigint_set(jtok_bigint_t *b, uint64_t value)
+{
+    b->len = 0;
+    while (value != 0)
+    {
+        b->limb[b->len++] = (uint32_t)value;
+        value >>= 32;
+    }
+}
+
+
+/**
+ * @brief Multiply a big integer by a word and add another
+ *
+ * @param b the big integer, b * mul + add once done
+ * @param mul the factor
+ * @param add the addend
+ */
+static void jtok_bigint_muladd(jtok_bigint_t *b, uint32_t mul, uint32_t add)
+{
+    uint64_t carry = add;
+    for (size_t i = 0; i < b->len; i++)
+    {
+        uint64_t product = (uint64_t)b->limb[i] * mul + carry;
+        b->limb[i]       = (uint32_t)product;
+        carry            = product >> 32;
+    }
+    if (carry != 0 && b->len < JTOK_BIGINT_LIMBS)
+    {
+        b->limb[b->len++] = (uint32_t)carry;
+    }
+}
+
+
+/**
+ * @brief Multiply a big integer by 5^e
+ */
+static void jtok_bigint_mul_pow5(jtok_bigint_t *b, uint32_t e)
+{
+    /* 5^13 is the largest power of five in a limb */
+    uint32_t pow5 = 1;
+    for (; e >= 13; e -= 13)
+    {
+        jtok_bigint_muladd(b, 1220703125u, 0);
+    }
+    for (; e > 0; e--)
+    {
+        pow5 *= 5;
+    }
+    jtok_bigint_muladd(b, pow5, 0);
+}
+
+
+/**
+ * @brief Shift a big integer left
+ */
+static void jtok_bigint_shl(jtok_bigint_t *b, uint32_t bits)
+{
+    size_t       limbs = bits / 32;
+    unsigned int rest  = bits % 32;
+    size_t       i;
+
+    if (b->len == 0)
+    {
+        return;
+    }
+    if (rest != 0)
+    {
+        uint32_t carry = 0;
+        for (i = 0; i < b->len; i++)
+        {
+            uint32_t limb = b->limb[i];
+            b->limb[i]    = (limb << rest) | carry;
+            carry         = limb >> (32 - rest);
+        }
+        if (carry != 0 && b->len < JTOK_BIGINT_LIMBS)
+        {
+            b->limb[b->len++] = carry;
+        }
+    }
+    if (limbs != 0)
+    {
+        if (b->len + limbs > JTOK_BIGINT_LIMBS)
+        {
+            limbs = JTOK_BIGINT_LIMBS - b->len;
+        }
+        memmove(&b->limb[limbs], &b->limb[0], b->len * sizeof(*b->limb));
+        memset(&b->limb[0], 0, limbs * sizeof(*b->limb));
+        b->len += limbs;
+    }
+}
+
+
+/**
+ * @brief Compare two big integers
+ *
+ * @return int < 0, 0 or > 0 as a is below, equal to or above b
+ */
+static int jtok_bigint_cmp(const jtok_bigint_t *a, const jtok_bigint_t *b)
+{
+    if (a->len != b->len)
+    {
+        return (a->len < b->len) ? -1 : 1;
+    }
+    for (size_t i = a->len; i-- > 0;)
+    {
+        if (a->limb[i] != b->limb[i])
+        {
+            return (a->limb[i] < b->limb[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+#endif /* #if JTOK_FLOAT */
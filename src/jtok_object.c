@@ -17,85 +17,48 @@
 #include "jtok_primitive.h"
 #include "jtok_string.h"
 #include "jtok_shared.h"
+#include "jtok_index.h"
 
 
-JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
+JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser)
 {
     JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
-
-    int         start  = parser->pos;
-    const char *json   = parser->json;
-    int         len    = parser->json_len;
-    jtok_tkn_t *tokens = parser->tkn_pool;
-
-    if (depth > JTOK_MAX_RECURSE_DEPTH)
-    {
-        status = JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED;
-        return status;
-    }
+    jtok_frame_t *      frame  = &parser->frames[parser->depth - 1];
+    const char *        json   = parser->json;
+    jtok_pos_t          len    = parser->json_len;
 
     enum
     {
         OBJECT_KEY,
+        OBJECT_NEXT_KEY, /* expecting key after a comma */
         OBJECT_COLON,
         OBJECT_VALUE,
         OBJECT_COMMA,
-    } expecting = OBJECT_KEY;
+    };
 
-    if (tokens == NULL) /* Check for caller API error */
-    {
-        return status;
-    }
-    else if (json[parser->pos] != '{')
-    {
-        return JTOK_PARSE_STATUS_NON_OBJECT;
-    }
+    assert(frame->type == JTOK_OBJECT);
 
-    jtok_tkn_t *token = jtok_alloc_token(parser);
-    if (token == NULL)
+    while (status == JTOK_PARSE_STATUS_OK)
     {
-        /*
-         * Do not reset parser->pos because we want
-         * caller to see which token maxed out the
-         * pool
-         */
-        status = JTOK_PARSE_STATUS_NOMEM;
-        return status;
-    }
-
-    /* If the object has a parent key, increase that key's size */
-    token->parent = parser->toksuper;
-
-    /* new superior token becomes the one we JUST processed */
-    parser->toksuper = parser->toknext - 1;
-
-    /* Index of current top level token is the current superior token */
-    /* We need to preserve the index of top level token in the currenet
-     * stack frame because parsing a sub-object changes the value of
-     * parser->toksuper
-     */
-    int object_token_index = parser->toksuper;
-
-    /* end of token will be populated when we find the closing brace */
-    jtok_fill_token(token, JTOK_OBJECT, parser->pos, JTOK_INVALID_ARRAY_INDEX);
-
-    /* go inside the object */
-    parser->pos++;
-
-    /* all objects start with no children (since they can be empty) */
-    parser->last_child = JTOK_NO_CHILD_IDX;
+        /* Step over whitespace runs, a block at a time with the structural
+         * index */
+        jtok_skip_whitespace(parser);
+        if (parser->pos >= len)
+        {
+            /* If we didnt find the } to close current object,
+             * we have partial JSON */
+            return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        }
 
-    for (; parser->pos < len && json[parser->pos] != '\0' &&
-           status == JTOK_PARSE_STATUS_OK;
-         parser->pos++)
-    {
-        switch (json[parser->pos])
+        switch (JTOK_CHAR_CLASS(json[parser->pos]))
         {
-            case '{':
+            case JTOK_CHAR_OBJ_OPEN:
+            case JTOK_CHAR_ARR_OPEN:
             {
-                switch (expecting)
+                switch (frame->expecting)
                 {
                     case OBJECT_KEY:
+                    case OBJECT_NEXT_KEY:
                     {
                         status = JTOK_PARSE_STATUS_OBJ_NOKEY;
                     }
@@ -105,74 +68,24 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                         status = JTOK_PARSE_STATUS_VAL_NO_COLON;
                     }
                     break;
-                    case OBJECT_VALUE: /* Enter and parse the sub-object */
+                    case OBJECT_VALUE:
                     {
-                        /* Index of the key that owns this object */
-                        int key_idx = parser->toksuper;
-
-
-                        status = jtok_parse_object(parser, depth + 1);
-                        if (status == JTOK_PARSE_STATUS_OK)
+                        JTOK_TYPE_t type = JTOK_OBJECT;
+                        if (json[parser->pos] == '[')
                         {
-                            if (key_idx != JTOK_NO_PARENT_IDX)
-                            {
-                                tokens[key_idx].size++;
-                            }
-                            parser->toksuper   = key_idx;
-                            expecting          = OBJECT_COMMA;
-                            parser->last_child = key_idx;
+                            type = JTOK_ARRAY;
                         }
-                    }
-                    break;
-                    case OBJECT_COMMA:
-                    default:
-                    {
-                        status = JTOK_PARSE_STATUS_INVAL;
-                    }
-                    break;
-                }
-            }
-            break;
-            case '[':
-            {
-                switch (expecting)
-                {
-                    case OBJECT_KEY:
-                    {
-                        status = JTOK_PARSE_STATUS_OBJ_NOKEY;
-                    }
-                    break;
-                    case OBJECT_COLON:
-                    {
-                        status = JTOK_PARSE_STATUS_VAL_NO_COLON;
-                    }
-                    break;
-                    case OBJECT_VALUE:
-                    {
-                        /* Index of key that "owns" the array */
-                        int key_idx = parser->toksuper;
-                        status      = jtok_parse_array(parser, depth + 1);
-
+                        parser->toksuper = frame->key;
+                        status           = jtok_push_frame(parser, type);
                         if (status == JTOK_PARSE_STATUS_OK)
                         {
-                            if (key_idx != JTOK_NO_PARENT_IDX)
-                            {
-                                tokens[key_idx].size++;
-                            }
-                            else
-                            {
-                                /* Keys must have a parent token */
-                                status = JTOK_PARSE_STATUS_INVALID_PARENT;
-                            }
-                            parser->last_child = key_idx;
-
-                            expecting = OBJECT_COMMA;
+                            /* The key owns the aggregate value. Account for
+                             * it now, the new frame takes over until it is
+                             * closed */
+                            jtok_token_add_child(parser, frame->key);
+                            frame->expecting = OBJECT_COMMA;
                         }
-                    }
-                    break;
-                    case OBJECT_COMMA:
-                    {
-                        status = JTOK_PARSE_STATUS_INVAL;
+                        return status;
                     }
                     break;
                     default:
@@ -183,22 +96,10 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                 }
             }
             break;
-            case '}':
+            case JTOK_CHAR_OBJ_CLOSE:
             {
-                switch (expecting)
+                switch (frame->expecting)
                 {
-                    /* Technically we should be checking if this is the very
-                     * first token in the object, because
-                     * {"key1" : "value1", "key2" : "value2",} is invalid
-                     * from the trailing comma
-                     * (transition to expecting==key only occurs when finding
-                     * comma or when we START parsing the object)
-                     *
-                     * So in cases where we have transitioned from a comma,
-                     * if we find '}' then it means we have a trailing
-                     * comma inside the object
-                     */
-
                     /********************************
                      * Case where we find end of    *
                      * object instead of key        *
@@ -208,25 +109,6 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                      *           ^ Right here       *
                      *******************************/
                     case OBJECT_KEY:
-                    {
-                        jtok_tkn_t *parent_obj = &tokens[object_token_index];
-                        if (parent_obj->type != JTOK_OBJECT ||
-                            parser->toknext == 0)
-                        {
-                            parser->pos = start;
-                            status      = JTOK_PARSE_STATUS_INVAL;
-                        }
-                        else
-                        {
-                            parent_obj->end  = parser->pos + 1;
-                            parser->toksuper = parent_obj->parent;
-
-                            /* Don't have to update children->sibling link
-                             * because there are no children in the object */
-                        }
-                        return status;
-                    }
-                    break;
 
                     /****************************************************
                      * Case wherein, instead of comma,                  *
@@ -237,39 +119,20 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                      ***************************************************/
                     case OBJECT_COMMA:
                     {
-                        jtok_tkn_t *parent_obj = &tokens[object_token_index];
-                        if (parent_obj->type != JTOK_OBJECT ||
-                            parser->toknext == 0)
-                        {
-                            parser->pos = start;
-                            status      = JTOK_PARSE_STATUS_INVAL;
-                        }
-                        else
-                        {
-                            parent_obj->end = parser->pos + 1;
-
-                            /* Update superior token to the key that owns
-                             * the current object */
-                            parser->toksuper = parent_obj->parent;
-
-                            /* Final item in object has no sibling key */
-                            if (parser->last_child != JTOK_NO_CHILD_IDX)
-                            {
-                                tokens[parser->last_child].sibling =
-                                    JTOK_NO_SIBLING_IDX;
-                            }
-
-                            /* Update last child */
-                            parser->last_child = JTOK_NO_CHILD_IDX;
-                        }
-                        return status;
+                        /* Final item in object already has no sibling key
+                         * so only the object boundary needs closing */
+                        return jtok_pop_frame(parser);
                     }
                     break;
-                    case OBJECT_COLON:
+
+                    /* eg : {\"key1\" : \"value1\", }
+                     *                              ^ trailing comma */
+                    case OBJECT_NEXT_KEY:
                     {
-                        status = JTOK_PARSE_STATUS_KEY_NO_VAL;
+                        status = JTOK_PARSE_STATUS_COMMA_NO_KEY;
                     }
                     break;
+                    case OBJECT_COLON:
                     case OBJECT_VALUE:
                     {
                         status = JTOK_PARSE_STATUS_KEY_NO_VAL;
@@ -283,61 +146,54 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                 }
             }
             break;
-            case '\"':
-            case '\'':
+            case JTOK_CHAR_QUOTE:
             {
-                switch (expecting)
+                switch (frame->expecting)
                 {
                     case OBJECT_KEY:
+                    case OBJECT_NEXT_KEY:
                     {
-                        jtok_tkn_t *parent_obj = &tokens[parser->toksuper];
-                        if (parent_obj->type == JTOK_OBJECT)
+                        jtok_pos_t quote_pos = parser->pos;
+                        parser->toksuper = frame->tkn;
+                        status           = jtok_parse_string(parser);
+                        if (status == JTOK_PARSE_STATUS_OK)
                         {
-                            status = jtok_parse_string(parser);
-                            if (status == JTOK_PARSE_STATUS_OK)
+                            if (parser->pos == quote_pos + 1)
                             {
-                                if (parser->last_child != JTOK_NO_CHILD_IDX)
+                                /* eg {"" : "value"} */
+                                parser->pos = quote_pos;
+                                status      = JTOK_PARSE_STATUS_EMPTY_KEY;
+                            }
+                            else
+                            {
+                                jtok_pos_t key = parser->toklast;
+                                if (key != JTOK_SKIPPED_TOKEN_IDX)
                                 {
-                                    /* Link previous child to current child */
-                                    tokens[parser->last_child].sibling =
-                                        parser->toknext - 1;
+                                    if (frame->last_child != JTOK_NO_CHILD_IDX)
+                                    {
+                                        /* Link previous key to current key */
+                                        jtok_token_link(parser,
+                                                        frame->last_child, key);
+                                    }
+
+                                    /* Update last child and parent size */
+                                    frame->last_child = key;
+                                    jtok_token_add_child(parser, frame->tkn);
                                 }
-
-                                /* Update last child and increase parent size */
-                                parser->last_child = parser->toknext - 1;
-                                parent_obj->size++;
+                                frame->key       = key;
+                                frame->expecting = OBJECT_COLON;
                             }
-                            expecting = OBJECT_COLON;
-                        }
-                        else
-                        {
-                            status = JTOK_PARSE_STATUS_INVALID_PARENT;
                         }
                     }
                     break;
                     case OBJECT_VALUE:
                     {
-                        jtok_tkn_t *key_tkn = &tokens[parser->toksuper];
-                        if (key_tkn->type == JTOK_STRING)
-                        {
-                            if (key_tkn->size != 0)
-                            {
-                                /* an object key can only have 1 value */
-                                status = JTOK_PARSE_STATUS_KEY_MULTIPLE_VAL;
-                            }
-                            else
-                            {
-                                status = jtok_parse_string(parser);
-                                if (status == JTOK_PARSE_STATUS_OK)
-                                {
-                                    key_tkn->size++;
-                                }
-                                expecting = OBJECT_COMMA;
-                            }
-                        }
-                        else
+                        parser->toksuper = frame->key;
+                        status           = jtok_parse_string(parser);
+                        if (status == JTOK_PARSE_STATUS_OK)
                         {
-                            status = JTOK_PARSE_STATUS_INVALID_PARENT;
+                            jtok_token_add_child(parser, frame->key);
+                            frame->expecting = OBJECT_COMMA;
                         }
                     }
                     break;
@@ -359,34 +215,23 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                 }
             }
             break;
-            case '\t':
-            case '\r':
-            case '\n':
-            case ' ':
-                continue; /* skip whitespce */
-            case ':':
+            case JTOK_CHAR_COLON:
             {
-                if (expecting == OBJECT_COLON)
+                if (frame->expecting == OBJECT_COLON)
                 {
-                    expecting = OBJECT_VALUE;
-
-                    /* Superior token becomes the key we just processed */
-                    parser->toksuper = parser->toknext - 1;
+                    frame->expecting = OBJECT_VALUE;
                 }
                 else
                 {
-                    parser->pos = start;
-                    status      = JTOK_PARSE_STATUS_INVAL;
+                    status = JTOK_PARSE_STATUS_INVAL;
                 }
             }
             break;
-            case ',':
+            case JTOK_CHAR_COMMA:
             {
-                if (expecting == OBJECT_COMMA)
+                if (frame->expecting == OBJECT_COMMA)
                 {
-                    expecting              = OBJECT_KEY;
-                    jtok_tkn_t *parent_key = &tokens[parser->toksuper];
-                    parser->toksuper       = parent_key->parent;
+                    frame->expecting = OBJECT_NEXT_KEY;
                 }
                 else
                 {
@@ -394,96 +239,44 @@ JTOK_PARSE_STATUS_t jtok_parse_object(jtok_parser_t *parser, int depth)
                 }
             }
             break;
-            case '+':
-            case '-':
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case 't':
-            case 'f':
-            case 'n':
+            case JTOK_CHAR_SIGN:
+            case JTOK_CHAR_DIGIT:
+            case JTOK_CHAR_LITERAL:
             {
                 /* We must be expecting a value */
-                if (expecting == OBJECT_VALUE)
+                if (frame->expecting == OBJECT_VALUE)
                 {
-                    /* We're at the start of a primitive so validate parent type
-                     */
-                    jtok_tkn_t *parent = &tokens[parser->toksuper];
-                    switch (parent->type)
-                    {
-                        case JTOK_OBJECT:
-                        {
-                            /* primitives cannot be keys (they are not
-                             * quoted)
-                             */
-                            parser->pos = start;
-                            status      = JTOK_PARSE_STATUS_INVAL;
-                        }
-                        break;
-                        case JTOK_STRING:
-                        {
-                            if (parent->size != 0)
-                            {
-                                /* an object key can only have 1 value */
-                                parser->pos = start;
-                                status      = JTOK_PARSE_STATUS_INVAL;
-                            }
-                        }
-                        break;
-                        default:
-                        {
-                            /*
-                             * If we're inside parse_object,
-                             * other types cannot be parent tokens
-                             */
-                            status = JTOK_PARSE_STATUS_INVAL;
-                        }
-                        break;
-                    }
-
+                    parser->toksuper = frame->key;
+                    status           = jtok_parse_primitive(parser);
                     if (status == JTOK_PARSE_STATUS_OK)
                     {
-                        status = jtok_parse_primitive(parser);
-                        if (status == JTOK_PARSE_STATUS_OK)
-                        {
-                            if (parser->toksuper != JTOK_NO_PARENT_IDX)
-                            {
-                                tokens[parser->toksuper].size++;
-                            }
-                            expecting = OBJECT_COMMA;
-                        }
+                        jtok_token_add_child(parser, frame->key);
+                        frame->expecting = OBJECT_COMMA;
                     }
                 }
+                else if (frame->expecting == OBJECT_KEY ||
+                         frame->expecting == OBJECT_NEXT_KEY)
+                {
+                    /* primitives cannot be keys (they are not quoted) */
+                    status = JTOK_PARSE_STATUS_INVAL;
+                }
                 else
                 {
-                    /* move pos to start of the key that's missing the value */
-                    parser->pos = tokens[parser->toksuper].start;
-                    status      = JTOK_PARSE_STATUS_KEY_NO_VAL;
+                    status = JTOK_PARSE_STATUS_KEY_NO_VAL;
                 }
             }
             break;
             default: /* unexpected character */
             {
-                parser->pos = start;
-                status      = JTOK_PARSE_STATUS_INVAL;
+                status = JTOK_PARSE_STATUS_INVAL;
             }
             break;
         } /* end of character switch statement */
-    }
 
-    if (status == JTOK_PARSE_STATUS_OK)
-    {
-        /* If we didnt find the } to close current object, we have partial JSON
-         */
-        parser->pos = start;
-        status      = JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+        if (status == JTOK_PARSE_STATUS_OK)
+        {
+            parser->pos++;
+        }
     }
 
     return status;
@@ -498,9 +291,8 @@ bool jtok_toktokcmp_object(const jtok_tkn_t *obj1, const jtok_tkn_t *obj2)
     assert(pool1->json == obj1->json);
     if (pool1 != obj1)
     {
-        /* Greater than 1 because if it's non-empty, it must AT LEAST
-         * have a key inside it as well as the value for that key */
-        assert(pool1->size > 1);
+        /* The root holds the object being compared so it has a key */
+        assert(pool1->size > 0);
     }
 
     const jtok_tkn_t *const pool2 = obj2->pool;
@@ -509,9 +301,8 @@ bool jtok_toktokcmp_object(const jtok_tkn_t *obj1, const jtok_tkn_t *obj2)
     assert(pool2->json == obj2->json);
     if (pool2 != obj2)
     {
-        /* Greater than 1 because if it's non-empty, it must AT LEAST
-         * have a key inside it as well as the value for that key */
-        assert(pool2->size > 1);
+        /* The root holds the object being compared so it has a key */
+        assert(pool2->size > 0);
     }
 
 
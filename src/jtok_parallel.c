@@ -0,0 +1,639 @@
+/**
+ * @file jtok_parallel.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to parse a single large json document on several
+ * threads by splitting its largest array into slices
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#include <pthread.h>
+#include <string.h>
+
+#include "jtok_shared.h"
+#include "jtok_index.h"
+#include "jtok_object.h"
+#include "jtok_array.h"
+
+#define JTOK_PARALLEL_MAX_SLICES 64 /* max number of threads */
+
+/**
+ * Consecutive elements of the split array, tokenized by one thread
+ */
+typedef struct
+{
+    const char *        json;      /* the json string */
+    jtok_tkn_t *        tkns;      /* the whole token pool */
+    jtok_pos_t          start;     /* first char after the '[' or comma */
+    jtok_pos_t          end;       /* the comma or ']' ending the slice */
+    size_t              base;      /* first token of the slice's pool region */
+    size_t              cap;       /* number of tokens in the region */
+    size_t              dest;      /* final index of the slice's first token */
+    size_t              count;     /* number of tokens used */
+    size_t              written;   /* number of tokens written to the region */
+    size_t              elements;  /* number of array elements */
+    jtok_pos_t          last;      /* region index of the last element */
+    jtok_pos_t          arr;       /* index of the array token */
+    JTOK_TYPE_t         type;      /* type of the elements */
+    unsigned int        max_depth; /* frames left for nested aggregates */
+    bool                first;     /* slice starts right after the '[' */
+    bool                final;     /* slice ends at the ']' */
+    bool                full;      /* the region ran out of tokens */
+    JTOK_PARSE_STATUS_t status;    /* parse status of the slice */
+    jtok_parser_t       saved;     /* parser state when the region ran out */
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1]; /* its frames */
+} jtok_slice_t;
+
+
+static JTOK_PARSE_STATUS_t jtok_parallel_fallback(const char *json,
+                                                  size_t len, jtok_tkn_t *tkns,
+                                                  size_t size, size_t *used);
+static jtok_pos_t jtok_parallel_next(const char *json, jtok_pos_t len,
+                                     jtok_pos_t pos, jtok_block_t *blk);
+static bool       jtok_parallel_find_array(const char *json, jtok_pos_t len,
+                                           jtok_pos_t *open, jtok_pos_t *close);
+static size_t     jtok_parallel_split(const char *json, jtok_pos_t open,
+                                      jtok_pos_t close, size_t n,
+                                      jtok_slice_t *slices);
+static jtok_pos_t jtok_parallel_target(jtok_pos_t open, jtok_pos_t close,
+                                       size_t k, size_t n);
+static void       jtok_parallel_run(void *(*fn)(void *), jtok_slice_t *slices,
+                                    size_t n);
+static void       jtok_parallel_place(jtok_tkn_t *tkns, jtok_slice_t *slices,
+                                      size_t n);
+static void *     jtok_parallel_parse_slice(void *arg);
+static void *     jtok_parallel_resume_slice(void *arg);
+static void *     jtok_parallel_fixup_slice(void *arg);
+static JTOK_PARSE_STATUS_t jtok_parallel_tokenize(jtok_parser_t *parser);
+static void jtok_parallel_finish(jtok_slice_t *slice, jtok_parser_t *parser,
+                                 JTOK_PARSE_STATUS_t status);
+
+
+JTOK_PARSE_STATUS_t jtok_parse_parallel(const char *json, size_t len,
+                                        jtok_tkn_t *tkns, size_t size,
+                                        size_t nthreads, size_t *used)
+{
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    jtok_slice_t        slices[JTOK_PARALLEL_MAX_SLICES];
+    jtok_parser_t       parser;
+    jtok_frame_t *      frame;
+    jtok_pos_t          open  = 0;
+    jtok_pos_t          close = 0;
+    size_t              nslices;
+    size_t              base;
+    size_t              avail;
+    size_t              elements = 0;
+    size_t              k;
+    bool                full = false;
+    JTOK_PARSE_STATUS_t status;
+
+    if (json == NULL || tkns == NULL || nthreads < 2 || len > INT_MAX ||
+        size > INT_MAX ||
+        !jtok_parallel_find_array(json, (jtok_pos_t)len, &open, &close))
+    {
+        return jtok_parallel_fallback(json, len, tkns, size, used);
+    }
+
+    nslices = (size_t)(close - open) / JTOK_PARALLEL_MIN_SLICE;
+    if (nslices > nthreads)
+    {
+        nslices = nthreads;
+    }
+    if (nslices > JTOK_PARALLEL_MAX_SLICES)
+    {
+        nslices = JTOK_PARALLEL_MAX_SLICES;
+    }
+    if (nslices < 2)
+    {
+        return jtok_parallel_fallback(json, len, tkns, size, used);
+    }
+
+    /* Parse everything up to and including the '[' on this thread. The
+     * parser stops with the array frame on top, waiting for more chars */
+    jtok_parser_init(&parser, tkns, size, frames,
+                     sizeof(frames) / sizeof(*frames));
+    status = jtok_parser_feed(&parser, json, (size_t)open + 1);
+    frame  = &parser.frames[parser.depth - 1];
+    if (status != JTOK_PARSE_STATUS_PARTIAL_TOKEN || parser.depth < 2 ||
+        frame->type != JTOK_ARRAY || frame->expecting != ARRAY_START ||
+        tkns[frame->tkn].start != open)
+    {
+        return jtok_parallel_fallback(json, len, tkns, size, used);
+    }
+
+    nslices = jtok_parallel_split(json, open, close, nslices, slices);
+    if (nslices < 2)
+    {
+        return jtok_parallel_fallback(json, len, tkns, size, used);
+    }
+
+    /* Share the free tokens between the slices by their length. A slice
+     * whose region runs out counts the rest of its tokens, and resumes in
+     * its final place once the counts of the slices before it are known */
+    base  = (size_t)parser.toknext;
+    avail = size - base;
+    for (k = 0; k < nslices; k++)
+    {
+        slices[k].json      = json;
+        slices[k].tkns      = tkns;
+        slices[k].base      = base;
+        slices[k].cap       = (size_t)((uint64_t)avail *
+                                       (slices[k].end - slices[k].start + 1) /
+                                       (close - open));
+        slices[k].arr       = frame->tkn;
+        slices[k].max_depth = parser.max_depth - (parser.depth - 1);
+        slices[k].first     = (k == 0);
+        slices[k].final     = (k == nslices - 1);
+        base += slices[k].cap;
+    }
+    jtok_parallel_run(jtok_parallel_parse_slice, slices, nslices);
+
+    base = (size_t)parser.toknext;
+    for (k = 0; k < nslices; k++)
+    {
+        if (slices[k].status != JTOK_PARSE_STATUS_OK ||
+            slices[k].type != slices[0].type || slices[k].count > size - base)
+        {
+            /* Errors are reported exactly as a single-threaded parse would */
+            return jtok_parallel_fallback(json, len, tkns, size, used);
+        }
+        slices[k].dest = base;
+        base += slices[k].count;
+        full = full || slices[k].full;
+    }
+
+    jtok_parallel_place(tkns, slices, nslices);
+    if (full)
+    {
+        jtok_parallel_run(jtok_parallel_resume_slice, slices, nslices);
+        for (k = 0; k < nslices; k++)
+        {
+            if (slices[k].status != JTOK_PARSE_STATUS_OK)
+            {
+                return jtok_parallel_fallback(json, len, tkns, size, used);
+            }
+        }
+    }
+
+    jtok_parallel_run(jtok_parallel_fixup_slice, slices, nslices);
+    for (k = 0; k < nslices; k++)
+    {
+        if (k > 0)
+        {
+            jtok_pos_t prev = (jtok_pos_t)slices[k - 1].dest +
+                              slices[k - 1].last;
+            tkns[prev].sibling = (int)slices[k].dest;
+        }
+        elements += slices[k].elements;
+    }
+
+    /* Resume at the ']' as if the elements had been parsed by this thread */
+    k                     = nslices - 1;
+    tkns[frame->tkn].size = (int)elements;
+    frame->last_child     = (jtok_pos_t)slices[k].dest + slices[k].last;
+    frame->element_type   = slices[0].type;
+    frame->expecting      = ARRAY_COMMA;
+    parser.toknext        = (jtok_pos_t)(slices[k].dest + slices[k].count);
+    parser.toklast        = frame->last_child;
+    parser.pos            = close;
+    status                = jtok_parser_feed(&parser, json, len);
+
+    if ((size_t)parser.toknext < size)
+    {
+        tkns[parser.toknext].type = JTOK_UNASSIGNED_TOKEN;
+    }
+    if (used != NULL)
+    {
+        *used = (size_t)parser.toknext;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Parse a json string on the calling thread
+ */
+static JTOK_PARSE_STATUS_t jtok_parallel_fallback(const char *json,
+                                                  size_t len, jtok_tkn_t *tkns,
+                                                  size_t size, size_t *used)
+{
+    size_t              ntkns  = 0;
+    JTOK_PARSE_STATUS_t status = jtok_parse_n_used(json, len, tkns, size,
+                                                   &ntkns);
+    if (tkns != NULL && ntkns < size)
+    {
+        tkns[ntkns].type = JTOK_UNASSIGNED_TOKEN;
+    }
+    if (used != NULL)
+    {
+        *used = ntkns;
+    }
+    return status;
+}
+
+
+/**
+ * @brief Find the next structural char that is not inside a string
+ *
+ * @param json the json string
+ * @param len number of chars to look at
+ * @param pos index to start looking at, outside of any string
+ * @param blk block index cache
+ * @return jtok_pos_t index of the char, len if there is none
+ */
+static jtok_pos_t jtok_parallel_next(const char *json, jtok_pos_t len,
+                                     jtok_pos_t pos, jtok_block_t *blk)
+{
+    char quote = '\0';
+    while ((pos = jtok_index_next_special(json, len, pos, blk)) < len)
+    {
+        char c = json[pos];
+        if (quote != '\0')
+        {
+            if (c == '\\')
+            {
+                /* Step over the escaped char, it may be a quote */
+                pos += 2;
+                continue;
+            }
+            else if (c == quote)
+            {
+                quote = '\0';
+            }
+        }
+        else if (c == '\"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if (c != '\\')
+        {
+            return pos;
+        }
+        pos++;
+    }
+    return len;
+}
+
+
+/**
+ * @brief Find the largest array directly inside the top-level object
+ *
+ * @param json the json string
+ * @param len number of chars in the json string
+ * @param open index of the '[' of the array
+ * @param close index of the ']' of the array
+ * @return true if there is an array
+ *
+ * @note Only the key, the colon and the first char of each member's value
+ * are looked at one at a time. The rest of the member is matched a block at
+ * a time
+ */
+static bool jtok_parallel_find_array(const char *json, jtok_pos_t len,
+                                     jtok_pos_t *open, jtok_pos_t *close)
+{
+    jtok_block_t blk;
+    jtok_pos_t   pos;
+    jtok_pos_t   best = 0;
+
+    blk.base = JTOK_INVALID_ARRAY_INDEX;
+    pos      = jtok_parallel_next(json, len, 0, &blk);
+    if (pos >= len || json[pos] != '{')
+    {
+        return false;
+    }
+
+    /* pos is at the '{' or the comma before each member */
+    while (pos < len && json[pos] != '}')
+    {
+        jtok_pos_t end   = jtok_index_match(json, len, pos + 1, pos + 1);
+        jtok_pos_t colon = jtok_parallel_next(json, len, pos + 1, &blk);
+        jtok_pos_t value = len;
+        if (colon < end && json[colon] == ':')
+        {
+            value = jtok_parallel_next(json, len, colon + 1, &blk);
+        }
+        if (value < end && json[value] == '[')
+        {
+            jtok_pos_t last = end - 1;
+            while (JTOK_CHAR_CLASS(json[last]) == JTOK_CHAR_WHITESPACE)
+            {
+                last--;
+            }
+            if (json[last] == ']' && last - value > best)
+            {
+                best   = last - value;
+                *open  = value;
+                *close = last;
+            }
+        }
+        pos = end;
+    }
+    return best > 0;
+}
+
+
+/**
+ * @brief Split an array into slices of about the same length at commas
+ * between its elements
+ *
+ * @param json the json string
+ * @param open index of the '[' of the array
+ * @param close index of the ']' of the array
+ * @param n number of slices wanted
+ * @param slices the slices
+ * @return size_t number of slices, fewer than n if there are not enough
+ * elements
+ */
+static size_t jtok_parallel_split(const char *json, jtok_pos_t open,
+                                  jtok_pos_t close, size_t n,
+                                  jtok_slice_t *slices)
+{
+    jtok_pos_t start = open + 1;
+    size_t     count = 0;
+    size_t     k;
+
+    for (k = 1; k < n; k++)
+    {
+        jtok_pos_t target = jtok_parallel_target(open, close, k, n);
+        jtok_pos_t comma;
+        if (target < start)
+        {
+            continue;
+        }
+
+        comma = jtok_index_match(json, close, start, target);
+        if (comma >= close || json[comma] != ',')
+        {
+            break;
+        }
+        slices[count].start = start;
+        slices[count].end   = comma;
+        count++;
+        start = comma + 1;
+    }
+
+    slices[count].start = start;
+    slices[count].end   = close;
+    return count + 1;
+}
+
+
+/**
+ * @brief Index the k-th of n slices of an array should end at or after
+ */
+static jtok_pos_t jtok_parallel_target(jtok_pos_t open, jtok_pos_t close,
+                                       size_t k, size_t n)
+{
+    return open + (jtok_pos_t)((size_t)(close - open) * k / n);
+}
+
+
+/**
+ * @brief Run a function on every slice, one thread per slice. The calling
+ * thread takes the first slice and any slice whose thread failed to start.
+ */
+static void jtok_parallel_run(void *(*fn)(void *), jtok_slice_t *slices,
+                              size_t n)
+{
+    pthread_t threads[JTOK_PARALLEL_MAX_SLICES];
+    bool      started[JTOK_PARALLEL_MAX_SLICES];
+    size_t    k;
+
+    for (k = 1; k < n; k++)
+    {
+        started[k] = (pthread_create(&threads[k], NULL, fn, &slices[k]) == 0);
+    }
+    fn(&slices[0]);
+    for (k = 1; k < n; k++)
+    {
+        if (started[k])
+        {
+            pthread_join(threads[k], NULL);
+        }
+        else
+        {
+            fn(&slices[k]);
+        }
+    }
+}
+
+
+/**
+ * @brief Move the tokens each slice wrote to its final place. Slices that
+ * move up go last to first, then slices that move down go first to last, so
+ * no tokens are overwritten before they have moved
+ *
+ * @param tkns the whole token pool
+ * @param slices the slices
+ * @param n number of slices
+ */
+static void jtok_parallel_place(jtok_tkn_t *tkns, jtok_slice_t *slices,
+                                size_t n)
+{
+    size_t k;
+    for (k = n; k-- > 0;)
+    {
+        if (slices[k].dest > slices[k].base)
+        {
+            memmove(&tkns[slices[k].dest], &tkns[slices[k].base],
+                    slices[k].written * sizeof(*tkns));
+        }
+    }
+    for (k = 0; k < n; k++)
+    {
+        if (slices[k].dest < slices[k].base)
+        {
+            memmove(&tkns[slices[k].dest], &tkns[slices[k].base],
+                    slices[k].written * sizeof(*tkns));
+        }
+    }
+}
+
+
+/**
+ * @brief Tokenize the elements of a slice into its region of the pool
+ *
+ * @param arg the slice
+ * @return void* NULL
+ *
+ * @note The array token lives outside the region. The slice's frame refers
+ * to it as a skipped token so the token helpers leave it alone, and the
+ * parent of each element is patched when the slices are stitched
+ */
+static void *jtok_parallel_parse_slice(void *arg)
+{
+    jtok_slice_t *      slice = arg;
+    jtok_frame_t        frames[JTOK_MAX_RECURSE_DEPTH + 1];
+    jtok_parser_t       parser;
+    JTOK_PARSE_STATUS_t status;
+    unsigned int        max_depth = slice->max_depth;
+
+    if (max_depth > sizeof(frames) / sizeof(*frames))
+    {
+        max_depth = sizeof(frames) / sizeof(*frames);
+    }
+
+    /* The slice ends after its comma or ']' so the last element is
+     * terminated the same way it is in the whole document */
+    parser = jtok_new_parser(slice->json, (size_t)slice->end + 1,
+                             &slice->tkns[slice->base], slice->cap, frames,
+                             max_depth);
+    parser.pos             = slice->start;
+    parser.depth           = 1;
+    frames[0].tkn          = JTOK_SKIPPED_TOKEN_IDX;
+    frames[0].key          = JTOK_NO_CHILD_IDX;
+    frames[0].last_child   = JTOK_NO_CHILD_IDX;
+    frames[0].expecting    = slice->first ? ARRAY_START : ARRAY_VALUE;
+    frames[0].type         = JTOK_ARRAY;
+    frames[0].element_type = JTOK_UNASSIGNED_TOKEN;
+    frames[0].sel_paths    = 0;
+    frames[0].sel_all      = true;
+
+    status         = jtok_parallel_tokenize(&parser);
+    slice->full    = (status == JTOK_PARSE_STATUS_NOMEM);
+    slice->written = (size_t)parser.toknext;
+    if (slice->full)
+    {
+        /* The parser stopped in front of the token that did not fit. Keep
+         * its state to resume there, then count the rest of the tokens */
+        slice->saved = parser;
+        memcpy(slice->frames, frames, parser.depth * sizeof(*frames));
+        parser.output    = JTOK_OUTPUT_COUNT;
+        parser.tkn_pool  = NULL;
+        parser.pool_size = JTOK_POS_MAX;
+        status           = jtok_parallel_tokenize(&parser);
+    }
+    jtok_parallel_finish(slice, &parser, status);
+    return NULL;
+}
+
+
+/**
+ * @brief Tokenize the rest of a slice whose region ran out, in the slice's
+ * final place in the pool
+ *
+ * @param arg the slice
+ * @return void* NULL
+ */
+static void *jtok_parallel_resume_slice(void *arg)
+{
+    jtok_slice_t *slice = arg;
+    jtok_parser_t parser;
+
+    if (slice->full)
+    {
+        parser           = slice->saved;
+        parser.frames    = slice->frames;
+        parser.tkn_pool  = &slice->tkns[slice->dest];
+        parser.pool_size = (jtok_pos_t)slice->count;
+        jtok_index_reset(&parser);
+        jtok_parallel_finish(slice, &parser, jtok_parallel_tokenize(&parser));
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Parse until the frame of the slice is closed or the slice ends
+ */
+static JTOK_PARSE_STATUS_t jtok_parallel_tokenize(jtok_parser_t *parser)
+{
+    JTOK_PARSE_STATUS_t status = JTOK_PARSE_STATUS_OK;
+    while (status == JTOK_PARSE_STATUS_OK && parser->depth > 0)
+    {
+        if (parser->frames[parser->depth - 1].type == JTOK_OBJECT)
+        {
+            status = jtok_parse_object(parser);
+        }
+        else
+        {
+            status = jtok_parse_array(parser);
+        }
+    }
+    return status;
+}
+
+
+/**
+ * @brief Check that a slice was parsed to its end like the whole document
+ * would be, and record its tokens
+ *
+ * @param slice the slice
+ * @param parser the parser of the slice
+ * @param status status the parser stopped with
+ */
+static void jtok_parallel_finish(jtok_slice_t *slice, jtok_parser_t *parser,
+                                 JTOK_PARSE_STATUS_t status)
+{
+    const jtok_frame_t *frame = &parser->frames[0];
+
+    if (slice->final)
+    {
+        /* The ']' closed the slice's frame */
+        slice->status = (status == JTOK_PARSE_STATUS_OK && parser->depth == 0)
+                            ? JTOK_PARSE_STATUS_OK
+                            : JTOK_PARSE_STATUS_INVAL;
+    }
+    else
+    {
+        /* Ran out of chars right after the comma */
+        slice->status = (status == JTOK_PARSE_STATUS_PARTIAL_TOKEN &&
+                         parser->depth == 1 &&
+                         frame->expecting == ARRAY_VALUE)
+                            ? JTOK_PARSE_STATUS_OK
+                            : JTOK_PARSE_STATUS_INVAL;
+    }
+
+    if (parser->pos != slice->end + 1 ||
+        frame->last_child == JTOK_NO_CHILD_IDX)
+    {
+        slice->status = JTOK_PARSE_STATUS_INVAL;
+    }
+    slice->count = (size_t)parser->toknext;
+    slice->last  = frame->last_child;
+    slice->type  = frame->element_type;
+}
+
+
+/**
+ * @brief Rebase the indices of a slice's tokens onto their final position
+ *
+ * @param arg the slice
+ * @return void* NULL
+ */
+static void *jtok_parallel_fixup_slice(void *arg)
+{
+    jtok_slice_t *slice = arg;
+    jtok_tkn_t *  tkn   = &slice->tkns[slice->dest];
+    size_t        i;
+
+    slice->elements = 0;
+    for (i = 0; i < slice->count; i++, tkn++)
+    {
+        tkn->pool = slice->tkns;
+        if (tkn->parent == JTOK_SKIPPED_TOKEN_IDX)
+        {
+            tkn->parent = (int)slice->arr;
+            slice->elements++;
+        }
+        else
+        {
+            tkn->parent += (int)slice->dest;
+        }
+
+        if (tkn->sibling != JTOK_NO_SIBLING_IDX)
+        {
+            tkn->sibling += (int)slice->dest;
+        }
+    }
+    return NULL;
+}
+
+#endif /* #if JTOK_THREADS */
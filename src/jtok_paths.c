@@ -0,0 +1,132 @@
+/**
+ * @file jtok_paths.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to project a parse onto a set of key paths so only
+ * the tokens on those paths use the token pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "jtok_paths.h"
+#include "jtok_shared.h"
+
+
+static const char *jtok_path_segment(const char *path, unsigned int i,
+                                     size_t *seglen);
+
+
+bool jtok_paths_select(jtok_parser_t *parser, jtok_pos_t start,
+                       jtok_pos_t end)
+{
+    bool   keep = false;
+    size_t p;
+    if (parser->depth == 0)
+    {
+        /* The top-level object is an ancestor of every path */
+        keep              = true;
+        parser->sel_paths = 0;
+        parser->sel_all   = false;
+        for (p = 0; p < parser->npaths; p++)
+        {
+            if (parser->paths[p][0] == '\0')
+            {
+                parser->sel_all = true;
+            }
+            else
+            {
+                parser->sel_paths |= (uint32_t)1 << p;
+            }
+        }
+    }
+    else
+    {
+        jtok_frame_t *frame = &parser->frames[parser->depth - 1];
+        if (frame->type == JTOK_ARRAY)
+        {
+            /* Elements are only kept as part of a kept subtree */
+            keep              = frame->sel_all;
+            parser->sel_paths = 0;
+            parser->sel_all   = frame->sel_all;
+        }
+        else if (parser->toksuper == frame->tkn)
+        {
+            /* A key. Match it against the next segment of each path that
+             * matched every key above it */
+            size_t keylen     = (size_t)(end - start);
+            parser->sel_paths = 0;
+            parser->sel_all   = frame->sel_all;
+            for (p = 0; p < parser->npaths; p++)
+            {
+                const char *seg;
+                size_t      seglen;
+                if ((frame->sel_paths & ((uint32_t)1 << p)) == 0)
+                {
+                    continue;
+                }
+
+                seg = jtok_path_segment(parser->paths[p], parser->depth - 1,
+                                        &seglen);
+                if (seg != NULL && seglen == keylen &&
+                    memcmp(seg, &parser->json[start], keylen) == 0)
+                {
+                    if (seg[seglen] == '\0')
+                    {
+                        /* Last segment, the value is kept whole */
+                        parser->sel_all = true;
+                    }
+                    else
+                    {
+                        parser->sel_paths |= (uint32_t)1 << p;
+                    }
+                }
+            }
+            keep = parser->sel_all || parser->sel_paths != 0;
+        }
+        else
+        {
+            /* A value inherits the selection of its key */
+            keep = (frame->key != JTOK_SKIPPED_TOKEN_IDX);
+        }
+    }
+    return keep;
+}
+
+
+/**
+ * @brief Find a segment of a path
+ *
+ * @param path the path, eg "/header/id"
+ * @param i index of the segment, 0 for "header"
+ * @param seglen length of the segment
+ * @return const char* start of the segment or NULL if the path is shorter
+ */
+static const char *jtok_path_segment(const char *path, unsigned int i,
+                                     size_t *seglen)
+{
+    const char *seg = NULL;
+    if (path[0] == '/')
+    {
+        seg = &path[1];
+        while (i > 0 && seg != NULL)
+        {
+            seg = strchr(seg, '/');
+            if (seg != NULL)
+            {
+                seg++;
+            }
+            i--;
+        }
+    }
+
+    if (seg != NULL)
+    {
+        *seglen = strcspn(seg, "/");
+    }
+    return seg;
+}
@@ -9,22 +9,25 @@
  *
  */
 
-#include <ctype.h>
 #include <string.h>
-#include <stdlib.h>
-#include <float.h>
 
 
+#include "jtok_number.h"
 #include "jtok_primitive.h"
 #include "jtok_shared.h"
+#include "jtok_swar.h"
+
+
+static int  jtok_match_literal(const char *js, jtok_pos_t len,
+                               jtok_pos_t start, JTOK_SUBTYPE_t *subtype);
+static bool jtok_subtype_is_number(JTOK_SUBTYPE_t subtype);
 
 
 JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
 {
-    jtok_tkn_t *token;
-    int         start = parser->pos;
+    jtok_pos_t  start = parser->pos;
     const char *js    = (const char *)parser->json;
-    int         len   = parser->json_len;
+    jtok_pos_t  len   = parser->json_len;
 
     enum
     {
@@ -33,26 +36,18 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
         ERROR
     } primitive_type = ERROR;
 
-    bool exponent             = false;
-    bool found_exponent_power = false;
-    bool decimal              = false;
-    bool found_decimal_places = false;
+    JTOK_SUBTYPE_t subtype              = JTOK_SUBTYPE_NONE;
+    bool           exponent             = false;
+    bool           found_exponent_power = false;
+    bool           decimal              = false;
+    bool           found_decimal_places = false;
+    jtok_pos_t     tkn;
 
-    for (start = parser->pos; parser->pos < len && js[parser->pos] != '\0';
-         parser->pos++)
+    for (start = parser->pos; parser->pos < len; parser->pos++)
     {
-        switch (js[parser->pos])
+        switch (JTOK_CHAR_CLASS(js[parser->pos]))
         {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
+            case JTOK_CHAR_DIGIT:
             {
                 if (parser->pos == start)
                 {
@@ -80,10 +75,13 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                         }
                     }
                 }
+
+                /* The rest of the run of digits changes none of the above */
+                parser->pos = jtok_swar_skip_digits(js, len, parser->pos + 1);
+                parser->pos--;
             }
             break;
-            case '+':
-            case '-':
+            case JTOK_CHAR_SIGN:
                 /* signs must come at beginning, or as an exponent */
                 if (start == parser->pos)
                 {
@@ -99,7 +97,7 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                     return JTOK_PARSE_STATUS_INVALID_PRIMITIVE;
                 }
                 break;
-            case '.': /* decimal */
+            case JTOK_CHAR_DOT: /* decimal */
             {
                 if (parser->pos == start)
                 {
@@ -138,8 +136,7 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                 }
             }
             break;
-            case 'e':
-            case 'E':
+            case JTOK_CHAR_EXPONENT:
             {
                 if (start == parser->pos)
                 {
@@ -152,7 +149,8 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                     if (primitive_type == NUMBER)
                     {
                         /* previous char has to be a digit eg: 10e9 */
-                        if (isdigit((int)js[parser->pos - 1]))
+                        if (JTOK_CHAR_CLASS(js[parser->pos - 1]) ==
+                            JTOK_CHAR_DIGIT)
                         {
                             exponent             = true;
                             found_exponent_power = false;
@@ -171,13 +169,10 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                 }
             }
             break;
-            case '\t':
-            case '\r':
-            case '\n':
-            case ' ':
-            case ',':
-            case ']':
-            case '}':
+            case JTOK_CHAR_WHITESPACE:
+            case JTOK_CHAR_COMMA:
+            case JTOK_CHAR_ARR_CLOSE:
+            case JTOK_CHAR_OBJ_CLOSE:
             {
                 char last = js[parser->pos - 1];
                 if (exponent)
@@ -195,15 +190,28 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
                     return JTOK_PARSE_STATUS_INVALID_PRIMITIVE;
                 }
 
-                token = jtok_alloc_token(parser);
-                if (token == NULL) /* not enough tokens provided by caller */
+                tkn = jtok_new_token(parser, JTOK_PRIMITIVE, start,
+                                     parser->pos);
+                if (tkn == JTOK_INVALID_ARRAY_INDEX)
                 {
+                    /* not enough tokens provided by caller */
                     parser->pos = start;
                     return JTOK_PARSE_STATUS_NOMEM;
                 }
-                jtok_fill_token(token, JTOK_PRIMITIVE, start, parser->pos);
 
-                token->parent = parser->toksuper;
+                if (primitive_type == NUMBER)
+                {
+                    subtype = JTOK_SUBTYPE_INTEGER;
+                    if (exponent)
+                    {
+                        subtype = JTOK_SUBTYPE_EXPONENT;
+                    }
+                    else if (decimal)
+                    {
+                        subtype = JTOK_SUBTYPE_DECIMAL;
+                    }
+                }
+                jtok_token_set_subtype(parser, tkn, subtype);
 
                 /* Go back 1 spot so when we return from current function, the
                  * calling context can look at the current character
@@ -220,35 +228,27 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
             {
                 if (parser->pos == start)
                 {
-                    if (0 == strncmp(&js[start], "true", strlen("true")))
-                    {
-                        /* subtract 1 so we don't end up at character
-                                  AFTER the final char in token */
-                        parser->pos += strlen("true") - 1;
-                        break;
-                    }
-                    else if (0 == strncmp(&js[start], "false", strlen("false")))
-                    {
-                        /* subtract 1 so we don't end up at character
-                                  AFTER the final char in token */
-                        parser->pos += strlen("false") - 1;
-                        break;
-                    }
-                    else if (0 == strncmp(&js[start], "null", strlen("null")))
+                    int literal_len = jtok_match_literal(js, len, start,
+                                                         &subtype);
+                    if (literal_len > 0)
                     {
                         /* subtract 1 so we don't end up at character
                                   AFTER the final char in token */
-                        parser->pos += strlen("null") - 1;
+                        parser->pos += literal_len - 1;
                         break;
                     }
-                    else
+
+                    parser->pos = start;
+                    if (literal_len < 0)
                     {
-                        parser->pos = start;
-                        return JTOK_PARSE_STATUS_INVALID_PRIMITIVE;
+                        /* json ends part way through eg: "tru" */
+                        return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
                     }
+                    return JTOK_PARSE_STATUS_INVALID_PRIMITIVE;
                 }
+                /* eg: {"key" : 12true} */
                 parser->pos = start;
-                return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
+                return JTOK_PARSE_STATUS_INVALID_PRIMITIVE;
             }
             break;
         }
@@ -256,76 +256,82 @@ JTOK_PARSE_STATUS_t jtok_parse_primitive(jtok_parser_t *parser)
 
     /* We didn't reach a terminating character
      * so the json we recieved was incomplete */
+    parser->pos = start;
     return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
 }
 
 
 bool jtok_toktokcmp_primitive(const jtok_tkn_t *tkn1, const jtok_tkn_t *tkn2)
 {
-    /** @todo really not proud of this function. SUPER inefficient
-     *  But it works for now. Really we should be storing some sort of
-     * "value subtype" as part of the parsing process and checking that here
-     *
-     * Currently we're pretty much re-parsing each token to determine a subtype
-     */
-
-    bool           is_equal = false;
-    uint_least16_t len1     = jtok_toklen(tkn1);
-    uint_least16_t len2     = jtok_toklen(tkn2);
-    uint_least16_t min_len  = len1;
-    if (min_len > len2)
+    bool is_equal = false;
+    if (jtok_subtype_is_number(tkn1->subtype) &&
+        jtok_subtype_is_number(tkn2->subtype))
     {
-        min_len = len2;
+        /* Digit-wise, so 1, 1.0 and 10e-1 are equal */
+        is_equal = jtok_number_eq(&tkn1->json[tkn1->start],
+                                  tkn1->end - tkn1->start,
+                                  &tkn2->json[tkn2->start],
+                                  tkn2->end - tkn2->start);
     }
-
-
-    const char *start1 = &tkn1->json[tkn1->start];
-    const char *start2 = &tkn2->json[tkn2->start];
-
-    if (0 == strncmp("true", start1, min_len) &&
-        0 == strncmp("true", start2, min_len))
-    {
-        is_equal = true;
-    }
-    else if (0 == strncmp("false", start1, min_len) &&
-             0 == strncmp("false", start2, min_len))
-    {
-        is_equal = true;
-    }
-    else if (0 == strncmp("null", start1, min_len) &&
-             0 == strncmp("null", start2, min_len))
+    else if (tkn1->subtype != JTOK_SUBTYPE_NONE)
     {
-        is_equal = true;
+        /* true, false and null only equal themselves */
+        is_equal = (tkn1->subtype == tkn2->subtype);
     }
-    else
-    {
-        /* Token isn't 'true', 'false', or 'null', need to parse it as a number
-         *
-         * Again, since we don't store the subtypes, we have to assume
-         * its a real number and do all the operations with ungodly
-         * floating precision arithmetic
-         */
-        const char *end1 = &tkn1->json[tkn1->end];
-        const char *end2 = &tkn2->json[tkn2->end];
+    return is_equal;
+}
 
-        float val1;
-        float val2;
-        char *endptr1 = (char *)start1;
-        char *endptr2 = (char *)start2;
 
-        val1 = strtof(start1, &endptr1);
-        val2 = strtof(start2, &endptr2);
-        if (endptr2 == end2) /* if first tkn was parsed correctly */
+/**
+ * @brief Match the literals true, false and null without reading past the
+ * end of the json string
+ *
+ * @param js the json string
+ * @param len length of the json string
+ * @param start index of the first char of the literal
+ * @param subtype set to the subtype of the matched literal
+ * @return int length of the matched literal, 0 if no literal matches, -1 if
+ * the json string ends part way through a literal
+ */
+static int jtok_match_literal(const char *js, jtok_pos_t len,
+                              jtok_pos_t start, JTOK_SUBTYPE_t *subtype)
+{
+    static const struct
+    {
+        const char *   str;
+        JTOK_SUBTYPE_t subtype;
+    } literals[] = {
+        {"true", JTOK_SUBTYPE_TRUE},
+        {"false", JTOK_SUBTYPE_FALSE},
+        {"null", JTOK_SUBTYPE_NULL},
+    };
+    size_t     i;
+    jtok_pos_t avail = len - start;
+    for (i = 0; i < sizeof(literals) / sizeof(*literals); i++)
+    {
+        int literal_len = (int)strlen(literals[i].str);
+        if (avail >= literal_len)
         {
-            if (endptr1 == end1) /* if second tkn was parsed correctly */
+            if (0 == memcmp(&js[start], literals[i].str, literal_len))
             {
-                if ((val1 - val2) < FLT_EPSILON)
-                {
-                    is_equal = true;
-                }
+                *subtype = literals[i].subtype;
+                return literal_len;
             }
         }
+        else if (0 == memcmp(&js[start], literals[i].str, avail))
+        {
+            return -1;
+        }
     }
+    return 0;
+}
 
-    return is_equal;
-}
\ No newline at end of file
+
+/**
+ * @brief Check if a primitive subtype is a number
+ */
+static bool jtok_subtype_is_number(JTOK_SUBTYPE_t subtype)
+{
+    return subtype == JTOK_SUBTYPE_INTEGER || subtype == JTOK_SUBTYPE_DECIMAL ||
+           subtype == JTOK_SUBTYPE_EXPONENT;
+}
@@ -11,21 +11,78 @@
 
 #include <stdint.h>
 #include <string.h>
-#include <ctype.h>
 #include <stdlib.h>
 #include <limits.h>
 
 #include "jtok_shared.h"
+#include "jtok_index.h"
+#include "jtok_paths.h"
+
+
+static jtok_idx_t jtok_ctkn_idx(jtok_pos_t idx);
+static jtok_soa_idx_t jtok_soa_idx(jtok_pos_t idx);
+static jtok_pos_t jtok_tape_new_entry(jtok_parser_t *parser, JTOK_TYPE_t type,
+                                      jtok_pos_t start, jtok_pos_t end);
+static void       jtok_tape_end_entry(jtok_parser_t *parser, jtok_pos_t tkn,
+                                      jtok_pos_t end);
+
+
+/* Chars that are not listed are JTOK_CHAR_OTHER */
+const uint8_t jtok_char_table[256] = {
+    [' ']  = JTOK_CHAR_WHITESPACE,
+    ['\t'] = JTOK_CHAR_WHITESPACE,
+    ['\r'] = JTOK_CHAR_WHITESPACE,
+    ['\n'] = JTOK_CHAR_WHITESPACE,
+    ['{']  = JTOK_CHAR_OBJ_OPEN,
+    ['}']  = JTOK_CHAR_OBJ_CLOSE,
+    ['[']  = JTOK_CHAR_ARR_OPEN,
+    [']']  = JTOK_CHAR_ARR_CLOSE,
+    [':']  = JTOK_CHAR_COLON,
+    [',']  = JTOK_CHAR_COMMA,
+    ['\"'] = JTOK_CHAR_QUOTE | JTOK_CHAR_ESCAPE,
+    ['\''] = JTOK_CHAR_QUOTE,
+    ['\\'] = JTOK_CHAR_BACKSLASH | JTOK_CHAR_ESCAPE,
+    ['/']  = JTOK_CHAR_ESCAPE,
+    ['0']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['1']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['2']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['3']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['4']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['5']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['6']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['7']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['8']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['9']  = JTOK_CHAR_DIGIT | JTOK_CHAR_HEX,
+    ['+']  = JTOK_CHAR_SIGN,
+    ['-']  = JTOK_CHAR_SIGN,
+    ['.']  = JTOK_CHAR_DOT,
+    ['e']  = JTOK_CHAR_EXPONENT | JTOK_CHAR_HEX,
+    ['E']  = JTOK_CHAR_EXPONENT | JTOK_CHAR_HEX,
+    ['t']  = JTOK_CHAR_LITERAL | JTOK_CHAR_ESCAPE,
+    ['f']  = JTOK_CHAR_LITERAL | JTOK_CHAR_ESCAPE | JTOK_CHAR_HEX,
+    ['n']  = JTOK_CHAR_LITERAL | JTOK_CHAR_ESCAPE,
+    ['a']  = JTOK_CHAR_HEX,
+    ['b']  = JTOK_CHAR_HEX | JTOK_CHAR_ESCAPE,
+    ['c']  = JTOK_CHAR_HEX,
+    ['d']  = JTOK_CHAR_HEX,
+    ['r']  = JTOK_CHAR_ESCAPE,
+    ['A']  = JTOK_CHAR_HEX,
+    ['B']  = JTOK_CHAR_HEX,
+    ['C']  = JTOK_CHAR_HEX,
+    ['D']  = JTOK_CHAR_HEX,
+    ['F']  = JTOK_CHAR_HEX,
+};
 
 
 int jtok_fill_token(jtok_tkn_t *token, JTOK_TYPE_t type, int start, int end)
 {
     if (token != NULL)
     {
-        token->type  = type;
-        token->start = start;
-        token->end   = end;
-        token->size  = 0;
+        token->type    = type;
+        token->subtype = JTOK_SUBTYPE_NONE;
+        token->start   = start;
+        token->end     = end;
+        token->size    = 0;
         return 0;
     }
     else
@@ -38,7 +95,7 @@ int jtok_fill_token(jtok_tkn_t *token, JTOK_TYPE_t type, int start, int end)
 jtok_tkn_t *jtok_alloc_token(jtok_parser_t *parser)
 {
     jtok_tkn_t *tok;
-    if (parser->toknext >= (int)parser->pool_size)
+    if (parser->toknext >= parser->pool_size)
     {
         return NULL;
     }
@@ -51,3 +108,370 @@ jtok_tkn_t *jtok_alloc_token(jtok_parser_t *parser)
     tok->sibling          = JTOK_NO_SIBLING_IDX;
     return tok;
 }
+
+
+jtok_pos_t jtok_new_token(jtok_parser_t *parser, JTOK_TYPE_t type,
+                          jtok_pos_t start, jtok_pos_t end)
+{
+    jtok_pos_t tkn = JTOK_INVALID_ARRAY_INDEX;
+    if (parser->paths != NULL && !jtok_paths_select(parser, start, end))
+    {
+        /* Off the projected paths. Validated by the caller but not kept */
+        tkn = JTOK_SKIPPED_TOKEN_IDX;
+    }
+    else if (parser->toknext < parser->pool_size)
+    {
+        switch (parser->output)
+        {
+            case JTOK_OUTPUT_TOKENS:
+            {
+                jtok_tkn_t *token = jtok_alloc_token(parser);
+                jtok_fill_token(token, type, (int)start, (int)end);
+                token->parent = (int)parser->toksuper;
+                tkn           = parser->toknext - 1;
+            }
+            break;
+            case JTOK_OUTPUT_COMPACT:
+            {
+                jtok_ctkn_t *ctkn = &parser->ctkn_pool[parser->toknext];
+                ctkn->start       = (jtok_off_t)start;
+                ctkn->end         = (jtok_off_t)end;
+                ctkn->size        = 0;
+                ctkn->parent      = jtok_ctkn_idx(parser->toksuper);
+                ctkn->sibling     = JTOK_CTKN_NONE;
+                ctkn->type        = (uint8_t)type;
+                ctkn->subtype     = JTOK_SUBTYPE_NONE;
+                tkn               = parser->toknext++;
+            }
+            break;
+            case JTOK_OUTPUT_SOA:
+            {
+                jtok_soa_t *soa = parser->soa;
+                jtok_pos_t  i   = parser->toknext;
+                soa->type[i]    = (uint8_t)type;
+                soa->start[i]   = (jtok_off_t)start;
+                soa->end[i]     = (jtok_off_t)end;
+                soa->size[i]    = 0;
+                soa->parent[i]  = jtok_soa_idx(parser->toksuper);
+                soa->sibling[i] = JTOK_SOA_NONE;
+                tkn             = parser->toknext++;
+            }
+            break;
+            case JTOK_OUTPUT_TAPE:
+            {
+                tkn = jtok_tape_new_entry(parser, type, start, end);
+                if (tkn != JTOK_INVALID_ARRAY_INDEX)
+                {
+                    parser->toknext++;
+                }
+            }
+            break;
+            default: /* Counting only */
+            {
+                tkn = parser->toknext++;
+            }
+            break;
+        }
+    }
+
+    if (tkn != JTOK_INVALID_ARRAY_INDEX)
+    {
+        parser->toklast = tkn;
+    }
+    return tkn;
+}
+
+
+void jtok_token_set_end(jtok_parser_t *parser, jtok_pos_t tkn, jtok_pos_t end)
+{
+    if (tkn == JTOK_SKIPPED_TOKEN_IDX)
+    {
+        return;
+    }
+
+    switch (parser->output)
+    {
+        case JTOK_OUTPUT_TOKENS:
+        {
+            parser->tkn_pool[tkn].end = (int)end;
+        }
+        break;
+        case JTOK_OUTPUT_COMPACT:
+        {
+            parser->ctkn_pool[tkn].end = (jtok_off_t)end;
+        }
+        break;
+        case JTOK_OUTPUT_SOA:
+        {
+            parser->soa->end[tkn] = (jtok_off_t)end;
+        }
+        break;
+        case JTOK_OUTPUT_TAPE:
+        {
+            jtok_tape_end_entry(parser, tkn, end);
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+}
+
+
+void jtok_token_set_subtype(jtok_parser_t *parser, jtok_pos_t tkn,
+                            JTOK_SUBTYPE_t subtype)
+{
+    if (tkn == JTOK_SKIPPED_TOKEN_IDX)
+    {
+        return;
+    }
+
+    switch (parser->output)
+    {
+        case JTOK_OUTPUT_TOKENS:
+        {
+            parser->tkn_pool[tkn].subtype = subtype;
+        }
+        break;
+        case JTOK_OUTPUT_COMPACT:
+        {
+            parser->ctkn_pool[tkn].subtype = (uint8_t)subtype;
+        }
+        break;
+        default: /* The other outputs have no room for it */
+        {
+        }
+        break;
+    }
+}
+
+
+void jtok_token_add_child(jtok_parser_t *parser, jtok_pos_t tkn)
+{
+    if (tkn == JTOK_SKIPPED_TOKEN_IDX)
+    {
+        return;
+    }
+
+    switch (parser->output)
+    {
+        case JTOK_OUTPUT_TOKENS:
+        {
+            parser->tkn_pool[tkn].size++;
+        }
+        break;
+        case JTOK_OUTPUT_COMPACT:
+        {
+            parser->ctkn_pool[tkn].size++;
+        }
+        break;
+        case JTOK_OUTPUT_SOA:
+        {
+            parser->soa->size[tkn]++;
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+}
+
+
+void jtok_token_link(jtok_parser_t *parser, jtok_pos_t tkn, jtok_pos_t sibling)
+{
+    switch (parser->output)
+    {
+        case JTOK_OUTPUT_TOKENS:
+        {
+            parser->tkn_pool[tkn].sibling = (int)sibling;
+        }
+        break;
+        case JTOK_OUTPUT_COMPACT:
+        {
+            parser->ctkn_pool[tkn].sibling = jtok_ctkn_idx(sibling);
+        }
+        break;
+        case JTOK_OUTPUT_SOA:
+        {
+            parser->soa->sibling[tkn] = jtok_soa_idx(sibling);
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+}
+
+
+static jtok_idx_t jtok_ctkn_idx(jtok_pos_t idx)
+{
+    jtok_idx_t cidx = JTOK_CTKN_NONE;
+    if (idx != JTOK_INVALID_ARRAY_INDEX)
+    {
+        cidx = (jtok_idx_t)idx;
+    }
+    return cidx;
+}
+
+
+static jtok_soa_idx_t jtok_soa_idx(jtok_pos_t idx)
+{
+    jtok_soa_idx_t sidx = JTOK_SOA_NONE;
+    if (idx != JTOK_INVALID_ARRAY_INDEX)
+    {
+        sidx = (jtok_soa_idx_t)idx;
+    }
+    return sidx;
+}
+
+
+static jtok_pos_t jtok_tape_new_entry(jtok_parser_t *parser, JTOK_TYPE_t type,
+                                      jtok_pos_t start, jtok_pos_t end)
+{
+    jtok_tape_t *tape  = parser->tape;
+    jtok_pos_t   entry = JTOK_INVALID_ARRAY_INDEX;
+    uint64_t     tag   = JTOK_TAPE_PRIMITIVE;
+    size_t       words = 2;
+
+    if (type == JTOK_OBJECT || type == JTOK_ARRAY)
+    {
+        /* Room for the end entry is reserved up front */
+        tag   = (type == JTOK_OBJECT) ? JTOK_TAPE_OBJECT : JTOK_TAPE_ARRAY;
+        words = 4;
+    }
+    else if (type == JTOK_STRING)
+    {
+        tag = JTOK_TAPE_STRING;
+        if (parser->depth > 0 &&
+            parser->frames[parser->depth - 1].type == JTOK_OBJECT &&
+            parser->frames[parser->depth - 1].tkn == parser->toksuper)
+        {
+            /* Strings owned by the object itself are its keys */
+            tag = JTOK_TAPE_KEY;
+        }
+    }
+
+    /* Every open container still needs room for its end entry */
+    if (tape->count + words + 2 * (size_t)parser->depth <= tape->cap)
+    {
+        entry = (jtok_pos_t)tape->count;
+        if (words == 4)
+        {
+            /* Payload is patched once the container is closed */
+            tape->words[tape->count++] = tag << JTOK_TAPE_TAG_SHIFT;
+            tape->words[tape->count++] = (uint64_t)start;
+        }
+        else
+        {
+            tape->words[tape->count++] = (tag << JTOK_TAPE_TAG_SHIFT) |
+                                         (uint64_t)start;
+            tape->words[tape->count++] = (uint64_t)(end - start);
+        }
+    }
+    return entry;
+}
+
+
+static void jtok_tape_end_entry(jtok_parser_t *parser, jtok_pos_t tkn,
+                                jtok_pos_t end)
+{
+    jtok_tape_t *tape    = parser->tape;
+    uint64_t     tag     = tape->words[tkn] >> JTOK_TAPE_TAG_SHIFT;
+    uint64_t     end_tag = JTOK_TAPE_ARRAY_END;
+    if (tag == JTOK_TAPE_OBJECT)
+    {
+        end_tag = JTOK_TAPE_OBJECT_END;
+    }
+    tape->words[tape->count++] = (end_tag << JTOK_TAPE_TAG_SHIFT) |
+                                 (uint64_t)tkn;
+    tape->words[tape->count++] = (uint64_t)end;
+    tape->words[tkn] = (tag << JTOK_TAPE_TAG_SHIFT) | (uint64_t)tape->count;
+}
+
+
+jtok_parser_t jtok_new_parser(const char *json_str, size_t len,
+                              jtok_tkn_t *tokens, size_t poolsize,
+                              jtok_frame_t *frames, size_t max_depth)
+{
+    jtok_parser_t parser;
+    parser.pos        = 0;
+    parser.toknext    = 0;
+    parser.toklast    = JTOK_INVALID_ARRAY_INDEX;
+    parser.toksuper   = JTOK_NO_PARENT_IDX;
+    parser.json       = (char *)json_str;
+    parser.json_len   = (jtok_pos_t)len;
+    parser.tkn_pool   = tokens;
+    parser.ctkn_pool  = NULL;
+    parser.soa        = NULL;
+    parser.tape       = NULL;
+    parser.output     = JTOK_OUTPUT_COUNT;
+    if (tokens != NULL)
+    {
+        parser.output = JTOK_OUTPUT_TOKENS;
+    }
+    parser.pool_size  = JTOK_POS_MAX;
+    if (poolsize < (size_t)JTOK_POS_MAX)
+    {
+        parser.pool_size = (jtok_pos_t)poolsize;
+    }
+    parser.frames     = frames;
+    parser.max_depth  = max_depth;
+    parser.depth      = 0;
+    parser.str_quote  = JTOK_INVALID_ARRAY_INDEX;
+    parser.str_scan   = JTOK_INVALID_ARRAY_INDEX;
+    parser.paths      = NULL;
+    parser.npaths     = 0;
+    parser.sel_paths  = 0;
+    parser.sel_all    = true;
+    parser.status     = JTOK_PARSE_STATUS_OK;
+    jtok_index_reset(&parser);
+    return parser;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_push_frame(jtok_parser_t *parser, JTOK_TYPE_t type)
+{
+    if (parser->depth >= parser->max_depth)
+    {
+        return JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED;
+    }
+
+    jtok_pos_t tkn = jtok_new_token(parser, type, parser->pos,
+                                    JTOK_INVALID_ARRAY_INDEX);
+    if (tkn == JTOK_INVALID_ARRAY_INDEX)
+    {
+        /*
+         * Do not reset parser->pos because we want
+         * caller to see which token maxed out the
+         * pool
+         */
+        return JTOK_PARSE_STATUS_NOMEM;
+    }
+
+    /* all aggregates start with no children (since they can be empty) */
+    jtok_frame_t *frame = &parser->frames[parser->depth++];
+    frame->tkn          = tkn;
+    frame->key          = JTOK_NO_CHILD_IDX;
+    frame->last_child   = JTOK_NO_CHILD_IDX;
+    frame->expecting    = 0;
+    frame->type         = type;
+    frame->element_type = JTOK_UNASSIGNED_TOKEN;
+    frame->sel_paths    = parser->sel_paths;
+    frame->sel_all      = parser->sel_all;
+
+    /* go inside the aggregate */
+    parser->pos++;
+    return JTOK_PARSE_STATUS_OK;
+}
+
+
+JTOK_PARSE_STATUS_t jtok_pop_frame(jtok_parser_t *parser)
+{
+    jtok_frame_t *frame = &parser->frames[--parser->depth];
+    jtok_token_set_end(parser, frame->tkn, parser->pos + 1);
+    parser->pos++;
+    return JTOK_PARSE_STATUS_OK;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file jtok_soa.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module for navigating and scanning struct-of-arrays token
+ * pools
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "jtok.h"
+
+
+#if defined(__SSE2__)
+#define JTOK_SOA_LANES 16 /* type bytes compared per vector */
+static unsigned int jtok_soa_type_mask(const uint8_t *types, uint8_t type);
+#endif /* #if defined(__SSE2__) */
+
+
+jtok_soa_idx_t jtok_soa_child(const jtok_soa_t *soa, jtok_soa_idx_t tkn)
+{
+    jtok_soa_idx_t child = JTOK_SOA_NONE;
+    if (soa != NULL && tkn < soa->count && soa->size[tkn] > 0)
+    {
+        /* Tokens are allocated in document order so the first child
+         * is RIGHT AFTER its parent */
+        child = tkn + 1;
+    }
+    return child;
+}
+
+
+jtok_soa_idx_t jtok_soa_sibling(const jtok_soa_t *soa, jtok_soa_idx_t tkn)
+{
+    jtok_soa_idx_t sibling = JTOK_SOA_NONE;
+    if (soa != NULL && tkn < soa->count)
+    {
+        sibling = soa->sibling[tkn];
+    }
+    return sibling;
+}
+
+
+size_t jtok_soa_count_type(const jtok_soa_t *soa, JTOK_TYPE_t type)
+{
+    size_t count = 0;
+    size_t i     = 0;
+    if (soa != NULL)
+    {
+#if defined(__SSE2__)
+        for (; i + JTOK_SOA_LANES <= soa->count; i += JTOK_SOA_LANES)
+        {
+            count += __builtin_popcount(
+                jtok_soa_type_mask(&soa->type[i], (uint8_t)type));
+        }
+#endif /* #if defined(__SSE2__) */
+        for (; i < soa->count; i++)
+        {
+            count += (soa->type[i] == (uint8_t)type);
+        }
+    }
+    return count;
+}
+
+
+size_t jtok_soa_find_type(const jtok_soa_t *soa, JTOK_TYPE_t type,
+                          size_t from, jtok_soa_idx_t *out, size_t max)
+{
+    size_t found = 0;
+    size_t i     = from;
+    if (soa != NULL && out != NULL)
+    {
+#if defined(__SSE2__)
+        for (; i + JTOK_SOA_LANES <= soa->count && found < max;
+             i += JTOK_SOA_LANES)
+        {
+            /* Only blocks with a match are looked at one token at a time */
+            unsigned int mask;
+            mask = jtok_soa_type_mask(&soa->type[i], (uint8_t)type);
+            while (mask != 0 && found < max)
+            {
+                out[found++] = (jtok_soa_idx_t)(i + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+            if (mask != 0)
+            {
+                return found;
+            }
+        }
+#endif /* #if defined(__SSE2__) */
+        for (; i < soa->count && found < max; i++)
+        {
+            if (soa->type[i] == (uint8_t)type)
+            {
+                out[found++] = (jtok_soa_idx_t)i;
+            }
+        }
+    }
+    return found;
+}
+
+
+#if defined(__SSE2__)
+static unsigned int jtok_soa_type_mask(const uint8_t *types, uint8_t type)
+{
+    __m128i v      = _mm_loadu_si128((const __m128i *)types);
+    __m128i needle = _mm_set1_epi8((char)type);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+}
+#endif /* #if defined(__SSE2__) */
@@ -10,48 +10,59 @@
  *
  */
 
-#include <ctype.h>
 #include <string.h>
 
 #include "jtok_string.h"
 #include "jtok_shared.h"
+#include "jtok_index.h"
 
 
 JTOK_PARSE_STATUS_t jtok_parse_string(jtok_parser_t *parser)
 {
-    jtok_tkn_t *token;
-    jtok_tkn_t *tokens = parser->tkn_pool;
-    int         start;
-    char *      js  = parser->json;
-    int         len = parser->json_len;
+    jtok_pos_t start;
+    char *     js  = parser->json;
+    jtok_pos_t len = parser->json_len;
     if (js[parser->pos] == '\"' || js[parser->pos] == '\'')
     {
-        char start_char = js[parser->pos];
+        char       start_char = js[parser->pos];
+        jtok_pos_t quote      = parser->pos;
         parser->pos++;       /* advance to inside of quotes */
         start = parser->pos; /* first character after the quote */
-        for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++)
+        if (parser->str_quote == quote)
         {
+            /* String was cut off by the end of a previous chunk. Skip the
+             * part that was already validated */
+            parser->pos = parser->str_scan;
+        }
+
+        /* start of the char or escape sequence being validated */
+        jtok_pos_t seq = parser->pos;
+        for (; parser->pos < len; parser->pos++)
+        {
+            /* Plain chars need no validation. Jump to the next quote or
+             * escape */
+            parser->pos = jtok_index_next_string_special(js, len, parser->pos,
+                                                         start_char);
+            seq         = parser->pos;
+            if (parser->pos >= len)
+            {
+                break;
+            }
+
             /* Quote: end of string */
             if (js[parser->pos] == start_char)
             {
                 if (start_char == js[parser->pos])
                 {
-                    if (parser->pos == start)
-                    {
-                        token = &tokens[parser->toksuper];
-                        if (token->type != JTOK_STRING)
-                        {
-                            return JTOK_PARSE_STATUS_EMPTY_KEY;
-                        }
-                    }
-                    token = jtok_alloc_token(parser);
-                    if (token == NULL)
+                    /* Empty keys are rejected by the calling object */
+                    if (jtok_new_token(parser, JTOK_STRING, start,
+                                       parser->pos) == JTOK_INVALID_ARRAY_INDEX)
                     {
-                        parser->pos = start;
+                        /* Back at the quote like any token that did not
+                         * fit, so parsing can resume with more tokens */
+                        parser->pos = quote;
                         return JTOK_PARSE_STATUS_NOMEM;
                     }
-                    jtok_fill_token(token, JTOK_STRING, start, parser->pos);
-                    token->parent = parser->toksuper;
                     return JTOK_PARSE_STATUS_OK;
                 }
                 else
@@ -64,52 +75,43 @@ JTOK_PARSE_STATUS_t jtok_parse_string(jtok_parser_t *parser)
                 if (parser->pos + sizeof((char)'\"') < (size_t)len)
                 {
                     parser->pos++;
-                    switch (js[parser->pos])
+                    if (JTOK_CHAR_IS(js[parser->pos], JTOK_CHAR_ESCAPE))
                     {
                         /* Allowed escaped symbols */
-                        case '\"':
-                        case '/':
-                        case '\\':
-                        case 'b':
-                        case 'f':
-                        case 'r':
-                        case 'n':
-                        case 't':
-                        {
-                        }
-                        break;
-                        case 'u': /* Allows escaped symbol \uXXXX */
+                    }
+                    else if (js[parser->pos] == 'u')
+                    {
+                        /* Allows escaped symbol \uXXXX */
+                        parser->pos++; /* move to first escaped hex
+                                          character */
+                        int i;
+                        int max_i = HEXCHAR_ESCAPE_SEQ_COUNT;
+                        for (i = 0; i < max_i && parser->pos < len; i++)
                         {
-                            parser->pos++; /* move to first escaped hex
-                                              character */
-                            int i;
-                            int max_i = HEXCHAR_ESCAPE_SEQ_COUNT;
-                            for (i = 0; i < max_i && parser->pos < len &&
-                                        js[parser->pos] != '\0';
-                                 i++)
+                            if (!JTOK_CHAR_IS(js[parser->pos], JTOK_CHAR_HEX))
                             {
-                                if (!isxdigit((int)js[parser->pos]))
-                                {
-                                    /* reset parser position and return error */
-                                    parser->pos = start;
-                                    return JTOK_PARSE_STATUS_INVAL;
-                                }
-                                parser->pos++;
+                                /* reset parser position and return error */
+                                parser->pos = start;
+                                return JTOK_PARSE_STATUS_INVAL;
                             }
-                            parser->pos--;
+                            parser->pos++;
                         }
-                        break;
-                        default: /* Unexpected symbol */
-                        {
-                            parser->pos = start;
-                            return JTOK_PARSE_STATUS_INVAL;
-                        }
-                        break;
+                        parser->pos--;
+                    }
+                    else /* Unexpected symbol */
+                    {
+                        parser->pos = start;
+                        return JTOK_PARSE_STATUS_INVAL;
                     }
                 }
             }
         }
-        parser->pos = start;
+        /* Remember how far the string was validated so parsing can resume
+         * from there, and rewind to the quote so the calling aggregate
+         * sees the string again when more json is available */
+        parser->str_quote = quote;
+        parser->str_scan  = seq;
+        parser->pos       = quote;
         return JTOK_PARSE_STATUS_PARTIAL_TOKEN;
     }
     else
@@ -122,13 +124,13 @@ JTOK_PARSE_STATUS_t jtok_parse_string(jtok_parser_t *parser)
 
 bool jtok_toktokcmp_string(const jtok_tkn_t *tkn1, const jtok_tkn_t *tkn2)
 {
-    bool           is_equal = false;
-    uint_least16_t len      = jtok_toklen(tkn1);
+    bool   is_equal = false;
+    size_t len      = jtok_toklen(tkn1);
     if (len == jtok_toklen(tkn2))
     {
         const char *start1 = &tkn1->json[tkn1->start];
         const char *start2 = &tkn2->json[tkn2->start];
-        if (0 == strncmp(start1, start2, len))
+        if (0 == memcmp(start1, start2, len))
         {
             is_equal = true;
         }
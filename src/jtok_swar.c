@@ -0,0 +1,225 @@
+/**
+ * @file jtok_swar.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module of the word-at-a-time (SWAR) scanning kernels. They
+ * test 4 or 8 chars per step with plain integer arithmetic so targets with no
+ * vector unit still skip runs of plain chars quickly.
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "jtok_swar.h"
+#include "jtok_shared.h"
+
+#if JTOK_SWAR_WIDTH == 64
+typedef uint64_t jtok_word_t;
+#define JTOK_WORD_ONES 0x0101010101010101ULL
+#elif JTOK_SWAR_WIDTH == 32
+typedef uint32_t jtok_word_t;
+#define JTOK_WORD_ONES 0x01010101UL
+#elif JTOK_SWAR_WIDTH != 0
+#error "JTOK_SWAR_WIDTH must be 0, 32 or 64"
+#endif /* #if JTOK_SWAR_WIDTH == 64 */
+
+#if JTOK_SWAR_WIDTH
+#define JTOK_WORD_LOW7 (JTOK_WORD_ONES * 0x7Fu)
+#define JTOK_WORD_HIGH (JTOK_WORD_ONES * 0x80u)
+#define JTOK_WORD_SIZE ((jtok_pos_t)sizeof(jtok_word_t))
+
+static jtok_word_t jtok_word_load(const char *p);
+static jtok_word_t jtok_word_eq(jtok_word_t w, unsigned char c);
+static jtok_word_t jtok_word_whitespace(jtok_word_t w);
+static jtok_word_t jtok_word_digits(jtok_word_t w);
+#endif /* #if JTOK_SWAR_WIDTH */
+
+/* Converting a word of digits at once needs the first char in the low byte */
+#if JTOK_SWAR_WIDTH && defined(__BYTE_ORDER__) &&                              \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define JTOK_SWAR_DIGITS_VALUE 1
+static uint32_t jtok_word_digits_value(jtok_word_t w);
+#else
+#define JTOK_SWAR_DIGITS_VALUE 0
+#endif /* #if JTOK_SWAR_WIDTH && defined(__BYTE_ORDER__) && ... */
+
+
+jtok_pos_t jtok_swar_next_string_special(const char *json, jtok_pos_t len,
+                                         jtok_pos_t pos, char quote)
+{
+#if JTOK_SWAR_WIDTH
+    while (len - pos >= JTOK_WORD_SIZE)
+    {
+        jtok_word_t w = jtok_word_load(&json[pos]);
+        if ((jtok_word_eq(w, (unsigned char)quote) |
+             jtok_word_eq(w, (unsigned char)'\\')) != 0)
+        {
+            /* The char is in this word. Find it below */
+            break;
+        }
+        pos += JTOK_WORD_SIZE;
+    }
+#endif /* #if JTOK_SWAR_WIDTH */
+
+    for (; pos < len; pos++)
+    {
+        if (json[pos] == quote || json[pos] == '\\')
+        {
+            return pos;
+        }
+    }
+    return len;
+}
+
+
+jtok_pos_t jtok_swar_skip_whitespace(const char *json, jtok_pos_t len,
+                                     jtok_pos_t pos)
+{
+#if JTOK_SWAR_WIDTH
+    while (len - pos >= JTOK_WORD_SIZE &&
+           jtok_word_whitespace(jtok_word_load(&json[pos])) == JTOK_WORD_HIGH)
+    {
+        pos += JTOK_WORD_SIZE;
+    }
+#endif /* #if JTOK_SWAR_WIDTH */
+
+    while (pos < len && JTOK_CHAR_CLASS(json[pos]) == JTOK_CHAR_WHITESPACE)
+    {
+        pos++;
+    }
+    return pos;
+}
+
+
+jtok_pos_t jtok_swar_skip_digits(const char *json, jtok_pos_t len,
+                                 jtok_pos_t pos)
+{
+#if JTOK_SWAR_WIDTH
+    while (len - pos >= JTOK_WORD_SIZE &&
+           jtok_word_digits(jtok_word_load(&json[pos])) == JTOK_WORD_HIGH)
+    {
+        pos += JTOK_WORD_SIZE;
+    }
+#endif /* #if JTOK_SWAR_WIDTH */
+
+    while (pos < len && JTOK_CHAR_CLASS(json[pos]) == JTOK_CHAR_DIGIT)
+    {
+        pos++;
+    }
+    return pos;
+}
+
+
+bool jtok_swar_digits_value(const char *digits, jtok_pos_t count,
+                            uint64_t *value)
+{
+    uint64_t v = 0;
+#if JTOK_SWAR_DIGITS_VALUE
+    /* 10^4 or 10^8, one power of ten per char of a word */
+    const uint64_t scale = (JTOK_WORD_SIZE == 8) ? 100000000u : 10000u;
+    while (count >= JTOK_WORD_SIZE)
+    {
+        jtok_word_t w = jtok_word_load(digits);
+        if (jtok_word_digits(w) != JTOK_WORD_HIGH)
+        {
+            return false;
+        }
+        v = v * scale + jtok_word_digits_value(w);
+        digits += JTOK_WORD_SIZE;
+        count -= JTOK_WORD_SIZE;
+    }
+#endif /* #if JTOK_SWAR_DIGITS_VALUE */
+
+    for (; count > 0; count--, digits++)
+    {
+        unsigned int digit = (unsigned int)(unsigned char)*digits - '0';
+        if (digit > 9)
+        {
+            return false;
+        }
+        v = v * 10 + digit;
+    }
+    *value = v;
+    return true;
+}
+
+
+#if JTOK_SWAR_WIDTH
+
+/**
+ * @brief Load a word from a possibly unaligned address
+ */
+static jtok_word_t jtok_word_load(const char *p)
+{
+    jtok_word_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+
+/**
+ * @brief Set the high bit of every byte of a word that equals c
+ *
+ * @note Exact for every byte, carries never cross into the next byte so the
+ * result does not depend on the byte order of the target
+ */
+static jtok_word_t jtok_word_eq(jtok_word_t w, unsigned char c)
+{
+    jtok_word_t x = w ^ (JTOK_WORD_ONES * c);
+    return ~(((x & JTOK_WORD_LOW7) + JTOK_WORD_LOW7) | x) & JTOK_WORD_HIGH;
+}
+
+
+/**
+ * @brief Set the high bit of every byte of a word that is json whitespace
+ */
+static jtok_word_t jtok_word_whitespace(jtok_word_t w)
+{
+    return jtok_word_eq(w, ' ') | jtok_word_eq(w, '\t') |
+           jtok_word_eq(w, '\r') | jtok_word_eq(w, '\n');
+}
+
+
+/**
+ * @brief Set the high bit of every byte of a word that is a decimal digit
+ *
+ * @note Adding to the low 7 bits of each byte never carries out of the byte.
+ * The high bit of the sum tells if the byte is at least '0', and at least
+ * '9' + 1, respectively
+ */
+static jtok_word_t jtok_word_digits(jtok_word_t w)
+{
+    jtok_word_t low = w & JTOK_WORD_LOW7;
+    jtok_word_t ge0 = low + JTOK_WORD_ONES * (0x80u - '0');
+    jtok_word_t gt9 = low + JTOK_WORD_ONES * (0x80u - '9' - 1);
+    return ge0 & ~gt9 & ~w & JTOK_WORD_HIGH;
+}
+
+
+#if JTOK_SWAR_DIGITS_VALUE
+
+/**
+ * @brief Convert a word of decimal digits to its value
+ *
+ * @note Each step merges every pair of neighbouring lanes into one lane of
+ * twice the width holding their 2, 4 then 8 digit value. Lanes never carry
+ * into each other because their values stay below 10^n
+ */
+static uint32_t jtok_word_digits_value(jtok_word_t w)
+{
+    w &= JTOK_WORD_ONES * 0x0Fu;
+    w = (w * 10 + (w >> 8)) & (jtok_word_t)0x00FF00FF00FF00FFULL;
+    w = (w * 100 + (w >> 16)) & (jtok_word_t)0x0000FFFF0000FFFFULL;
+#if JTOK_SWAR_WIDTH == 64
+    w = (w * 10000 + (w >> 32)) & 0xFFFFFFFFu;
+#endif /* #if JTOK_SWAR_WIDTH == 64 */
+    return (uint32_t)w;
+}
+
+#endif /* #if JTOK_SWAR_DIGITS_VALUE */
+
+#endif /* #if JTOK_SWAR_WIDTH */
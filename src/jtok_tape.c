@@ -0,0 +1,217 @@
+/**
+ * @file jtok_tape.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module for iterating over the tape of a parsed json document
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+
+#include <string.h>
+
+#include "jtok.h"
+
+
+static uint64_t jtok_tape_payload(const jtok_tape_t *tape, size_t i);
+static bool     jtok_tape_is_end(char tag);
+
+
+char jtok_tape_tag(const jtok_tape_t *tape, size_t i)
+{
+    char tag = '\0';
+    if (tape != NULL && i < tape->count)
+    {
+        tag = (char)(tape->words[i] >> JTOK_TAPE_TAG_SHIFT);
+    }
+    return tag;
+}
+
+
+size_t jtok_tape_skip(const jtok_tape_t *tape, size_t i)
+{
+    size_t next;
+    switch (jtok_tape_tag(tape, i))
+    {
+        case JTOK_TAPE_OBJECT:
+        case JTOK_TAPE_ARRAY:
+        {
+            /* Containers record the index after their end entry */
+            next = (size_t)jtok_tape_payload(tape, i);
+        }
+        break;
+        case JTOK_TAPE_KEY:
+        {
+            /* The value belongs to the key */
+            next = jtok_tape_skip(tape, i + 2);
+        }
+        break;
+        default:
+        {
+            next = i + 2;
+        }
+        break;
+    }
+    return next;
+}
+
+
+size_t jtok_tape_child(const jtok_tape_t *tape, size_t i)
+{
+    size_t child = JTOK_TAPE_NONE;
+    switch (jtok_tape_tag(tape, i))
+    {
+        case JTOK_TAPE_OBJECT:
+        case JTOK_TAPE_ARRAY:
+        {
+            if (!jtok_tape_is_end(jtok_tape_tag(tape, i + 2)))
+            {
+                child = i + 2;
+            }
+        }
+        break;
+        case JTOK_TAPE_KEY:
+        {
+            child = i + 2;
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+    return child;
+}
+
+
+size_t jtok_tape_sibling(const jtok_tape_t *tape, size_t i)
+{
+    size_t sibling = JTOK_TAPE_NONE;
+    if (tape != NULL && i < tape->count)
+    {
+        size_t next = jtok_tape_skip(tape, i);
+        char   tag  = jtok_tape_tag(tape, next);
+        if (tag == '\0' || jtok_tape_is_end(tag))
+        {
+            /* i is the last child */
+        }
+        else if (tag == JTOK_TAPE_KEY &&
+                 jtok_tape_tag(tape, i) != JTOK_TAPE_KEY)
+        {
+            /* i is the value of a key, which has no siblings */
+        }
+        else
+        {
+            sibling = next;
+        }
+    }
+    return sibling;
+}
+
+
+size_t jtok_tape_toklen(const jtok_tape_t *tape, size_t i)
+{
+    size_t len = 0;
+    switch (jtok_tape_tag(tape, i))
+    {
+        case JTOK_TAPE_OBJECT:
+        case JTOK_TAPE_ARRAY:
+        {
+            /* Second words of the start and end entries hold the offsets */
+            size_t end = (size_t)jtok_tape_payload(tape, i) - 1;
+            len        = (size_t)(tape->words[end] - tape->words[i + 1]);
+        }
+        break;
+        case JTOK_TAPE_KEY:
+        case JTOK_TAPE_STRING:
+        case JTOK_TAPE_PRIMITIVE:
+        {
+            len = (size_t)tape->words[i + 1];
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+    return len;
+}
+
+
+const char *jtok_tape_tokstr(const jtok_tape_t *tape, size_t i)
+{
+    const char *str = NULL;
+    switch (jtok_tape_tag(tape, i))
+    {
+        case JTOK_TAPE_OBJECT:
+        case JTOK_TAPE_ARRAY:
+        {
+            str = &tape->json[tape->words[i + 1]];
+        }
+        break;
+        case JTOK_TAPE_KEY:
+        case JTOK_TAPE_STRING:
+        case JTOK_TAPE_PRIMITIVE:
+        {
+            str = &tape->json[jtok_tape_payload(tape, i)];
+        }
+        break;
+        default:
+        {
+        }
+        break;
+    }
+    return str;
+}
+
+
+bool jtok_tape_tokcmp(const jtok_tape_t *tape, const char *str, size_t i)
+{
+    bool        result = false;
+    const char *tokstr = jtok_tape_tokstr(tape, i);
+    if (str != NULL && tokstr != NULL)
+    {
+        /* The json string may not be nul-terminated, so never compare past
+         * the end of the entry */
+        size_t toklen = jtok_tape_toklen(tape, i);
+        if (strlen(str) == toklen && 0 == memcmp(str, tokstr, toklen))
+        {
+            result = true;
+        }
+    }
+    return result;
+}
+
+
+size_t jtok_tape_obj_has_key(const jtok_tape_t *tape, size_t obj,
+                             const char *key_str)
+{
+    size_t key = JTOK_TAPE_NONE;
+    if (jtok_tape_tag(tape, obj) == JTOK_TAPE_OBJECT)
+    {
+        size_t cur_key = jtok_tape_child(tape, obj);
+        while (cur_key != JTOK_TAPE_NONE)
+        {
+            if (jtok_tape_tokcmp(tape, key_str, cur_key))
+            {
+                key = cur_key;
+                break;
+            }
+            cur_key = jtok_tape_sibling(tape, cur_key);
+        }
+    }
+    return key;
+}
+
+
+static uint64_t jtok_tape_payload(const jtok_tape_t *tape, size_t i)
+{
+    return tape->words[i] & JTOK_TAPE_PAYLOAD_MASK;
+}
+
+
+static bool jtok_tape_is_end(char tag)
+{
+    return tag == JTOK_TAPE_OBJECT_END || tag == JTOK_TAPE_ARRAY_END;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file array_extraction.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test converting whole arrays of numbers and
+ * booleans into caller buffers
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (2200u)
+#define SAMPLES (2000u)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static char       json[SAMPLES * 16];
+static int32_t    ints[SAMPLES];
+static bool       bools[8];
+#if JTOK_FLOAT
+static double doubles[SAMPLES];
+#endif /* #if JTOK_FLOAT */
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    size_t              count;
+    size_t              len;
+
+    printf("\nConverting a large array of samples ... ");
+    len = (size_t)snprintf(json, sizeof(json), "{\"samples\":[");
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "%s%ld",
+                                (i > 0) ? ", " : "",
+                                (long)(i * 1000003 % 4000000) - 2000000);
+    }
+    snprintf(&json[len], sizeof(json) - len, "],\"after\":1}");
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK ||
+        !jtok_array_to_int32(&tokens[2], ints, SAMPLES, &count) ||
+        count != SAMPLES)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        long expected = (long)(i * 1000003 % 4000000) - 2000000;
+        if (ints[i] != expected)
+        {
+            printf("failed at sample %zu.\n", i);
+            return 1;
+        }
+    }
+#if JTOK_FLOAT
+    if (!jtok_array_to_double(&tokens[2], doubles, SAMPLES, NULL))
+    {
+        printf("failed as doubles.\n");
+        return 1;
+    }
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        if (doubles[i] != (double)ints[i])
+        {
+            printf("failed at double sample %zu.\n", i);
+            return 1;
+        }
+    }
+#endif /* #if JTOK_FLOAT */
+    printf("passed.\n");
+
+    printf("\nConverting doubles and booleans ... ");
+    strcpy(json, "{\"d\":[1.5, -2e-3, 7, 0.1],\"b\":[true,false,true],"
+                 "\"e\":[]}");
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+#if JTOK_FLOAT
+    if (status != JTOK_PARSE_STATUS_OK ||
+        !jtok_array_to_double(&tokens[2], doubles, 4, &count) || count != 4 ||
+        doubles[0] != 1.5 || doubles[1] != -2e-3 || doubles[2] != 7 ||
+        doubles[3] != 0.1)
+    {
+        printf("failed for doubles.\n");
+        return 1;
+    }
+#endif /* #if JTOK_FLOAT */
+    if (status != JTOK_PARSE_STATUS_OK ||
+        !jtok_array_to_bool(&tokens[8], bools, 3, &count) || count != 3 ||
+        !bools[0] || bools[1] || !bools[2] ||
+        !jtok_array_to_int32(&tokens[13], ints, 0, &count) || count != 0)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nStopping on elements that do not convert ... ");
+    strcpy(json, "{\"a\":[1, 2, 3.5],\"o\":2147483648,\"n\":[[1],[2]],"
+                 "\"s\":[\"1\"],\"x\":[1, 2147483648]}");
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK ||
+        jtok_array_to_int32(&tokens[2], ints, 3, &count) || count != 2 ||
+        ints[1] != 2 ||
+        jtok_array_to_int32(&tokens[2], ints, 2, &count) || count != 0 ||
+        jtok_array_to_int32(&tokens[7], ints, 3, &count) || count != 0 ||
+        jtok_array_to_bool(&tokens[15], bools, 3, &count) || count != 0 ||
+        jtok_array_to_int32(&tokens[18], ints, 3, &count) || count != 1 ||
+        jtok_array_to_int32(NULL, ints, 3, NULL) ||
+        jtok_array_to_int32(&tokens[2], NULL, 3, NULL))
+    {
+        printf("failed.\n");
+        return 1;
+    }
+#if JTOK_FLOAT
+    if (jtok_array_to_double(&tokens[9], doubles, 3, &count) || count != 0 ||
+        jtok_array_to_double(NULL, doubles, 3, NULL) ||
+        jtok_array_to_double(&tokens[2], NULL, 3, NULL))
+    {
+        printf("failed for doubles.\n");
+        return 1;
+    }
+#endif /* #if JTOK_FLOAT */
+    printf("passed.\n");
+    return 0;
+}
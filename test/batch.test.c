@@ -0,0 +1,217 @@
+/**
+ * @file batch.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that the multi-threaded NDJSON batch engine
+ * delivers every record exactly once, in order when asked to
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#define WORKER_MAX (4u)
+#define TOKEN_MAX (64u)
+#define RECORD_COUNT (2000u)
+#define JSON_STRLEN (RECORD_COUNT * 200)
+
+struct results
+{
+    size_t        delivered[WORKER_MAX];
+    unsigned char seen[RECORD_COUNT];
+    size_t        failed;
+    size_t        next; /* ordered: index of the next record */
+    size_t        stop; /* stop after this many records, 0 to never stop */
+};
+
+static jtok_batch_worker_t workers[WORKER_MAX];
+static jtok_tkn_t          pools[WORKER_MAX][TOKEN_MAX];
+static jtok_ndjson_rec_t   held[WORKER_MAX][8];
+static char                json[JSON_STRLEN];
+static struct results      res;
+
+static size_t build_records(void);
+static bool   is_malformed(size_t id);
+static void   setup(size_t nrecs);
+static bool   check(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                    size_t id);
+static bool   on_ordered(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                         size_t worker, void *ctx);
+static bool   on_unordered(const jtok_ndjson_rec_t *rec,
+                           const jtok_tkn_t *tkns, size_t worker, void *ctx);
+
+int main(void)
+{
+    size_t              len = build_records();
+    JTOK_PARSE_STATUS_t status;
+
+    printf("\nDelivering records in order ... ");
+    for (size_t nrecs = 0; nrecs <= 8; nrecs += 4)
+    {
+        setup(nrecs);
+        status = jtok_batch_parse(json, len, workers, WORKER_MAX, 256,
+                                  JTOK_BATCH_ORDERED, on_ordered, &res);
+        if (status != JTOK_PARSE_STATUS_VAL_NO_COMMA || res.failed != 0 ||
+            res.next != RECORD_COUNT)
+        {
+            printf("failed with status %d after %zu records.\n", status,
+                   res.next);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nDelivering records out of order ... ");
+    setup(0);
+    status = jtok_batch_parse(json, len, workers, WORKER_MAX, 256,
+                              JTOK_BATCH_UNORDERED, on_unordered, &res);
+    size_t total = 0;
+    for (size_t w = 0; w < WORKER_MAX; w++)
+    {
+        total += res.delivered[w];
+    }
+    if (status != JTOK_PARSE_STATUS_VAL_NO_COMMA || res.failed != 0 ||
+        total != RECORD_COUNT ||
+        memchr(res.seen, 0, sizeof(res.seen)) != NULL)
+    {
+        printf("failed with status %d after %zu records.\n", status, total);
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nStopping every worker from the callback ... ");
+    setup(8);
+    res.stop = 10;
+    status   = jtok_batch_parse(json, len, workers, WORKER_MAX, 256,
+                              JTOK_BATCH_ORDERED, on_ordered, &res);
+    if (res.failed != 0 || res.next != 10)
+    {
+        printf("failed after %zu records.\n", res.next);
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nReporting a last record that is cut off ... ");
+    {
+        static const char tail[] = "{\"id\":0}\n{\"id\":1";
+        setup(0);
+        res.stop = 2;
+        status = jtok_batch_parse(tail, strlen(tail), workers, 1, 0,
+                                  JTOK_BATCH_ORDERED, on_ordered, &res);
+        if (status != JTOK_PARSE_STATUS_PARTIAL_TOKEN || res.next != 2)
+        {
+            printf("failed with status %d.\n", status);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Build records of uneven size. Record i has id i and some records are
+ * malformed
+ */
+static size_t build_records(void)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < RECORD_COUNT; i++)
+    {
+        const char *sep = is_malformed(i) ? " " : ",";
+        len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                                "{\"id\":%zu%s\"v\":[", i, sep);
+        for (size_t v = 0; v < i % 23; v++)
+        {
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, "%s%zu",
+                                    v ? "," : "", v);
+        }
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "]}\n");
+    }
+    return len;
+}
+
+
+static bool is_malformed(size_t id)
+{
+    return id % 97 == 13;
+}
+
+
+static void setup(size_t nrecs)
+{
+    memset(&res, 0, sizeof(res));
+    for (size_t w = 0; w < WORKER_MAX; w++)
+    {
+        workers[w].tkns  = pools[w];
+        workers[w].size  = TOKEN_MAX;
+        workers[w].recs  = held[w];
+        workers[w].nrecs = nrecs;
+    }
+}
+
+
+/**
+ * @brief Check a record against the id it was built with
+ */
+static bool check(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                  size_t id)
+{
+    if (is_malformed(id))
+    {
+        return rec->status == JTOK_PARSE_STATUS_VAL_NO_COMMA;
+    }
+    return rec->status == JTOK_PARSE_STATUS_OK &&
+           strtoul(&rec->json[tkns[2].start], NULL, 10) == id &&
+           (size_t)tkns[4].size == id % 23;
+}
+
+
+static bool on_ordered(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                       size_t worker, void *ctx)
+{
+    struct results *r = ctx;
+    if (worker >= WORKER_MAX || rec->index != r->next ||
+        strtoul(&rec->json[6], NULL, 10) != r->next ||
+        !check(rec, tkns, r->next))
+    {
+        r->failed++;
+    }
+    r->next++;
+    return r->stop == 0 || r->next < r->stop;
+}
+
+
+static bool on_unordered(const jtok_ndjson_rec_t *rec,
+                         const jtok_tkn_t *tkns, size_t worker, void *ctx)
+{
+    struct results *r  = ctx;
+    size_t          id = strtoul(&rec->json[6], NULL, 10);
+    if (worker >= WORKER_MAX || id >= RECORD_COUNT || !check(rec, tkns, id))
+    {
+        /* Stopping leaves records undelivered, which main reports */
+        return false;
+    }
+
+    /* Every record has its own byte and every worker its own counter */
+    r->seen[id]++;
+    r->delivered[worker]++;
+    return true;
+}
+
+#else
+
+int main(void)
+{
+    printf("\nBatch engine not built (JTOK_THREADS=0), skipped.\n");
+    return 0;
+}
+
+#endif /* #if JTOK_THREADS */
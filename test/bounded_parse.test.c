@@ -0,0 +1,81 @@
+/**
+ * @file bounded_parse.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test parsing of json buffers that are not
+ * nul-terminated
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (50u)
+
+static const char *valid_jsons[] = {
+    "{\"key\" : true}",
+    "{\"key\" : false}",
+    "{\"key\" : null}",
+    "{\"key\" : 1.001e-9}",
+    "{\"key\" : \"value\"}",
+    "{\"key\" : \"\\uABCD\"}",
+    "{\"key\" : [1, 2, 3]}",
+    "{\"key\" : {\"childKey\" : [\"a\", \"b\"]}}",
+};
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+int main(void)
+{
+    unsigned long long i;
+    unsigned long long max_i = sizeof(valid_jsons) / sizeof(*valid_jsons);
+    for (i = 0; i < max_i; i++)
+    {
+        size_t len = strlen(valid_jsons[i]);
+
+        /* Exact size heap copy without a nul terminator so an overread past
+         * the end of the buffer is caught by valgrind */
+        char *buf = malloc(len);
+        if (buf == NULL)
+        {
+            return 1;
+        }
+        memcpy(buf, valid_jsons[i], len);
+
+        printf("\n%s ... ", valid_jsons[i]);
+        JTOK_PARSE_STATUS_t status = jtok_parse_n(buf, len, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK)
+        {
+            printf("failed with status %d.\n", status);
+            free(buf);
+            return 1;
+        }
+
+        /* Every strict prefix is an incomplete json */
+        size_t k;
+        for (k = 1; k < len; k++)
+        {
+            status = jtok_parse_n(buf, k, tokens, TOKEN_MAX);
+            if (status != JTOK_PARSE_STATUS_PARTIAL_TOKEN)
+            {
+                printf("failed. prefix of length %zu has status %d.\n", k,
+                       status);
+                free(buf);
+                return 1;
+            }
+        }
+        free(buf);
+        printf("passed.\n");
+    }
+
+    if (jtok_parse_n(NULL, 0, tokens, TOKEN_MAX) != JTOK_PARSE_STATUS_NULL_PARAM)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file compact_tokens.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that a document of compact tokens describes
+ * the same tree as the regular token pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (50u)
+#define ELEMENTS (70000u)
+#define LARGE_TOKEN_MAX (80000u)
+
+static jtok_tkn_t  tokens[TOKEN_MAX];
+static jtok_ctkn_t ctokens[TOKEN_MAX];
+static jtok_ctkn_t large_ctokens[LARGE_TOKEN_MAX];
+static const char  json[] = "{\"header\":{\"id\":42,\"tags\":[\"a\",\"b\"]},"
+                           "\"body\":[{\"x\":1},{\"y\":[true,false]}],"
+                           "\"empty\":{}}";
+
+int main(void)
+{
+    jtok_doc_t          doc;
+    size_t              used;
+    JTOK_PARSE_STATUS_t status;
+
+    printf("\nChecking compact token size ... ");
+    if ((JTOK_INDEX_WIDTH == 16 && sizeof(jtok_ctkn_t) > 12) ||
+        (JTOK_INDEX_WIDTH == 32 && sizeof(jtok_ctkn_t) > 24))
+    {
+        printf("failed. %zu bytes.\n", sizeof(jtok_ctkn_t));
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nComparing compact tokens with regular tokens ... ");
+    status = jtok_parse_n_used(json, strlen(json), tokens, TOKEN_MAX, &used);
+    if (status != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed. regular parse gave status %d.\n", status);
+        return 1;
+    }
+    status = jtok_doc_parse(&doc, json, strlen(json), ctokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK || doc.count != used)
+    {
+        printf("failed. compact parse gave status %d.\n", status);
+        return 1;
+    }
+    for (size_t i = 0; i < used; i++)
+    {
+        const jtok_tkn_t * t = &tokens[i];
+        const jtok_ctkn_t *c = &ctokens[i];
+        int parent  = c->parent == JTOK_CTKN_NONE ? -1 : (int)c->parent;
+        int sibling = c->sibling == JTOK_CTKN_NONE ? -1 : (int)c->sibling;
+        if (t->start != (int)c->start || t->end != (int)c->end ||
+            t->size != (int)c->size || t->parent != parent ||
+            t->sibling != sibling || t->type != c->type ||
+            t->subtype != c->subtype)
+        {
+            printf("failed. token %zu differs.\n", i);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nNavigating the document ... ");
+    const jtok_ctkn_t *root   = jtok_doc_root(&doc);
+    const jtok_ctkn_t *header = jtok_doc_obj_has_key(&doc, root, "header");
+    const jtok_ctkn_t *id =
+        jtok_doc_obj_has_key(&doc, jtok_doc_child(&doc, header), "id");
+    const jtok_ctkn_t *body = jtok_doc_obj_has_key(&doc, root, "body");
+    const jtok_ctkn_t *arr  = jtok_doc_child(&doc, body);
+    const jtok_ctkn_t *elem = jtok_doc_child(&doc, arr);
+    if (id == NULL || !jtok_doc_tokcmp(&doc, "42", jtok_doc_child(&doc, id)) ||
+        arr == NULL || arr->size != 2 || jtok_doc_parent(&doc, elem) != arr ||
+        jtok_doc_sibling(&doc, jtok_doc_sibling(&doc, elem)) != NULL ||
+        jtok_doc_obj_has_key(&doc, root, "missing") != NULL ||
+        jtok_doc_parent(&doc, root) != NULL)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nChecking an undersized compact pool ... ");
+    status = jtok_doc_parse(&doc, json, strlen(json), ctokens, used - 1);
+    if (status != JTOK_PARSE_STATUS_NOMEM)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nParsing more than 65535 tokens ... ");
+    if (JTOK_INDEX_WIDTH == 16)
+    {
+        /* The offsets of a document that large don't fit in 16 bits */
+        printf("skipped.\n");
+        return 0;
+    }
+    char  *large = malloc(2 * ELEMENTS + 16);
+    size_t len   = (size_t)sprintf(large, "{\"a\":[");
+    for (size_t i = 0; i < ELEMENTS; i++)
+    {
+        len += (size_t)sprintf(&large[len], "%s0", (i > 0) ? "," : "");
+    }
+    len += (size_t)sprintf(&large[len], "]}");
+    status = jtok_doc_parse(&doc, large, len, large_ctokens, LARGE_TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK || doc.count != ELEMENTS + 3 ||
+        large_ctokens[2].size != ELEMENTS ||
+        large_ctokens[ELEMENTS + 2].parent != 2 ||
+        large_ctokens[ELEMENTS + 1].sibling != ELEMENTS + 2 ||
+        large_ctokens[ELEMENTS + 2].sibling != JTOK_CTKN_NONE)
+    {
+        printf("failed with status %d.\n", status);
+        free(large);
+        return 1;
+    }
+    free(large);
+    printf("passed.\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file count_tokens.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that the token count pre-pass sizes the token
+ * pool exactly
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+static const char *valid[] = {
+    "{}",
+    "{\"key\":\"value\"}",
+    "{\"a\":[1,2,3],\"b\":{\"c\":true,\"d\":null},\"e\":[]}",
+    "{\"a\":[{\"b\":1},{\"c\":[2, 3]},{}], \"s\" : \"x\\\"y\"}",
+    "  {\"deep\":[[[[[\"x\"]]]]]}  ",
+};
+
+static const char *invalid[] = {
+    "{\"a\":[1,\"2\"]}",
+    "{\"a\":}",
+    "{\"a\":1,}",
+    "[1]",
+};
+
+int main(void)
+{
+    unsigned int i;
+    for (i = 0; i < sizeof(valid) / sizeof(*valid); i++)
+    {
+        size_t              len = strlen(valid[i]);
+        size_t              count;
+        JTOK_PARSE_STATUS_t status;
+        printf("\nCounting tokens of %s ... ", valid[i]);
+        status = jtok_count_tokens(valid[i], len, &count);
+        if (status != JTOK_PARSE_STATUS_OK)
+        {
+            printf("failed with status %d.\n", status);
+            return 1;
+        }
+
+        /* An exact-size pool must succeed and a smaller one must not */
+        jtok_tkn_t *tkns = malloc(count * sizeof(*tkns));
+        status           = jtok_parse_n(valid[i], len, tkns, count);
+        free(tkns);
+        if (status != JTOK_PARSE_STATUS_OK)
+        {
+            printf("failed. exact pool of %zu gave status %d.\n", count,
+                   status);
+            return 1;
+        }
+
+        if (count > 1)
+        {
+            tkns   = malloc((count - 1) * sizeof(*tkns));
+            status = jtok_parse_n(valid[i], len, tkns, count - 1);
+            free(tkns);
+            if (status != JTOK_PARSE_STATUS_NOMEM)
+            {
+                printf("failed. pool of %zu did not run out.\n", count - 1);
+                return 1;
+            }
+        }
+        printf("passed with %zu tokens.\n", count);
+    }
+
+    for (i = 0; i < sizeof(invalid) / sizeof(*invalid); i++)
+    {
+        jtok_tkn_t          tkns[20];
+        size_t              count;
+        JTOK_PARSE_STATUS_t expected;
+        JTOK_PARSE_STATUS_t status;
+        printf("\nCounting tokens of %s ... ", invalid[i]);
+        expected = jtok_parse(invalid[i], tkns, 20);
+        status   = jtok_count_tokens(invalid[i], strlen(invalid[i]), &count);
+        if (status != expected || status == JTOK_PARSE_STATUS_OK)
+        {
+            printf("failed. got status %d, expected %d.\n", status, expected);
+            return 1;
+        }
+        printf("passed.\n");
+    }
+    return 0;
+}
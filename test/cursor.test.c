@@ -0,0 +1,319 @@
+/**
+ * @file cursor.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that the on-demand cursor finds the same
+ * values and reports the same errors as jtok_parse
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (100u)
+#define RANDOM_DOCS (300u)
+#define RANDOM_TOKEN_MAX (4096u)
+#define RANDOM_DOC_MAX (1u << 20)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static jtok_tkn_t random_tokens[RANDOM_TOKEN_MAX];
+static char       random_doc[RANDOM_DOC_MAX];
+
+/* Skipped values contain brackets and quotes inside strings, escapes and a
+ * run long enough to span several blocks of the structural index */
+static const char json[] =
+    "{ \"skip\" : {\"a\":\"}]\\\"{\", \"b\":[[1],[{\"c\":'x'}]]},"
+    "  \"pad\" : \"................................................"
+    "................................................................\","
+    "  \"header\" : { \"id\" : 42, \"name\" : \"sensor\" },"
+    "  \"values\" : [1.5, -2, 3e4],"
+    "  \"empty\" : [] }";
+
+struct error_case
+{
+    const char *json;
+    const char *key;
+};
+
+static const struct error_case errors[] = {
+    {"{\"a\":1 \"b\":2}", "b"},
+    {"{\"a\" 1}", "a"},
+    {"{\"a\":1,}", "b"},
+    {"{\"\":1}", "a"},
+    {"{\"a\":[1,2}", "b"},
+    {"{\"a\":tru}", "a"},
+    {"{\"a\":\"open", "a"},
+    {"[1]", "a"},
+};
+
+static bool compare_with_parse(const char *str, jtok_tkn_t *pool,
+                               unsigned int size);
+static void gen_value(char *buf, size_t *len, int depth);
+static void gen_kind(char *buf, size_t *len, int depth, int kind);
+static void gen_string(char *buf, size_t *len, char quote);
+
+int main(void)
+{
+    jtok_cursor_t       root;
+    jtok_cursor_t       header;
+    jtok_cursor_t       val;
+    JTOK_PARSE_STATUS_t status;
+
+    printf("\nReading fields with the cursor ... ");
+    status = jtok_cursor_init(&root, json, strlen(json));
+    if (status != JTOK_PARSE_STATUS_OK || root.type != JTOK_OBJECT)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    if (jtok_cursor_find_key(&root, "header", &header) !=
+            JTOK_PARSE_STATUS_OK ||
+        header.type != JTOK_OBJECT ||
+        jtok_cursor_find_key(&header, "name", &val) != JTOK_PARSE_STATUS_OK ||
+        val.type != JTOK_STRING || !jtok_cursor_tokcmp("sensor", &val) ||
+        jtok_cursor_find_key(&header, "id", &val) != JTOK_PARSE_STATUS_OK ||
+        val.type != JTOK_PRIMITIVE || !jtok_cursor_tokcmp("42", &val))
+    {
+        printf("failed to read header.\n");
+        return 1;
+    }
+    if (jtok_cursor_find_key(&root, "missing", &val) != JTOK_PARSE_STATUS_OK ||
+        val.type != JTOK_UNASSIGNED_TOKEN)
+    {
+        printf("failed. found a missing key.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nComparing with jtok_parse ... ");
+    if (!compare_with_parse(json, tokens, TOKEN_MAX))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nSkipping random values with every kernel ... ");
+    srand(97);
+    for (unsigned int d = 0; d < RANDOM_DOCS; d++)
+    {
+        size_t len = 0;
+        random_doc[len++] = '{';
+        for (int k = 0; k < 8; k++)
+        {
+            len += (size_t)sprintf(&random_doc[len], "%s\"k%d\":",
+                                   k ? "," : "", k);
+            gen_value(random_doc, &len, 0);
+        }
+        random_doc[len++] = '}';
+        random_doc[len]   = '\0';
+        for (int kernel = JTOK_KERNEL_SCALAR; kernel <= JTOK_KERNEL_AVX2;
+             kernel++)
+        {
+            if (jtok_set_kernel((JTOK_KERNEL_t)kernel) &&
+                !compare_with_parse(random_doc, random_tokens,
+                                    RANDOM_TOKEN_MAX))
+            {
+                printf("with kernel %s for %s\n",
+                       jtok_kernel_name((JTOK_KERNEL_t)kernel), random_doc);
+                return 1;
+            }
+        }
+    }
+    jtok_init();
+    printf("passed.\n");
+
+    printf("\nIterating over arrays ... ");
+    jtok_cursor_t arr;
+    jtok_cursor_t elem;
+    const char *  expected[] = {"1.5", "-2", "3e4"};
+    unsigned int  n          = 0;
+    jtok_cursor_find_key(&root, "values", &arr);
+    for (status = jtok_cursor_first(&arr, &elem);
+         status == JTOK_PARSE_STATUS_OK && elem.type != JTOK_UNASSIGNED_TOKEN;
+         status = jtok_cursor_next(&elem))
+    {
+        if (n >= 3 || !jtok_cursor_tokcmp(expected[n++], &elem))
+        {
+            printf("failed at element %u.\n", n);
+            return 1;
+        }
+    }
+    jtok_cursor_find_key(&root, "empty", &arr);
+    if (status != JTOK_PARSE_STATUS_OK || n != 3 ||
+        jtok_cursor_first(&arr, &elem) != JTOK_PARSE_STATUS_OK ||
+        elem.type != JTOK_UNASSIGNED_TOKEN)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    for (unsigned int i = 0; i < sizeof(errors) / sizeof(*errors); i++)
+    {
+        JTOK_PARSE_STATUS_t expected_status;
+        printf("\nLooking up \"%s\" in %s ... ", errors[i].key, errors[i].json);
+        expected_status = jtok_parse(errors[i].json, tokens, TOKEN_MAX);
+        status          = jtok_cursor_init(&root, errors[i].json,
+                                  strlen(errors[i].json));
+        if (status == JTOK_PARSE_STATUS_OK)
+        {
+            status = jtok_cursor_find_key(&root, errors[i].key, &val);
+        }
+        if (status != expected_status)
+        {
+            printf("failed. got %s, expected %s.\n",
+                   jtok_jtokerr_messages(status),
+                   jtok_jtokerr_messages(expected_status));
+            return 1;
+        }
+        printf("passed.\n");
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Check that the cursor finds the keys and values jtok_parse finds
+ *
+ * @return true if it does
+ */
+static bool compare_with_parse(const char *str, jtok_tkn_t *pool,
+                               unsigned int size)
+{
+    jtok_cursor_t       root;
+    jtok_cursor_t       key;
+    jtok_cursor_t       val;
+    jtok_tkn_t *        tkey;
+    JTOK_PARSE_STATUS_t status;
+    if (jtok_parse(str, pool, size) != JTOK_PARSE_STATUS_OK ||
+        jtok_cursor_init(&root, str, strlen(str)) != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed to parse.\n");
+        return false;
+    }
+    tkey   = jtok_get_child(&pool[0]);
+    status = jtok_cursor_first(&root, &key);
+    while (tkey != NULL)
+    {
+        jtok_tkn_t *tval = jtok_get_child(tkey);
+        if (status != JTOK_PARSE_STATUS_OK || !key.key ||
+            key.start != tkey->start || key.end != tkey->end ||
+            jtok_cursor_value(&key, &val) != JTOK_PARSE_STATUS_OK ||
+            val.type != tval->type || val.start != tval->start ||
+            jtok_cursor_toklen(&val) != jtok_toklen(tval))
+        {
+            printf("failed at key %d.\n", tkey->start);
+            return false;
+        }
+        tkey   = jtok_get_next_sibling(tkey);
+        status = jtok_cursor_next(&key);
+    }
+    if (status != JTOK_PARSE_STATUS_OK || key.type != JTOK_UNASSIGNED_TOKEN)
+    {
+        printf("failed. cursor has extra keys.\n");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Append a random value, padded with up to 70 spaces so brackets and
+ * quotes land anywhere in the 64 char blocks
+ */
+static void gen_value(char *buf, size_t *len, int depth)
+{
+    gen_kind(buf, len, depth, rand() % ((depth < 3) ? 6 : 4));
+}
+
+
+/**
+ * @brief Append a random value of a kind: number, string in either quotes,
+ * literal, array or object. The elements of arrays are all of one kind
+ */
+static void gen_kind(char *buf, size_t *len, int depth, int kind)
+{
+    int pad = rand() % 71;
+    memset(&buf[*len], ' ', (size_t)pad);
+    *len += (size_t)pad;
+    switch (kind)
+    {
+        case 0:
+        {
+            *len += (size_t)sprintf(&buf[*len], "%d", rand() % 1000);
+        }
+        break;
+        case 1:
+        {
+            gen_string(buf, len, '\"');
+        }
+        break;
+        case 2:
+        {
+            gen_string(buf, len, '\'');
+        }
+        break;
+        case 3:
+        {
+            *len += (size_t)sprintf(&buf[*len], "null");
+        }
+        break;
+        case 4:
+        {
+            int n    = rand() % 5;
+            int elem = rand() % ((depth < 2) ? 6 : 4);
+            buf[(*len)++] = '[';
+            for (int i = 0; i < n; i++)
+            {
+                if (i > 0)
+                {
+                    buf[(*len)++] = ',';
+                }
+                gen_kind(buf, len, depth + 1, elem);
+            }
+            buf[(*len)++] = ']';
+        }
+        break;
+        default:
+        {
+            int n = rand() % 5;
+            buf[(*len)++] = '{';
+            for (int i = 0; i < n; i++)
+            {
+                *len += (size_t)sprintf(&buf[*len], "%s\"k%d\":",
+                                        (i > 0) ? "," : "", i);
+                gen_value(buf, len, depth + 1);
+            }
+            buf[(*len)++] = '}';
+        }
+        break;
+    }
+}
+
+
+/**
+ * @brief Append a random string of brackets, escapes, quotes of the other
+ * kind and plain chars
+ */
+static void gen_string(char *buf, size_t *len, char quote)
+{
+    static const char *const pieces[] = {"a", "{", "}", "[", "]", ",", ":",
+                                         "\\\"", "\\\\", " "};
+    int n = rand() % 90;
+    buf[(*len)++] = quote;
+    for (int i = 0; i < n; i++)
+    {
+        const char *piece = pieces[rand() % (sizeof(pieces) / sizeof(*pieces))];
+        if (rand() % 8 == 0)
+        {
+            piece = (quote == '\"') ? "'" : "\"";
+        }
+        *len += (size_t)sprintf(&buf[*len], "%s", piece);
+    }
+    buf[(*len)++] = quote;
+}
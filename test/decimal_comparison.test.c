@@ -0,0 +1,197 @@
+/**
+ * @file decimal_comparison.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that number tokens are compared exactly,
+ * digit by digit, whatever their sign, zeros, decimal point and exponent
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (8u)
+#define RANDOM_NUMBERS (50000u)
+#define DIGITS_MAX (40)
+#define VALUE_MAX (128)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+static const struct
+{
+    const char *value1;
+    const char *value2;
+    bool        equal;
+} cmp_table[] = {
+    {"1", "1.0", true},
+    {"1", "10e-1", true},
+    {"1.0", "10e-1", true},
+    {"+1", "0001.000e0", true},
+    {"0", "-0", true},
+    {"0", "0.000e-99", true},
+    {"-0.0", "0E+12", true},
+    {"120", "1.2e2", true},
+    {"120", "1200e-1", true},
+    {"0.0012", "12e-4", true},
+    {"0.0012", "0.00120E0", true},
+    {"-3.25", "-325e-2", true},
+    {"123456789012345678901234567890", "1.2345678901234567890123456789e29",
+     true},
+    {"0.100000000000000000000000000001", "100000000000000000000000000001e-30",
+     true},
+    {"1e100000", "10e99999", true},
+    {"1e99999999999999999999", "1e0099999999999999999999", true},
+    {"1e100000000000000000", "10e99999999999999999", true},
+    {"100e-100000000000000000001", "1e-99999999999999999999", true},
+    {"0.001e100000000000000000002", "1e099999999999999999999", true},
+    {"1", "2", false},
+    {"1", "-1", false},
+    {"1", "1.0000000000000000000000001", false},
+    {"1e-400", "0", false},
+    {"0.1", "0.01", false},
+    {"10", "1", false},
+    {"12", "1.2", false},
+    {"12", "123", false},
+    {"123", "12", false},
+    {"1.5", "15", false},
+    {"123456789012345678901234567890", "123456789012345678901234567891",
+     false},
+    {"1e100000", "1e100001", false},
+    {"1e99999999999999999999", "1e99999999999999999998", false},
+    {"1e-99999999999999999999", "1e-99999999999999999998", false},
+    {"1e99999999999999999999", "1e-99999999999999999999", false},
+    {"1e99999999999999999999", "1e99999999999999999", false},
+    {"1", "true", false},
+    {"0", "null", false},
+    {"1", "\"1\"", false},
+};
+
+static bool compare(const char *value1, const char *value2, char *json,
+                    size_t size, bool *equal);
+static void render(char *value, size_t size, const char *digits, int exp10,
+                   bool negative);
+
+int main(void)
+{
+    char json[2 * VALUE_MAX + 16];
+    bool equal;
+
+    printf("\nComparing numbers ... ");
+    for (size_t i = 0; i < sizeof(cmp_table) / sizeof(*cmp_table); i++)
+    {
+        if (!compare(cmp_table[i].value1, cmp_table[i].value2, json,
+                     sizeof(json), &equal) ||
+            equal != cmp_table[i].equal ||
+            !compare(cmp_table[i].value2, cmp_table[i].value1, json,
+                     sizeof(json), &equal) ||
+            equal != cmp_table[i].equal)
+        {
+            printf("failed for %s and %s.\n", cmp_table[i].value1,
+                   cmp_table[i].value2);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nComparing random spellings of random numbers ... ");
+    srand(2468);
+    for (size_t i = 0; i < RANDOM_NUMBERS; i++)
+    {
+        char digits[DIGITS_MAX + 1];
+        char other[DIGITS_MAX + 1];
+        char value1[VALUE_MAX];
+        char value2[VALUE_MAX];
+        int  count    = 1 + rand() % (DIGITS_MAX - 1);
+        int  exp10    = rand() % 60 - 30;
+        bool negative = rand() % 2;
+        int  changed  = rand() % count;
+
+        /* No leading or trailing zeros */
+        for (int d = 0; d < count; d++)
+        {
+            digits[d] = (char)('0' + rand() % 10);
+        }
+        digits[0]         = (char)('1' + rand() % 9);
+        digits[count - 1] = (char)('1' + rand() % 9);
+        digits[count]     = '\0';
+
+        render(value1, sizeof(value1), digits, exp10, negative);
+        render(value2, sizeof(value2), digits, exp10, negative);
+        if (!compare(value1, value2, json, sizeof(json), &equal) || !equal)
+        {
+            printf("failed for %s and %s.\n", value1, value2);
+            return 1;
+        }
+
+        /* One digit, the exponent or the sign differs */
+        strcpy(other, digits);
+        other[changed] = (char)('0' + (other[changed] - '0' + 1) % 10);
+        if (other[0] == '0' || other[count - 1] == '0')
+        {
+            render(value2, sizeof(value2), digits, exp10 + 1, negative);
+        }
+        else if (rand() % 8 == 0)
+        {
+            render(value2, sizeof(value2), digits, exp10, !negative);
+        }
+        else
+        {
+            render(value2, sizeof(value2), other, exp10, negative);
+        }
+        if (!compare(value1, value2, json, sizeof(json), &equal) || equal)
+        {
+            printf("failed for %s and %s.\n", value1, value2);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Compare the values of two number tokens
+ *
+ * @return true if both parsed
+ */
+static bool compare(const char *value1, const char *value2, char *json,
+                    size_t size, bool *equal)
+{
+    snprintf(json, size, "{\"a\":%s,\"b\":%s}", value1, value2);
+    if (jtok_parse(json, tokens, TOKEN_MAX) != JTOK_PARSE_STATUS_OK)
+    {
+        return false;
+    }
+    *equal = jtok_toktokcmp(&tokens[2], &tokens[4]);
+    return true;
+}
+
+
+/**
+ * @brief Spell digits * 10^exp10 with random leading and trailing zeros, a
+ * random decimal point and the exponent that makes up for them
+ */
+static void render(char *value, size_t size, const char *digits, int exp10,
+                   bool negative)
+{
+    char mantissa[96];
+    int  lead  = rand() % 4;
+    int  trail = rand() % 4;
+    int  len;
+    int  point;
+
+    len = snprintf(mantissa, sizeof(mantissa), "%.*s%s%.*s", lead, "000",
+                   digits, trail, "000");
+
+    /* A point after the first point chars leaves len - point decimals */
+    point = 1 + rand() % len;
+    exp10 = exp10 - trail + (len - point);
+    snprintf(value, size, "%s%.*s%s%s%s%d", negative ? "-" : "", point,
+             mantissa, (point < len) ? "." : "", &mantissa[point],
+             (rand() % 2) ? "e" : "E", exp10);
+}
@@ -0,0 +1,231 @@
+/**
+ * @file fixed_point.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test converting number tokens to fixed-point
+ * values with integer arithmetic only
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (8u)
+#define RANDOM_NUMBERS (100000u)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+static const struct
+{
+    const char *value;
+    bool        ok;
+    int32_t     expected;
+} q16_16_table[] = {
+    {"0", true, 0},
+    {"-0.0", true, 0},
+    {"1", true, 65536},
+    {"-1", true, -65536},
+    {"0.5", true, 32768},
+    {"1.5e0", true, 98304},
+    {"0.1", true, 6554},
+    {"-0.1", true, -6554},
+    {"3.14159", true, 205887},
+    {"-2.718281828", true, -178145},
+    {"1e-5", true, 1},
+    {"7.62939453125e-6", true, 1},
+    {"-7.62939453125e-6", true, -1},
+    {"7.62939453124e-6", true, 0},
+    {"3.0517578125e-5", true, 2},
+    {"1e-30", true, 0},
+    {"12345678901234567890e-15", true, 809086412},
+    {"1e4", true, 655360000},
+    {"32767.99999", true, INT32_MAX},
+    {"-32768", true, INT32_MIN},
+    {"-32768.000001", true, INT32_MIN},
+    {"32767.99999999", false, 0},
+    {"32768", false, 0},
+    {"-32768.00001", false, 0},
+    {"1e5", false, 0},
+    {"1e100000", false, 0},
+    {"true", false, 0},
+    {"\"1\"", false, 0},
+};
+
+static const struct
+{
+    const char * value;
+    unsigned int decimals;
+    bool         ok;
+    int64_t      expected;
+} scaled_table[] = {
+    {"12.345", 2, true, 1235},
+    {"12.344", 2, true, 1234},
+    {"-12.345", 2, true, -1235},
+    {"1e3", 0, true, 1000},
+    {"1.5", 0, true, 2},
+    {"-2.5", 0, true, -3},
+    {"0.004", 2, true, 0},
+    {"0.005", 2, true, 1},
+    {"5e-20", 19, true, 1},
+    {"1e-40", 10, true, 0},
+    {"0", 1000, true, 0},
+    {"1", 18, true, 1000000000000000000},
+    {"9223372036854775807", 0, true, INT64_MAX},
+    {"-9223372036854775808", 0, true, INT64_MIN},
+    {"92233720368547758.07", 2, true, INT64_MAX},
+    {"9223372036854775808", 0, false, 0},
+    {"1", 19, false, 0},
+    {"null", 0, false, 0},
+};
+
+static const struct
+{
+    const char *json;
+    bool        equal;
+} cmp_table[] = {
+    {"{\"a\":1.50,\"b\":15e-1}", true},
+    {"{\"a\":-0.0,\"b\":0e7}", true},
+    {"{\"a\":100,\"b\":1E+2}", true},
+    {"{\"a\":0.001230,\"b\":123e-5}", true},
+    {"{\"a\":1234567890123456789e-9,\"b\":1234567890.123456789}", true},
+    {"{\"a\":1.5,\"b\":-1.5}", false},
+    {"{\"a\":1.000001,\"b\":1.0}", false},
+    {"{\"a\":1e-400,\"b\":0.0}", false},
+    {"{\"a\":0.1000000000000000000001,\"b\":0.1}", false},
+};
+
+static bool parse_value(const char *value, char *json, size_t size);
+
+int main(void)
+{
+    char    json[128];
+    int32_t q16;
+    int64_t scaled;
+
+    printf("\nConverting to Q16.16 ... ");
+    for (size_t i = 0; i < sizeof(q16_16_table) / sizeof(*q16_16_table); i++)
+    {
+        q16 = 7;
+        if (!parse_value(q16_16_table[i].value, json, sizeof(json)) ||
+            jtok_tok_to_q16_16(&tokens[2], &q16) != q16_16_table[i].ok ||
+            q16 != (q16_16_table[i].ok ? q16_16_table[i].expected : 7))
+        {
+            printf("failed for %s.\n", q16_16_table[i].value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nConverting to scaled decimals ... ");
+    for (size_t i = 0; i < sizeof(scaled_table) / sizeof(*scaled_table); i++)
+    {
+        scaled = 7;
+        if (!parse_value(scaled_table[i].value, json, sizeof(json)) ||
+            jtok_tok_to_scaled(&tokens[2], scaled_table[i].decimals,
+                               &scaled) != scaled_table[i].ok ||
+            scaled != (scaled_table[i].ok ? scaled_table[i].expected : 7))
+        {
+            printf("failed for %s.\n", scaled_table[i].value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nConverting random numbers ... ");
+    srand(4321);
+    for (size_t i = 0; i < RANDOM_NUMBERS; i++)
+    {
+        char         value[64];
+        bool         negative = rand() % 2;
+        uint64_t     integer  = (uint64_t)(rand() % 40000);
+        unsigned int digits   = (unsigned int)(rand() % 10);
+        unsigned int decimals = (unsigned int)(rand() % 7);
+        uint64_t     pow10    = 1;
+        uint64_t     fraction = 0;
+        uint64_t     magnitude;
+        uint64_t     want_q16;
+        uint64_t     want_scaled;
+        bool         fits;
+        for (unsigned int d = 0; d < digits; d++)
+        {
+            pow10 *= 10;
+            fraction = fraction * 10 + (uint64_t)(rand() % 10);
+        }
+        magnitude = integer * pow10 + fraction;
+        if (rand() % 2)
+        {
+            snprintf(value, sizeof(value), "%s%llu.%0*llue0",
+                     negative ? "-" : "", (unsigned long long)integer,
+                     (int)digits, (unsigned long long)fraction);
+        }
+        else
+        {
+            snprintf(value, sizeof(value), "%s%llue-%u", negative ? "-" : "",
+                     (unsigned long long)magnitude, digits);
+        }
+
+        /* Round half away from zero */
+        want_q16 = (2 * magnitude * 65536 + pow10) / (2 * pow10);
+        fits     = (want_q16 <= (uint64_t)INT32_MAX + negative);
+        if (decimals >= digits)
+        {
+            want_scaled = magnitude;
+            for (unsigned int d = digits; d < decimals; d++)
+            {
+                want_scaled *= 10;
+            }
+        }
+        else
+        {
+            uint64_t denom = pow10;
+            for (unsigned int d = 0; d < decimals; d++)
+            {
+                denom /= 10;
+            }
+            want_scaled = (2 * magnitude + denom) / (2 * denom);
+        }
+
+        if (!parse_value(value, json, sizeof(json)) ||
+            jtok_tok_to_q16_16(&tokens[2], &q16) != fits ||
+            (fits &&
+             q16 != (negative ? -(int64_t)want_q16 : (int64_t)want_q16)) ||
+            !jtok_tok_to_scaled(&tokens[2], decimals, &scaled) ||
+            scaled !=
+                (negative ? -(int64_t)want_scaled : (int64_t)want_scaled))
+        {
+            printf("failed for %s.\n", value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nComparing numbers ... ");
+    for (size_t i = 0; i < sizeof(cmp_table) / sizeof(*cmp_table); i++)
+    {
+        if (jtok_parse(cmp_table[i].json, tokens, TOKEN_MAX) !=
+                JTOK_PARSE_STATUS_OK ||
+            jtok_toktokcmp(&tokens[2], &tokens[4]) != cmp_table[i].equal)
+        {
+            printf("failed for %s.\n", cmp_table[i].json);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Parse {"k":value} into the tokens
+ *
+ * @return true if parsed
+ */
+static bool parse_value(const char *value, char *json, size_t size)
+{
+    snprintf(json, size, "{\"k\":%s}", value);
+    return jtok_parse(json, tokens, TOKEN_MAX) == JTOK_PARSE_STATUS_OK;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file incremental_parse.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test resumable parsing of jsons that arrive in
+ * chunks
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (100u)
+#define DEPTH_MAX (10u)
+
+static const char *valid_jsons[] = {
+    "  {\"key\" : true}",
+    "{\"key\" : [1, -2.5e+3, null, false]}",
+    "{\"key\" : \"a long string value with \\\"escapes\\\" and \\uABCD\"}",
+    "{\"a\" : {\"b\" : [{\"c\" : 'single'}, {\"d\" : {}}]}, \"e\" : []}",
+};
+
+static jtok_tkn_t   expected[TOKEN_MAX];
+static jtok_tkn_t   tokens[TOKEN_MAX];
+static jtok_frame_t frames[DEPTH_MAX];
+
+static int tokens_match(int count);
+
+int main(void)
+{
+    static const size_t chunk_sizes[] = {1, 2, 3, 7, 64};
+    unsigned long long  i;
+    unsigned long long  max_i = sizeof(valid_jsons) / sizeof(*valid_jsons);
+    for (i = 0; i < max_i; i++)
+    {
+        const char *json = valid_jsons[i];
+        size_t      len  = strlen(json);
+        if (jtok_parse_n(json, len, expected, TOKEN_MAX) !=
+            JTOK_PARSE_STATUS_OK)
+        {
+            printf("\n%s is not a valid json!!\n", json);
+            return 1;
+        }
+
+        size_t c;
+        for (c = 0; c < sizeof(chunk_sizes) / sizeof(*chunk_sizes); c++)
+        {
+            printf("\nFeeding %s in chunks of %zu ... ", json, chunk_sizes[c]);
+            jtok_parser_t       parser;
+            JTOK_PARSE_STATUS_t status;
+            status = jtok_parser_init(&parser, tokens, TOKEN_MAX, frames,
+                                      DEPTH_MAX);
+            if (status != JTOK_PARSE_STATUS_OK)
+            {
+                printf("init failed with status %d.\n", status);
+                return 1;
+            }
+
+            size_t received = 0;
+            while (received < len)
+            {
+                received += chunk_sizes[c];
+                if (received > len)
+                {
+                    received = len;
+                }
+
+                status = jtok_parser_feed(&parser, json, received);
+                if (received < len && status != JTOK_PARSE_STATUS_PARTIAL_TOKEN)
+                {
+                    printf("failed after %zu chars with status %d.\n",
+                           received, status);
+                    return 1;
+                }
+            }
+
+            if (status != JTOK_PARSE_STATUS_OK)
+            {
+                printf("failed with status %d.\n", status);
+                return 1;
+            }
+
+            if (!tokens_match(parser.toknext))
+            {
+                printf("failed. tokens differ from single pass parse.\n");
+                return 1;
+            }
+            printf("passed.\n");
+        }
+    }
+
+    /* Errors are sticky */
+    jtok_parser_t parser;
+    jtok_parser_init(&parser, tokens, TOKEN_MAX, frames, DEPTH_MAX);
+    if (jtok_parser_feed(&parser, "{\"key\" 1", 8) !=
+            JTOK_PARSE_STATUS_KEY_NO_VAL ||
+        jtok_parser_feed(&parser, "{\"key\" 1}", 9) !=
+            JTOK_PARSE_STATUS_KEY_NO_VAL)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+
+static int tokens_match(int count)
+{
+    int t;
+    for (t = 0; t < count; t++)
+    {
+        if (tokens[t].type != expected[t].type ||
+            tokens[t].start != expected[t].start ||
+            tokens[t].end != expected[t].end ||
+            tokens[t].size != expected[t].size ||
+            tokens[t].parent != expected[t].parent ||
+            tokens[t].sibling != expected[t].sibling)
+        {
+            return 0;
+        }
+    }
+    return expected[count].type == JTOK_UNASSIGNED_TOKEN;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file kernel_dispatch.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that every scanning kernel the CPU supports
+ * can be selected and gives the same tokens as the scalar kernel
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (64u)
+
+static const char *jsons[] = {
+    "{\"key\" : \"a string longer than one vector with an \\\"escape\\\" in "
+    "the middle and a \\u00e9 at the end, plus 'other' quotes\"}",
+    "{\n    \"a\" : [1, 2.5, -3e+2],\n    \"b\" : {\"c\" : null},\n"
+    "                                                                  "
+    "    \"d\" : 'single \"quoted\" string'\n}",
+    "{\"x\":[{\"y\":true},{\"y\":false}],\"z\":\"\\\\\"}",
+    "{\"bad\" : \"escape at the end of a long string \\q\"}",
+};
+
+static jtok_tkn_t expected[TOKEN_MAX];
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+int main(void)
+{
+    JTOK_KERNEL_t best = jtok_init();
+
+    printf("\nSelected the %s kernel ... ", jtok_kernel_name(best));
+    if (jtok_get_kernel() != best || !jtok_set_kernel(JTOK_KERNEL_SCALAR) ||
+        jtok_get_kernel() != JTOK_KERNEL_SCALAR ||
+        jtok_set_kernel((JTOK_KERNEL_t)42) ||
+        jtok_get_kernel() != JTOK_KERNEL_SCALAR ||
+        strcmp(jtok_kernel_name((JTOK_KERNEL_t)42), "unknown") != 0)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    for (int k = JTOK_KERNEL_SCALAR; k <= JTOK_KERNEL_AVX2; k++)
+    {
+        JTOK_KERNEL_t kernel = (JTOK_KERNEL_t)k;
+        printf("\nParsing with the %s kernel ... ", jtok_kernel_name(kernel));
+        if (!jtok_set_kernel(kernel))
+        {
+            if (kernel == JTOK_KERNEL_SCALAR || kernel == best)
+            {
+                printf("failed. could not select it.\n");
+                return 1;
+            }
+            printf("not supported, skipped.\n");
+            continue;
+        }
+
+        for (size_t i = 0; i < sizeof(jsons) / sizeof(*jsons); i++)
+        {
+            JTOK_PARSE_STATUS_t want;
+            JTOK_PARSE_STATUS_t got;
+            size_t              want_used = 0;
+            size_t              got_used  = 0;
+
+            jtok_set_kernel(JTOK_KERNEL_SCALAR);
+            want = jtok_parse_n_used(jsons[i], strlen(jsons[i]), expected,
+                                     TOKEN_MAX, &want_used);
+            jtok_set_kernel(kernel);
+            got = jtok_parse_n_used(jsons[i], strlen(jsons[i]), tokens,
+                                    TOKEN_MAX, &got_used);
+            if (got != want || got_used != want_used)
+            {
+                printf("failed on json %zu with status %d.\n", i, got);
+                return 1;
+            }
+            for (size_t t = 0; t < got_used; t++)
+            {
+                if (tokens[t].type != expected[t].type ||
+                    tokens[t].start != expected[t].start ||
+                    tokens[t].end != expected[t].end ||
+                    tokens[t].size != expected[t].size)
+                {
+                    printf("failed on json %zu token %zu.\n", i, t);
+                    return 1;
+                }
+            }
+        }
+        printf("passed.\n");
+    }
+
+    jtok_set_kernel(best);
+    return 0;
+}
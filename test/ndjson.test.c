@@ -0,0 +1,125 @@
+/**
+ * @file ndjson.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that newline-delimited json buffers are
+ * parsed one record at a time and resync after malformed records
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (16u)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+/* Not nul-terminated between records, with blank lines, CRLF endings, a
+ * record cut off before the next one and a record with trailing garbage */
+static const char buf[] = "{\"id\":0}\n"
+                          "\n"
+                          "  {\"id\":1, \"v\":[1,2]}\r\n"
+                          "{\"id\":2, \"v\":\n"
+                          "{\"id\":3}\n"
+                          "{\"id\":4} x\n"
+                          "   \t\n"
+                          "{\"id\":5}";
+
+static const JTOK_PARSE_STATUS_t expected[] = {
+    JTOK_PARSE_STATUS_OK,            JTOK_PARSE_STATUS_OK,
+    JTOK_PARSE_STATUS_PARTIAL_TOKEN, JTOK_PARSE_STATUS_OK,
+    JTOK_PARSE_STATUS_INVAL,         JTOK_PARSE_STATUS_OK,
+};
+
+static const char *const ids[] = {"0", "1", NULL, "3", NULL, "5"};
+
+struct results
+{
+    size_t count;
+    size_t failed;
+    size_t limit; /* number of records before the callback stops */
+};
+
+static bool on_record(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                      void *ctx);
+
+int main(void)
+{
+    struct results      res = {0, 0, SIZE_MAX};
+    size_t              consumed;
+    JTOK_PARSE_STATUS_t status;
+
+    printf("\nParsing records with a callback ... ");
+    status = jtok_ndjson_parse(buf, strlen(buf), tokens, TOKEN_MAX, on_record,
+                               &res, &consumed);
+    if (status != JTOK_PARSE_STATUS_PARTIAL_TOKEN || res.failed != 0 ||
+        res.count != sizeof(expected) / sizeof(*expected) ||
+        consumed != strlen(buf))
+    {
+        printf("failed with status %d after %zu records.\n", status,
+               res.count);
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nCarrying over a record that is cut off ... ");
+    {
+        static const char  stream[] = "{\"a\":1}\n{\"a\":[1,";
+        jtok_ndjson_t      nd;
+        jtok_ndjson_rec_t  rec;
+        jtok_ndjson_init(&nd, stream, strlen(stream));
+        if (!jtok_ndjson_next(&nd, tokens, TOKEN_MAX, &rec) ||
+            rec.status != JTOK_PARSE_STATUS_OK || rec.used != 3 ||
+            tokens[3].type != JTOK_UNASSIGNED_TOKEN)
+        {
+            printf("failed. bad first record.\n");
+            return 1;
+        }
+        if (jtok_ndjson_next(&nd, tokens, TOKEN_MAX, &rec) ||
+            nd.pos != strlen("{\"a\":1}\n") || nd.records != 1)
+        {
+            printf("failed. consumed the partial record.\n");
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nStopping early from the callback ... ");
+    res.count  = 0;
+    res.failed = 0;
+    res.limit  = 2;
+    status = jtok_ndjson_parse(buf, strlen(buf), tokens, TOKEN_MAX, on_record,
+                               &res, &consumed);
+    if (status != JTOK_PARSE_STATUS_OK || res.count != 2 || res.failed != 0 ||
+        consumed != (size_t)(strstr(buf, "{\"id\":2") - buf))
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+static bool on_record(const jtok_ndjson_rec_t *rec, const jtok_tkn_t *tkns,
+                      void *ctx)
+{
+    struct results *res = ctx;
+    if (rec->index != res->count || rec->status != expected[rec->index])
+    {
+        res->failed++;
+    }
+    else if (rec->status == JTOK_PARSE_STATUS_OK &&
+             (!jtok_tokcmp("id", &tkns[1]) ||
+              !jtok_tokcmp(ids[rec->index], &tkns[2])))
+    {
+        res->failed++;
+    }
+    res->count++;
+    return res->count < res->limit;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file nesting_stack.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test parsing with a caller-provided nesting stack
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (300u)
+#define NEST_DEPTH (100u)
+#define JSON_STRLEN (2 * NEST_DEPTH + 16)
+
+static jtok_tkn_t   tokens[TOKEN_MAX];
+static jtok_frame_t frames[NEST_DEPTH + 1];
+static char         json[JSON_STRLEN];
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    unsigned int        i;
+
+    /* {"key":[[[ ... ]]]} */
+    strcpy(json, "{\"key\":");
+    for (i = 0; i < NEST_DEPTH; i++)
+    {
+        strcat(json, "[");
+    }
+    for (i = 0; i < NEST_DEPTH; i++)
+    {
+        strcat(json, "]");
+    }
+    strcat(json, "}");
+
+    printf("\nParsing %u nested arrays with %u frames ... ", NEST_DEPTH,
+           NEST_DEPTH + 1);
+    status = jtok_parse_with_stack(json, tokens, TOKEN_MAX, frames,
+                                   NEST_DEPTH + 1);
+    if (status != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    for (i = 0; i < NEST_DEPTH; i++)
+    {
+        /* token 0 is the object, token 1 the key, arrays follow */
+        if (tokens[2 + i].type != JTOK_ARRAY ||
+            tokens[2 + i].parent != (int)(1 + i) ||
+            tokens[2 + i].end != (int)(7 + 2 * NEST_DEPTH - i))
+        {
+            printf("failed. bad array token %u.\n", 2 + i);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nParsing %u nested arrays with %u frames ... ", NEST_DEPTH,
+           NEST_DEPTH);
+    status =
+        jtok_parse_with_stack(json, tokens, TOKEN_MAX, frames, NEST_DEPTH);
+    if (status != JTOK_PARSE_STATUS_NEST_DEPTH_EXCEEDED)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    printf("passed.\n");
+
+    /* Elements that are aggregates must be linked to each other */
+    printf("\nChecking sibling links of aggregate array elements ... ");
+    status = jtok_parse_with_stack("{\"a\":[{\"b\":1},{\"c\":[2]},{}]}",
+                                   tokens, TOKEN_MAX, frames, 4);
+    if (status != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    if (tokens[3].sibling != 6 || tokens[6].sibling != 10 ||
+        tokens[10].sibling != JTOK_NO_SIBLING_IDX || tokens[2].size != 3)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    if (jtok_parse_with_stack(json, tokens, TOKEN_MAX, NULL, NEST_DEPTH) !=
+        JTOK_PARSE_STATUS_NULL_PARAM)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file number_accessors.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that number and boolean tokens convert to
+ * the same int64_t, double and bool values as the C library gives
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (8u)
+#define RANDOM_DOUBLES (200000u)
+#define HALF_WAY_DOUBLES (2000u)
+#define HALF_WAY_DECIMALS (1100)
+#define HALF_WAY_LEN (1500)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+
+static const struct
+{
+    const char *value;
+    bool        ok;
+    int64_t     expected;
+} int_table[] = {
+    {"0", true, 0},
+    {"-0", true, 0},
+    {"+42", true, 42},
+    {"-17", true, -17},
+    {"00012", true, 12},
+    {"12345678", true, 12345678},
+    {"123456789012345678", true, 123456789012345678},
+    {"9223372036854775807", true, INT64_MAX},
+    {"-9223372036854775808", true, INT64_MIN},
+    {"9223372036854775808", false, 0},
+    {"-9223372036854775809", false, 0},
+    {"99999999999999999999", false, 0},
+    {"1.0", false, 0},
+    {"1e3", false, 0},
+    {"true", false, 0},
+};
+
+#if JTOK_FLOAT
+static const char *const double_table[] = {
+    "0",
+    "-0",
+    "0.1",
+    "-1.5",
+    "1e0",
+    "1E+2",
+    "123456789012345678901234567890",
+    "0.000000000000000000000000000001",
+    "9007199254740993",
+    "2.2250738585072011e-308",
+    "2.2250738585072014e-308",
+    "4.9e-324",
+    "2.4e-324",
+    "1e-400",
+    "1.7976931348623157e308",
+    "1.7976931348623159e308",
+    "1e309",
+    "-1e309",
+    "7.038531e-26",
+    "9007199254740992.000000000000000000001",
+    "0.500000000000000166533453693773481063544750213623046875",
+    "3.14159265358979323846264338327950288",
+    "1448997445238699",
+    "9007199254740993.0000000000000000001",
+    "9007199254740993.00000000000000000000000000000000000000000000000000",
+    "9007199254740992.9999999999999999999",
+    "9007199254740994.9999999999999999999e-15",
+    "1.00000000000000011102230246251565404236316680908203125",
+    "1.00000000000000011102230246251565404236316680908203126",
+    "1.00000000000000033306690738754696212708950042724609375",
+    "2.4703282292062327208828439643411068618252990130716238e-324",
+    "2.4703282292062327208828439643411068618252990130716239e-324",
+    "1.797693134862315807937289714053034150799e308",
+};
+#endif /* #if JTOK_FLOAT */
+
+static bool parse_value(const char *value, char *json, size_t size);
+#if JTOK_FLOAT
+static bool check_double(const char *value, char *json, size_t size);
+static void add_decimals(char *sum, const char *a, const char *b);
+#endif /* #if JTOK_FLOAT */
+
+int main(void)
+{
+    char    json[128];
+    int64_t ival;
+    bool    bval;
+
+    printf("\nConverting integers ... ");
+    for (size_t i = 0; i < sizeof(int_table) / sizeof(*int_table); i++)
+    {
+        ival = 7;
+        if (!parse_value(int_table[i].value, json, sizeof(json)) ||
+            jtok_tok_to_int64(&tokens[2], &ival) != int_table[i].ok ||
+            ival != (int_table[i].ok ? int_table[i].expected : 7))
+        {
+            printf("failed for %s.\n", int_table[i].value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+#if JTOK_FLOAT
+    double dval;
+    printf("\nConverting doubles ... ");
+    for (size_t i = 0; i < sizeof(double_table) / sizeof(*double_table); i++)
+    {
+        if (!check_double(double_table[i], json, sizeof(json)))
+        {
+            printf("failed for %s.\n", double_table[i]);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nConverting random doubles ... ");
+    srand(1234);
+    for (size_t i = 0; i < RANDOM_DOUBLES; i++)
+    {
+        char   value[64];
+        size_t len    = 0;
+        int    digits = 1 + rand() % 24;
+        int    point  = rand() % (digits + 1);
+        if (rand() % 2)
+        {
+            value[len++] = '-';
+        }
+        for (int d = 0; d < digits; d++)
+        {
+            if (d == point && d > 0)
+            {
+                value[len++] = '.';
+            }
+            int digit    = (d == 0) ? 1 + rand() % 9 : rand() % 10;
+            value[len++] = (char)('0' + digit);
+        }
+        if (rand() % 4)
+        {
+            len += (size_t)snprintf(&value[len], sizeof(value) - len, "e%d",
+                                    rand() % 700 - 350);
+        }
+        value[len] = '\0';
+        if (!check_double(value, json, sizeof(json)))
+        {
+            printf("failed for %s.\n", value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nConverting half way points between doubles ... ");
+    static char half_way[HALF_WAY_LEN];
+    static char long_json[HALF_WAY_LEN + 16];
+    for (size_t i = 0; i < HALF_WAY_DOUBLES; i++)
+    {
+        char     lower[HALF_WAY_LEN];
+        char     half_ulp[HALF_WAY_LEN];
+        uint64_t bits = 0;
+        uint64_t power;
+        uint64_t half_bits;
+        double   value;
+        for (int b = 0; b < 4; b++)
+        {
+            bits = (bits << 16) | (uint64_t)(rand() & 0xFFFF);
+        }
+        bits &= ~(UINT64_C(1) << 63);
+        power = bits >> 52;
+        if (power < 2 || power == 0x7FF)
+        {
+            continue;
+        }
+
+        /* lower + 2^(e - 1) for lower = m * 2^e, printed exactly */
+        half_bits = (power > 53) ? (power - 53) << 52
+                                 : UINT64_C(1) << (power - 2);
+        memcpy(&value, &bits, sizeof(value));
+        snprintf(lower, sizeof(lower), "%.*f", HALF_WAY_DECIMALS, value);
+        memcpy(&value, &half_bits, sizeof(value));
+        snprintf(half_ulp, sizeof(half_ulp), "%.*f", HALF_WAY_DECIMALS,
+                 value);
+        add_decimals(half_way, lower, half_ulp);
+        if (!check_double(half_way, long_json, sizeof(long_json)))
+        {
+            printf("failed for %s.\n", half_way);
+            return 1;
+        }
+
+        /* A nonzero digit past all the others is above the point */
+        strcat(half_way, "1");
+        if (!check_double(half_way, long_json, sizeof(long_json)))
+        {
+            printf("failed for %s.\n", half_way);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nRejecting non-numbers as doubles ... ");
+    if (!parse_value("true", json, sizeof(json)) ||
+        jtok_tok_to_double(&tokens[2], &dval) ||
+        !parse_value("\"12\"", json, sizeof(json)) ||
+        jtok_tok_to_double(&tokens[2], &dval) ||
+        jtok_tok_to_double(NULL, &dval))
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+#endif /* #if JTOK_FLOAT */
+
+    printf("\nConverting booleans and rejecting other tokens ... ");
+    if (!parse_value("true", json, sizeof(json)) ||
+        !jtok_tok_to_bool(&tokens[2], &bval) || !bval ||
+        !parse_value("false", json, sizeof(json)) ||
+        !jtok_tok_to_bool(&tokens[2], &bval) || bval ||
+        !parse_value("null", json, sizeof(json)) ||
+        jtok_tok_to_bool(&tokens[2], &bval) ||
+        jtok_tok_to_int64(&tokens[2], &ival) ||
+        !parse_value("\"12\"", json, sizeof(json)) ||
+        jtok_tok_to_int64(&tokens[2], &ival) ||
+        jtok_tok_to_int64(&tokens[0], &ival) ||
+        jtok_tok_to_bool(&tokens[2], NULL))
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Parse {"k":value} into the tokens
+ *
+ * @return true if parsed
+ */
+static bool parse_value(const char *value, char *json, size_t size)
+{
+    snprintf(json, size, "{\"k\":%s}", value);
+    return jtok_parse(json, tokens, TOKEN_MAX) == JTOK_PARSE_STATUS_OK;
+}
+
+
+#if JTOK_FLOAT
+/**
+ * @brief Check that a number converts to the same bits as strtod gives
+ *
+ * @return true if it does
+ */
+static bool check_double(const char *value, char *json, size_t size)
+{
+    double got;
+    double want = strtod(value, NULL);
+    return parse_value(value, json, size) &&
+           jtok_tok_to_double(&tokens[2], &got) &&
+           memcmp(&got, &want, sizeof(got)) == 0;
+}
+
+
+/**
+ * @brief Add two positive numbers printed with the same number of decimals
+ *
+ * @param sum the sum, with a leading 0 if nothing carried into it
+ */
+static void add_decimals(char *sum, const char *a, const char *b)
+{
+    size_t len_a = strlen(a);
+    size_t len_b = strlen(b);
+    int    carry = 0;
+    if (len_a < len_b)
+    {
+        const char *swap = a;
+        a                = b;
+        b                = swap;
+        len_a            = len_b;
+        len_b            = strlen(b);
+    }
+
+    sum[len_a + 1] = '\0';
+    for (size_t i = 0; i < len_a; i++)
+    {
+        char digit_a = a[len_a - 1 - i];
+        char digit_b = (i < len_b) ? b[len_b - 1 - i] : '0';
+        int  digit;
+        if (digit_a == '.')
+        {
+            sum[len_a - i] = '.';
+            continue;
+        }
+        digit          = (digit_a - '0') + (digit_b - '0') + carry;
+        sum[len_a - i] = (char)('0' + digit % 10);
+        carry          = digit / 10;
+    }
+    sum[0] = (char)('0' + carry);
+}
+#endif /* #if JTOK_FLOAT */
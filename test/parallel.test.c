@@ -0,0 +1,183 @@
+/**
+ * @file parallel.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that a document parsed on several threads
+ * gives the same tokens and status as a single-threaded parse
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#if JTOK_THREADS
+
+#define THREAD_COUNT (4u)
+#define ITEM_COUNT (3000u)
+#define TOKEN_MAX (ITEM_COUNT * 16 + 64)
+#define JSON_STRLEN (ITEM_COUNT * 128 + 256)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static jtok_tkn_t expected[TOKEN_MAX];
+static char       json[JSON_STRLEN];
+
+static size_t build_document(size_t odd);
+static bool   same_parse(const char *name, size_t len, size_t size);
+
+int main(void)
+{
+    size_t len   = build_document(ITEM_COUNT);
+    char * mid   = strstr(&json[len / 2], "\"name\"");
+    size_t exact = 0;
+
+    printf("\nParsing a large document on %u threads ... ", THREAD_COUNT);
+    if (!same_parse("document", len, TOKEN_MAX))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nParsing into a pool that is too small ... ");
+    if (!same_parse("small pool", len, TOKEN_MAX / 2))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+
+    /* Slices get regions by their length, so with little slack some run
+     * out of tokens in front of a different kind of token each time */
+    printf("\nParsing into a pool with little or no slack ... ");
+    if (jtok_count_tokens(json, len, &exact) != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed. could not count the tokens.\n");
+        return 1;
+    }
+    for (size_t extra = 0; extra < 64; extra++)
+    {
+        if (!same_parse("little slack", len, exact + extra))
+        {
+            return 1;
+        }
+    }
+    if (!same_parse("1% slack", len, exact + exact / 100))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nReporting a malformed element in the middle ... ");
+    mid[-1] = ' ';
+    if (!same_parse("malformed", len, TOKEN_MAX))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nReporting an array of mixed types across slices ... ");
+    len = build_document(ITEM_COUNT * 3 / 4);
+    if (!same_parse("mixed", len, TOKEN_MAX))
+    {
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Build a document whose largest array spans several slices. Strings
+ * hold quotes, commas and brackets that the split must not stop at.
+ *
+ * @param odd index of an item that is a number instead of an object
+ */
+static size_t build_document(size_t odd)
+{
+    size_t len = 0;
+    len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                            "{\"meta\":{\"ver\":1,\"tags\":[\"a\",\"b\"]},"
+                            "\"items\":[");
+    for (size_t i = 0; i < ITEM_COUNT; i++)
+    {
+        if (i == odd)
+        {
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, ",7");
+            continue;
+        }
+        len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                                "%s{\"id\":%zu,\"name\":\"n\\\"],{%zu\","
+                                "\"vals\":[",
+                                i ? ",\n  " : "", i, i % 7);
+        for (size_t v = 0; v < i % 5; v++)
+        {
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, "%s%zu",
+                                    v ? "," : "", v);
+        }
+        len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                                "],\"sub\":{\"ok\":true}}");
+    }
+    len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                            "],\"tail\":[1,2]}");
+    return len;
+}
+
+
+/**
+ * @brief Parse the document on one thread and on several, and check that
+ * both give the same status and tokens
+ */
+static bool same_parse(const char *name, size_t len, size_t size)
+{
+    JTOK_PARSE_STATUS_t want;
+    JTOK_PARSE_STATUS_t got;
+    size_t              want_used = 0;
+    size_t              got_used  = 0;
+
+    want = jtok_parse_n_used(json, len, expected, size, &want_used);
+    got = jtok_parse_parallel(json, len, tokens, size, THREAD_COUNT,
+                              &got_used);
+    if (got != want || got_used != want_used)
+    {
+        printf("failed. %s: status %d with %zu tokens, expected %d with %zu.\n",
+               name, got, got_used, want, want_used);
+        return false;
+    }
+    if (want != JTOK_PARSE_STATUS_OK)
+    {
+        return true;
+    }
+
+    for (size_t i = 0; i < want_used; i++)
+    {
+        if (tokens[i].type != expected[i].type ||
+            tokens[i].start != expected[i].start ||
+            tokens[i].end != expected[i].end ||
+            tokens[i].size != expected[i].size ||
+            tokens[i].parent != expected[i].parent ||
+            tokens[i].sibling != expected[i].sibling ||
+            tokens[i].pool != tokens)
+        {
+            printf("failed. %s: token %zu differs.\n", name, i);
+            return false;
+        }
+    }
+    if (got_used < size && tokens[got_used].type != JTOK_UNASSIGNED_TOKEN)
+    {
+        printf("failed. %s: no sentinel.\n", name);
+        return false;
+    }
+    return true;
+}
+
+#else
+
+int main(void)
+{
+    printf("\nParallel parse not built (JTOK_THREADS=0), skipped.\n");
+    return 0;
+}
+
+#endif /* #if JTOK_THREADS */
@@ -106,7 +106,7 @@ int main(void)
 
         if (passed)
         {
-            status = jtok_parse(true_cmp_table[i].json1, tokens2, TOKEN_MAX);
+            status = jtok_parse(true_cmp_table[i].json2, tokens2, TOKEN_MAX);
             if (status != JTOK_PARSE_STATUS_OK)
             {
                 passed = false;
@@ -0,0 +1,108 @@
+/**
+ * @file primitive_subtype.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that the parser records the subtype of
+ * primitives and that comparisons use it
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (50u)
+
+static jtok_tkn_t  tokens1[TOKEN_MAX];
+static jtok_tkn_t  tokens2[TOKEN_MAX];
+static jtok_ctkn_t ctokens[TOKEN_MAX];
+
+static const struct
+{
+    const char *   value;
+    JTOK_SUBTYPE_t subtype;
+} subtype_table[] = {
+    {"0", JTOK_SUBTYPE_INTEGER},       {"-12", JTOK_SUBTYPE_INTEGER},
+    {"+7", JTOK_SUBTYPE_INTEGER},      {"1.25", JTOK_SUBTYPE_DECIMAL},
+    {"-0.5", JTOK_SUBTYPE_DECIMAL},    {"1e9", JTOK_SUBTYPE_EXPONENT},
+    {"1.5E-3", JTOK_SUBTYPE_EXPONENT}, {"true", JTOK_SUBTYPE_TRUE},
+    {"false", JTOK_SUBTYPE_FALSE},     {"null", JTOK_SUBTYPE_NULL},
+};
+
+static const struct
+{
+    const char *value1;
+    const char *value2;
+    bool        equal;
+} cmp_table[] = {
+    {"12345678901234567890", "12345678901234567890", true},
+    {"12345678901234567890", "12345678901234567891", false},
+    {"-0", "0", true},
+    {"-3", "3", false},
+    {"+3", "3", true},
+    {"10", "1", false},
+    {"0.1", "0.10", true},
+    {"1.5", "1", false},
+    {"250", "2.5e2", true},
+    {"true", "true", true},
+    {"true", "false", false},
+    {"null", "false", false},
+    {"1", "true", false},
+    {"0", "null", false},
+};
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    char                json1[64];
+    char                json2[64];
+    jtok_doc_t          doc;
+
+    printf("\nChecking primitive subtypes ... ");
+    for (size_t i = 0; i < sizeof(subtype_table) / sizeof(*subtype_table); i++)
+    {
+        snprintf(json1, sizeof(json1), "{\"k\":[%s],\"s\":\"1\"}",
+                 subtype_table[i].value);
+        status = jtok_parse(json1, tokens1, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            tokens1[3].subtype != subtype_table[i].subtype ||
+            tokens1[0].subtype != JTOK_SUBTYPE_NONE ||
+            tokens1[2].subtype != JTOK_SUBTYPE_NONE ||
+            tokens1[5].subtype != JTOK_SUBTYPE_NONE)
+        {
+            printf("failed for %s.\n", subtype_table[i].value);
+            return 1;
+        }
+
+        status = jtok_doc_parse(&doc, json1, strlen(json1), ctokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            ctokens[3].subtype != subtype_table[i].subtype)
+        {
+            printf("failed for compact token %s.\n", subtype_table[i].value);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nComparing primitives by subtype ... ");
+    for (size_t i = 0; i < sizeof(cmp_table) / sizeof(*cmp_table); i++)
+    {
+        snprintf(json1, sizeof(json1), "{\"k\":%s}", cmp_table[i].value1);
+        snprintf(json2, sizeof(json2), "{\"k\" : %s }", cmp_table[i].value2);
+        if (jtok_parse(json1, tokens1, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+            jtok_parse(json2, tokens2, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+            jtok_toktokcmp(&tokens1[2], &tokens2[2]) != cmp_table[i].equal ||
+            jtok_toktokcmp(&tokens2[2], &tokens1[2]) != cmp_table[i].equal ||
+            jtok_toktokcmp(&tokens1[0], &tokens2[0]) != cmp_table[i].equal)
+        {
+            printf("failed for %s and %s.\n", cmp_table[i].value1,
+                   cmp_table[i].value2);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file projection.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that a parse projected onto key paths only
+ * uses tokens for those paths and still validates everything else
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (64u)
+#define NOISE_COUNT (1700u)
+#define JSON_STRLEN (NOISE_COUNT * 24 + 256)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static char       json[JSON_STRLEN];
+
+static const char *const paths[] = {"/header/id", "/payload/readings"};
+
+static const char *const errors[] = {
+    "{\"header\":{\"id\":1},\"noise\":[1,\"a\"]}",
+    "{\"noise\":{\"a\" 1},\"header\":{\"id\":1}}",
+    "{\"noise\":[{\"a\":tru}]}",
+    "{\"noise\":{\"\":1}}",
+    "{\"noise\":[1,]}",
+    "{\"payload\":{\"readings\":[1,2}}",
+};
+
+static size_t build_message(void);
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    size_t              used  = 0;
+    size_t              total = 0;
+    size_t              len   = build_message();
+
+    printf("\nProjecting a large message onto %u tokens ... ", TOKEN_MAX);
+    status = jtok_count_tokens(json, len, &total);
+    if (status != JTOK_PARSE_STATUS_OK || total < 5000)
+    {
+        printf("failed. message has %zu tokens.\n", total);
+        return 1;
+    }
+    status = jtok_parse_paths(json, len, tokens, TOKEN_MAX, paths,
+                              sizeof(paths) / sizeof(*paths), &used);
+    if (status != JTOK_PARSE_STATUS_OK || used != 12)
+    {
+        printf("failed with status %d and %zu tokens.\n", status, used);
+        return 1;
+    }
+
+    /* root, header, {, id, 42, payload, {, readings, [, 1, 2, 3 */
+    if (tokens[0].type != JTOK_OBJECT || tokens[0].size != 2 ||
+        !jtok_tokcmp("header", &tokens[1]) || tokens[1].sibling != 5 ||
+        tokens[2].size != 1 || !jtok_tokcmp("id", &tokens[3]) ||
+        !jtok_tokcmp("42", &tokens[4]) || tokens[4].parent != 3 ||
+        !jtok_tokcmp("payload", &tokens[5]) ||
+        tokens[5].sibling != JTOK_NO_SIBLING_IDX ||
+        !jtok_tokcmp("readings", &tokens[7]) || tokens[8].type != JTOK_ARRAY ||
+        tokens[8].size != 3 || !jtok_tokcmp("3", &tokens[11]) ||
+        tokens[12].type != JTOK_UNASSIGNED_TOKEN)
+    {
+        printf("failed. bad projected tokens.\n");
+        return 1;
+    }
+    if (jtok_obj_has_key(&tokens[0], "noise") != NULL ||
+        jtok_obj_has_key(&tokens[2], "ver") != NULL)
+    {
+        printf("failed. kept a value off the paths.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nProjecting onto an exactly sized pool ... ");
+    status = jtok_parse_paths(json, len, tokens, 12, paths,
+                              sizeof(paths) / sizeof(*paths), &used);
+    if (status != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    status = jtok_parse_paths(json, len, tokens, 11, paths,
+                              sizeof(paths) / sizeof(*paths), &used);
+    if (status != JTOK_PARSE_STATUS_NOMEM)
+    {
+        printf("failed. expected NOMEM, got %d.\n", status);
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nProjecting onto the whole document ... ");
+    {
+        static const char  small[] = "{\"a\":[1,2],\"b\":{\"c\":\"d\"}}";
+        static const char *whole[] = {""};
+        jtok_tkn_t         ref[16];
+        status = jtok_parse_paths(small, strlen(small), tokens, TOKEN_MAX,
+                                  whole, 1, &used);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            jtok_parse(small, ref, 16) != JTOK_PARSE_STATUS_OK || used != 9)
+        {
+            printf("failed with status %d.\n", status);
+            return 1;
+        }
+        for (size_t i = 0; i < used; i++)
+        {
+            if (tokens[i].type != ref[i].type ||
+                tokens[i].start != ref[i].start ||
+                tokens[i].size != ref[i].size ||
+                tokens[i].sibling != ref[i].sibling)
+            {
+                printf("failed. token %zu differs.\n", i);
+                return 1;
+            }
+        }
+    }
+    printf("passed.\n");
+
+    for (size_t i = 0; i < sizeof(errors) / sizeof(*errors); i++)
+    {
+        JTOK_PARSE_STATUS_t expected;
+        printf("\nValidating skipped values of %s ... ", errors[i]);
+        expected = jtok_parse(errors[i], tokens, TOKEN_MAX);
+        status   = jtok_parse_paths(errors[i], strlen(errors[i]), tokens,
+                                  TOKEN_MAX, paths,
+                                  sizeof(paths) / sizeof(*paths), NULL);
+        if (expected == JTOK_PARSE_STATUS_OK || status != expected)
+        {
+            printf("failed. got %d, expected %d.\n", status, expected);
+            return 1;
+        }
+        printf("passed.\n");
+    }
+
+    printf("\nRejecting a relative path ... ");
+    {
+        static const char *relative[] = {"header/id"};
+        status = jtok_parse_paths(json, len, tokens, TOKEN_MAX, relative, 1,
+                                  NULL);
+        if (status != JTOK_PARSE_STATUS_INVAL)
+        {
+            printf("failed with status %d.\n", status);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+static size_t build_message(void)
+{
+    size_t len = 0;
+    len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                            "{\"header\":{\"ver\":\"1.0\",\"id\":42},"
+                            "\"noise\":[");
+    for (unsigned int i = 0; i < NOISE_COUNT; i++)
+    {
+        len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                                "%s{\"id\":%u}", i ? "," : "", i);
+    }
+    len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                            "],\"id\":7,\"payload\":{\"meta\":{\"id\":1},"
+                            "\"readings\":[1,2,3]}}");
+    return len;
+}
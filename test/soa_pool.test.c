@@ -0,0 +1,162 @@
+/**
+ * @file soa_pool.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test the struct-of-arrays token pool against the
+ * regular token pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (100u)
+#define ELEMENTS (70000u)
+#define LARGE_TOKEN_MAX (80000u)
+
+static jtok_tkn_t     tokens[TOKEN_MAX];
+static uint8_t        types[LARGE_TOKEN_MAX];
+static jtok_off_t     starts[LARGE_TOKEN_MAX];
+static jtok_off_t     ends[LARGE_TOKEN_MAX];
+static jtok_soa_idx_t sizes[LARGE_TOKEN_MAX];
+static jtok_soa_idx_t parents[LARGE_TOKEN_MAX];
+static jtok_soa_idx_t siblings[LARGE_TOKEN_MAX];
+static const char json[] =
+    "{\"a\":\"x\",\"b\":[1,2,3,4,5],\"c\":{\"d\":\"y\",\"e\":[\"p\",\"q\"]},"
+    "\"f\":[{\"g\":true},{\"h\":null}],\"i\":\"z\",\"j\":[[6],[7,8]]}";
+
+static int idx(jtok_soa_idx_t i);
+
+int main(void)
+{
+    jtok_soa_t soa = {types, starts, ends, sizes, parents, siblings, TOKEN_MAX,
+                      0,     NULL,   0};
+    size_t     used;
+    size_t     i;
+
+    printf("\nComparing the struct-of-arrays pool with regular tokens ... ");
+    if (jtok_parse_n_used(json, strlen(json), tokens, TOKEN_MAX, &used) !=
+            JTOK_PARSE_STATUS_OK ||
+        jtok_soa_parse(&soa, json, strlen(json)) != JTOK_PARSE_STATUS_OK ||
+        soa.count != used)
+    {
+        printf("failed to parse.\n");
+        return 1;
+    }
+    for (i = 0; i < used; i++)
+    {
+        if (tokens[i].type != types[i] || tokens[i].start != (int)starts[i] ||
+            tokens[i].end != (int)ends[i] || tokens[i].size != (int)sizes[i] ||
+            tokens[i].parent != idx(parents[i]) ||
+            tokens[i].sibling != idx(siblings[i]))
+        {
+            printf("failed. token %zu differs.\n", i);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nWalking the keys of the top-level object ... ");
+    jtok_tkn_t *key  = jtok_get_child(&tokens[0]);
+    jtok_soa_idx_t skey = jtok_soa_child(&soa, 0);
+    while (key != NULL)
+    {
+        if (skey == JTOK_SOA_NONE || key != &tokens[skey])
+        {
+            printf("failed.\n");
+            return 1;
+        }
+        key  = jtok_get_next_sibling(key);
+        skey = jtok_soa_sibling(&soa, skey);
+    }
+    if (skey != JTOK_SOA_NONE)
+    {
+        printf("failed. extra sibling.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nScanning the type array ... ");
+    for (JTOK_TYPE_t type = JTOK_PRIMITIVE; type <= JTOK_STRING; type++)
+    {
+        size_t     expected = 0;
+        jtok_soa_idx_t found[3];
+        size_t     nfound = 0;
+        size_t     from   = 0;
+        size_t     n;
+        for (i = 0; i < used; i++)
+        {
+            expected += (tokens[i].type == type);
+        }
+        if (jtok_soa_count_type(&soa, type) != expected)
+        {
+            printf("failed. bad count of type %d.\n", type);
+            return 1;
+        }
+
+        /* Collect in small batches to exercise resuming */
+        do
+        {
+            n = jtok_soa_find_type(&soa, type, from, found, 3);
+            for (i = 0; i < n; i++)
+            {
+                if (tokens[found[i]].type != type)
+                {
+                    printf("failed. token %u is not type %d.\n",
+                           (unsigned int)found[i], type);
+                    return 1;
+                }
+            }
+            nfound += n;
+            if (n > 0)
+            {
+                from = found[n - 1] + 1;
+            }
+        } while (n == 3);
+        if (nfound != expected)
+        {
+            printf("failed. found %zu of type %d.\n", nfound, type);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nParsing more than 65535 tokens ... ");
+    if (JTOK_INDEX_WIDTH == 16)
+    {
+        /* The offsets of a document that large don't fit in 16 bits */
+        printf("skipped.\n");
+        return 0;
+    }
+    char  *large = malloc(2 * ELEMENTS + 16);
+    size_t len   = (size_t)sprintf(large, "{\"a\":[");
+    for (i = 0; i < ELEMENTS; i++)
+    {
+        len += (size_t)sprintf(&large[len], "%s0", (i > 0) ? "," : "");
+    }
+    len += (size_t)sprintf(&large[len], "]}");
+    soa.cap = LARGE_TOKEN_MAX;
+    if (jtok_soa_parse(&soa, large, len) != JTOK_PARSE_STATUS_OK ||
+        soa.count != ELEMENTS + 3 || sizes[2] != ELEMENTS ||
+        parents[ELEMENTS + 2] != 2 || siblings[ELEMENTS + 1] != ELEMENTS + 2 ||
+        siblings[ELEMENTS + 2] != JTOK_SOA_NONE)
+    {
+        printf("failed.\n");
+        free(large);
+        return 1;
+    }
+    free(large);
+    printf("passed.\n");
+    return 0;
+}
+
+
+static int idx(jtok_soa_idx_t i)
+{
+    return i == JTOK_SOA_NONE ? -1 : (int)i;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file string_scan.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that strings scanned many chars at a time
+ * still stop at every quote and escape, wherever it falls in a vector
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (8u)
+#define DEPTH_MAX (4u)
+#define VALUE_MAX (150u)
+#define JSON_STRLEN (VALUE_MAX + 32)
+
+static jtok_tkn_t   tokens[TOKEN_MAX];
+static jtok_frame_t frames[DEPTH_MAX];
+static char         json[JSON_STRLEN];
+
+static size_t build(size_t value_len, size_t at, const char *insert);
+static bool   parses(size_t len, size_t value_len, JTOK_PARSE_STATUS_t want);
+
+int main(void)
+{
+    printf("\nStopping at escapes at every offset ... ");
+    for (size_t n = 0; n < VALUE_MAX; n++)
+    {
+        for (size_t at = 0; at + 3 <= n; at++)
+        {
+            if (!parses(build(n, at, "\\\""), n, JTOK_PARSE_STATUS_OK) ||
+                !parses(build(n, at, "'\\q"), n, JTOK_PARSE_STATUS_INVAL))
+            {
+                printf("failed for length %zu at %zu.\n", n, at);
+                return 1;
+            }
+        }
+        for (size_t at = 0; at + 6 <= n; at++)
+        {
+            if (!parses(build(n, at, "\\u0aF9"), n, JTOK_PARSE_STATUS_OK) ||
+                !parses(build(n, at, "\\u0aG9"), n, JTOK_PARSE_STATUS_INVAL))
+            {
+                printf("failed for \\u escape %zu at %zu.\n", n, at);
+                return 1;
+            }
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nResuming long strings cut at every offset ... ");
+    for (size_t at = 0; at + 6 <= VALUE_MAX; at += 5)
+    {
+        size_t len = build(VALUE_MAX, at, "\\u0aF9");
+        for (size_t cut = 1; cut < len; cut++)
+        {
+            jtok_parser_t       parser;
+            JTOK_PARSE_STATUS_t status;
+            jtok_parser_init(&parser, tokens, TOKEN_MAX, frames, DEPTH_MAX);
+            status = jtok_parser_feed(&parser, json, cut);
+            if (status == JTOK_PARSE_STATUS_PARTIAL_TOKEN)
+            {
+                status = jtok_parser_feed(&parser, json, len);
+            }
+            if (status != JTOK_PARSE_STATUS_OK ||
+                tokens[2].end - tokens[2].start != VALUE_MAX)
+            {
+                printf("failed at %zu cut at %zu with status %d.\n", at, cut,
+                       status);
+                return 1;
+            }
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Build {"key":"xxx...xxx"} with a string value of value_len chars
+ * and insert placed at index at of the value
+ *
+ * @return size_t length of the json
+ */
+static size_t build(size_t value_len, size_t at, const char *insert)
+{
+    size_t len = (size_t)snprintf(json, sizeof(json), "{\"key\":\"");
+    memset(&json[len], 'x', value_len);
+    memcpy(&json[len + at], insert, strlen(insert));
+    len += value_len;
+    len += (size_t)snprintf(&json[len], sizeof(json) - len, "\"}");
+    return len;
+}
+
+
+/**
+ * @brief Check the parse status and, for a valid json, the length of the
+ * string value
+ */
+static bool parses(size_t len, size_t value_len, JTOK_PARSE_STATUS_t want)
+{
+    JTOK_PARSE_STATUS_t status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+    if (status != want)
+    {
+        return false;
+    }
+    return status != JTOK_PARSE_STATUS_OK ||
+           (size_t)(tokens[2].end - tokens[2].start) == value_len;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file structural_index.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that token boundaries are unchanged when
+ * whitespace runs cross the 64 byte blocks of the structural index
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (20u)
+#define PAD_MAX (200u)
+#define JSON_STRLEN (7 * PAD_MAX + 32)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static char       json[JSON_STRLEN];
+
+static void pad(char *dst, unsigned int n);
+
+int main(void)
+{
+    unsigned int n;
+    for (n = 0; n < PAD_MAX; n++)
+    {
+        char ws[PAD_MAX + 1];
+        pad(ws, n);
+        printf("\nParsing json padded with %u whitespace chars ... ", n);
+        snprintf(json, sizeof(json), "%s{%s\"key\"%s:%s[1,%s2]%s}%s", ws, ws,
+                 ws, ws, ws, ws, ws);
+        JTOK_PARSE_STATUS_t status = jtok_parse(json, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK)
+        {
+            printf("failed with status %d.\n", status);
+            return 1;
+        }
+
+        if (tokens[0].type != JTOK_OBJECT || tokens[0].start != (int)n ||
+            tokens[0].end != (int)strlen(json) - (int)n)
+        {
+            printf("failed. bad object boundaries.\n");
+            return 1;
+        }
+
+        if (!jtok_tokcmp("key", &tokens[1]) || tokens[2].type != JTOK_ARRAY ||
+            tokens[2].size != 2)
+        {
+            printf("failed. bad key or array.\n");
+            return 1;
+        }
+
+        if (!jtok_tokcmp("1", &tokens[3]) || !jtok_tokcmp("2", &tokens[4]))
+        {
+            printf("failed. bad array elements.\n");
+            return 1;
+        }
+        printf("passed.\n");
+    }
+    return 0;
+}
+
+
+static void pad(char *dst, unsigned int n)
+{
+    static const char ws[] = {' ', '\t', '\r', '\n'};
+    unsigned int      i;
+    for (i = 0; i < n; i++)
+    {
+        dst[i] = ws[i % sizeof(ws)];
+    }
+    dst[n] = '\0';
+}
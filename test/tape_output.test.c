@@ -0,0 +1,119 @@
+/**
+ * @file tape_output.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that the tape describes the same tree as the
+ * regular token pool
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (100u)
+#define TAPE_MAX (4 * TOKEN_MAX)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static uint64_t   words[TAPE_MAX];
+static const char json[] =
+    "{\"a\":\"x\",\"b\":[1,2,3],\"c\":{\"d\":\"y\",\"e\":[\"p\",\"q\"]},"
+    "\"f\":[{\"g\":true},{}],\"h\":[],\"i\":[[6],[7,8]]}";
+
+static int same_tree(const jtok_tape_t *tape, size_t entry,
+                     const jtok_tkn_t *tkn);
+
+int main(void)
+{
+    jtok_tape_t tape = {words, TAPE_MAX, 0, NULL, 0};
+
+    printf("\nComparing the tape with regular tokens ... ");
+    if (jtok_parse(json, tokens, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+        jtok_tape_parse(&tape, json, strlen(json)) != JTOK_PARSE_STATUS_OK)
+    {
+        printf("failed to parse.\n");
+        return 1;
+    }
+    if (!same_tree(&tape, 0, &tokens[0]) ||
+        jtok_tape_skip(&tape, 0) != tape.count)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nLooking up keys ... ");
+    size_t c   = jtok_tape_obj_has_key(&tape, 0, "c");
+    size_t e   = jtok_tape_obj_has_key(&tape, jtok_tape_child(&tape, c), "e");
+    size_t arr = jtok_tape_child(&tape, e);
+    size_t p   = jtok_tape_child(&tape, arr);
+    size_t q   = jtok_tape_sibling(&tape, p);
+    if (c == JTOK_TAPE_NONE || e == JTOK_TAPE_NONE ||
+        jtok_tape_tag(&tape, arr) != JTOK_TAPE_ARRAY ||
+        jtok_tape_sibling(&tape, arr) != JTOK_TAPE_NONE ||
+        !jtok_tape_tokcmp(&tape, "p", p) || !jtok_tape_tokcmp(&tape, "q", q) ||
+        jtok_tape_sibling(&tape, q) != JTOK_TAPE_NONE ||
+        jtok_tape_obj_has_key(&tape, 0, "d") != JTOK_TAPE_NONE ||
+        jtok_tape_obj_has_key(&tape, 0, "i") == JTOK_TAPE_NONE)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nChecking an undersized tape ... ");
+    tape.cap = tape.count - 2;
+    if (jtok_tape_parse(&tape, json, strlen(json)) != JTOK_PARSE_STATUS_NOMEM)
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+static int same_tree(const jtok_tape_t *tape, size_t entry,
+                     const jtok_tkn_t *tkn)
+{
+    static const char tags[] = {
+        [JTOK_PRIMITIVE] = JTOK_TAPE_PRIMITIVE,
+        [JTOK_OBJECT]    = JTOK_TAPE_OBJECT,
+        [JTOK_ARRAY]     = JTOK_TAPE_ARRAY,
+        [JTOK_STRING]    = JTOK_TAPE_STRING,
+    };
+    char tag = jtok_tape_tag(tape, entry);
+    if (jtok_tokenIsKey(*tkn) && tkn->pool[tkn->parent].type == JTOK_OBJECT)
+    {
+        if (tag != JTOK_TAPE_KEY)
+        {
+            return 0;
+        }
+    }
+    else if (tag != tags[tkn->type])
+    {
+        return 0;
+    }
+
+    if (jtok_tape_toklen(tape, entry) != jtok_toklen(tkn) ||
+        jtok_tape_tokstr(tape, entry) != &json[tkn->start])
+    {
+        return 0;
+    }
+
+    const jtok_tkn_t *child  = tkn->size > 0 ? jtok_get_child(tkn) : NULL;
+    size_t            tchild = jtok_tape_child(tape, entry);
+    while (child != NULL)
+    {
+        if (tchild == JTOK_TAPE_NONE || !same_tree(tape, tchild, child))
+        {
+            return 0;
+        }
+        child  = jtok_get_next_sibling(child);
+        tchild = jtok_tape_sibling(tape, tchild);
+    }
+    return tchild == JTOK_TAPE_NONE;
+}
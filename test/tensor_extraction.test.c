@@ -0,0 +1,135 @@
+/**
+ * @file tensor_extraction.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test converting nested arrays of numbers into
+ * dense row-major buffers
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#if JTOK_FLOAT
+
+#define TOKEN_MAX (600u)
+#define POINTS (100u)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static char       json[POINTS * 32];
+static double     doubles[POINTS * 3];
+static float      floats[POINTS * 3];
+
+static const struct
+{
+    const char *json;
+    size_t      size;
+} bad_table[] = {
+    {"{\"t\":[[1,2],[3]]}", 8},
+    {"{\"t\":[[1,2],[3,4,5]]}", 8},
+    {"{\"t\":[[1,2],[[3],[4]]]}", 8},
+    {"{\"t\":[[\"1\",\"2\"]]}", 8},
+    {"{\"t\":[[1,true]]}", 8},
+    {"{\"t\":[[[1]],[2]]}", 8},
+    {"{\"t\":[[1,2],[3,4]]}", 3},
+    {"{\"t\":[[[[[[[[[1]]]]]]]]]}", 8},
+};
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    jtok_shape_t        shape;
+    size_t              len;
+
+    printf("\nExtracting a list of points ... ");
+    len = (size_t)snprintf(json, sizeof(json), "{\"points\":[");
+    for (size_t i = 0; i < POINTS; i++)
+    {
+        len += (size_t)snprintf(&json[len], sizeof(json) - len,
+                                "%s[%zu, %zu.5, -%zue-2]", (i > 0) ? "," : "",
+                                i, i, i);
+    }
+    snprintf(&json[len], sizeof(json) - len, "]}");
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK ||
+        !jtok_array_to_tensor_double(&tokens[2], doubles, POINTS * 3,
+                                     &shape) ||
+        shape.rank != 2 || shape.shape[0] != POINTS || shape.shape[1] != 3 ||
+        shape.count != POINTS * 3 ||
+        !jtok_array_to_tensor_float(&tokens[2], floats, POINTS * 3, &shape))
+    {
+        printf("failed with status %d.\n", status);
+        return 1;
+    }
+    for (size_t i = 0; i < POINTS; i++)
+    {
+        if (doubles[3 * i] != (double)i || doubles[3 * i + 1] != i + 0.5 ||
+            doubles[3 * i + 2] != -(double)i / 100 ||
+            floats[3 * i + 1] != (float)(i + 0.5) ||
+            floats[3 * i + 2] != (float)(-(double)i / 100))
+        {
+            printf("failed at point %zu.\n", i);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nExtracting tensors of other ranks ... ");
+    strcpy(json, "{\"a\":[[[1,2],[3,4]],[[5,6],[7,8]]],\"v\":[9,10],"
+                 "\"e\":[],\"z\":[[],[]]}");
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK ||
+        !jtok_array_to_tensor_double(&tokens[2], doubles, 8, &shape) ||
+        shape.rank != 3 || shape.shape[0] != 2 || shape.shape[1] != 2 ||
+        shape.shape[2] != 2 || shape.count != 8 || doubles[5] != 6)
+    {
+        printf("failed for rank 3.\n");
+        return 1;
+    }
+    if (!jtok_array_to_tensor_double(&tokens[18], doubles, 2, &shape) ||
+        shape.rank != 1 || shape.count != 2 || doubles[1] != 10 ||
+        !jtok_array_to_tensor_double(&tokens[22], doubles, 0, &shape) ||
+        shape.rank != 1 || shape.count != 0 ||
+        !jtok_array_to_tensor_double(&tokens[24], doubles, 0, &shape) ||
+        shape.rank != 2 || shape.shape[1] != 0 || shape.count != 0)
+    {
+        printf("failed for rank 1 or empty arrays.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nRejecting ragged and non-numeric tensors ... ");
+    for (size_t i = 0; i < sizeof(bad_table) / sizeof(*bad_table); i++)
+    {
+        status = jtok_parse(bad_table[i].json, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            jtok_array_to_tensor_double(&tokens[2], doubles, bad_table[i].size,
+                                        &shape))
+        {
+            printf("failed for %s.\n", bad_table[i].json);
+            return 1;
+        }
+    }
+    if (jtok_array_to_tensor_double(&tokens[0], doubles, 8, &shape) ||
+        jtok_array_to_tensor_double(NULL, doubles, 8, &shape))
+    {
+        printf("failed for non-array tokens.\n");
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("\nTensor extraction not built (JTOK_FLOAT=0), skipped.\n");
+    return 0;
+}
+
+#endif /* #if JTOK_FLOAT */
@@ -0,0 +1,123 @@
+/**
+ * @file token_width.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that token lengths are not truncated to 16
+ * bits and that documents respect the configured compact token width
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define VALUE_LEN (100000u)
+#define TOKEN_MAX (5u)
+
+static jtok_tkn_t  tokens[TOKEN_MAX];
+static jtok_tkn_t  others[TOKEN_MAX];
+static jtok_ctkn_t ctokens[TOKEN_MAX];
+
+int main(void)
+{
+    char *json  = malloc(VALUE_LEN + 32);
+    char *value = malloc(VALUE_LEN + 1);
+    char *copy  = malloc(VALUE_LEN + 1);
+    char *other = malloc(VALUE_LEN + 32);
+    int   ret   = 0;
+
+    memset(value, 'x', VALUE_LEN);
+    value[VALUE_LEN] = '\0';
+    sprintf(json, "{\"log\":\"%s\"}", value);
+
+    printf("\nParsing a %u char string value ... ", VALUE_LEN);
+    if (jtok_parse(json, tokens, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+        jtok_toklen(&tokens[2]) != VALUE_LEN ||
+        !jtok_tokcmp(value, &tokens[2]) ||
+        !jtok_tokncmp(value, &tokens[2], VALUE_LEN + 1))
+    {
+        printf("failed.\n");
+        ret = 1;
+    }
+    else
+    {
+        memset(copy, 0, VALUE_LEN + 1);
+        jtok_tokcpy(copy, VALUE_LEN + 1, &tokens[2]);
+        if (strcmp(copy, value) != 0)
+        {
+            printf("failed. bad copy.\n");
+            ret = 1;
+        }
+        else
+        {
+            printf("passed.\n");
+        }
+    }
+
+    printf("\nComparing it with other string tokens ... ");
+    sprintf(other, "{\"log\":\"%s\"}", value);
+    if (jtok_parse(other, others, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+        !jtok_toktokcmp(&tokens[2], &others[2]))
+    {
+        printf("failed for an equal string.\n");
+        ret = 1;
+    }
+    else
+    {
+        /* Differs only past 65535 chars, then only in length */
+        other[8 + VALUE_LEN - 1] = 'y';
+        if (jtok_parse(other, others, TOKEN_MAX) != JTOK_PARSE_STATUS_OK ||
+            jtok_toktokcmp(&tokens[2], &others[2]) ||
+            jtok_parse("{\"log\":\"\"}", others, TOKEN_MAX) !=
+                JTOK_PARSE_STATUS_OK ||
+            jtok_toktokcmp(&tokens[2], &others[2]))
+        {
+            printf("failed for a different string.\n");
+            ret = 1;
+        }
+        else
+        {
+            printf("passed.\n");
+        }
+    }
+
+    printf("\nParsing it into a document of %d bit tokens ... ",
+           JTOK_INDEX_WIDTH);
+    JTOK_PARSE_STATUS_t status;
+    jtok_doc_t          doc;
+    status = jtok_doc_parse(&doc, json, strlen(json), ctokens, TOKEN_MAX);
+    if (JTOK_INDEX_WIDTH == 16)
+    {
+        /* Offsets past 64 KiB can't be represented */
+        if (status != JTOK_PARSE_STATUS_INVAL)
+        {
+            printf("failed with status %d.\n", status);
+            ret = 1;
+        }
+        else
+        {
+            printf("passed.\n");
+        }
+    }
+    else if (status != JTOK_PARSE_STATUS_OK ||
+             jtok_doc_toklen(&doc, &ctokens[2]) != VALUE_LEN ||
+             !jtok_doc_tokcmp(&doc, value, &ctokens[2]))
+    {
+        printf("failed with status %d.\n", status);
+        ret = 1;
+    }
+    else
+    {
+        printf("passed.\n");
+    }
+
+    free(json);
+    free(value);
+    free(copy);
+    free(other);
+    return ret;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file unused_tokens.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that parsing leaves the unused part of the
+ * token pool alone unless the caller asks for it to be cleared
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (1000u)
+#define POISON (0x5A)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static const char json[] = "{\"cmd\":\"ping\",\"args\":[1,2]}";
+
+static int poisoned(size_t from, size_t to);
+
+int main(void)
+{
+    size_t              used = 0;
+    JTOK_PARSE_STATUS_t status;
+
+    printf("\nChecking that unused tokens are not written ... ");
+    memset(tokens, POISON, sizeof(tokens));
+    status = jtok_parse_n_used(json, strlen(json), tokens, TOKEN_MAX, &used);
+    if (status != JTOK_PARSE_STATUS_OK || used != 7)
+    {
+        printf("failed. status %d, %zu tokens used.\n", status, used);
+        return 1;
+    }
+    if (!poisoned(used, TOKEN_MAX))
+    {
+        printf("failed. unused token was written.\n");
+        return 1;
+    }
+    printf("passed.\n");
+
+    printf("\nChecking opt-in clearing ... ");
+    jtok_clear_tokens(tokens, used, TOKEN_MAX);
+    for (size_t i = used; i < TOKEN_MAX; i++)
+    {
+        if (tokens[i].type != JTOK_UNASSIGNED_TOKEN)
+        {
+            printf("failed. token %zu not cleared.\n", i);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nChecking that jtok_parse terminates the used tokens ... ");
+    memset(tokens, POISON, sizeof(tokens));
+    status = jtok_parse(json, tokens, TOKEN_MAX);
+    if (status != JTOK_PARSE_STATUS_OK ||
+        tokens[used].type != JTOK_UNASSIGNED_TOKEN ||
+        !poisoned(used + 1, TOKEN_MAX))
+    {
+        printf("failed.\n");
+        return 1;
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+static int poisoned(size_t from, size_t to)
+{
+    const unsigned char *raw = (const unsigned char *)&tokens[from];
+    for (size_t i = 0; i < (to - from) * sizeof(*tokens); i++)
+    {
+        if (raw[i] != POISON)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file word_scan.test.c
+ * @author Carl Mattatall (cmattatall2@gmail.com)
+ * @brief Source module to test that runs of whitespace, digits and string
+ * chars skipped a word at a time end on the right char, including bytes
+ * whose low 7 bits look like a json char
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Carl Mattatall
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "jtok.h"
+
+#define TOKEN_MAX (16u)
+#define RUN_MAX (40u)
+#define JSON_STRLEN (4 * RUN_MAX + 64)
+
+static jtok_tkn_t tokens[TOKEN_MAX];
+static char       json[JSON_STRLEN];
+
+static const char *const suffixes[] = {"", ".5", "e+12", ".0123456789e-7"};
+
+static size_t run(char *dst, size_t n, const char *chars);
+
+int main(void)
+{
+    JTOK_PARSE_STATUS_t status;
+    size_t              len;
+
+    printf("\nEnding runs of digits on the right char ... ");
+    for (size_t n = 1; n <= RUN_MAX; n++)
+    {
+        for (size_t s = 0; s < sizeof(suffixes) / sizeof(*suffixes); s++)
+        {
+            len = (size_t)snprintf(json, sizeof(json), "{\"k\":[-");
+            len += run(&json[len], n, "1234567890");
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, "%s,",
+                                    suffixes[s]);
+            len += run(&json[len], n, "9876543210");
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, "]}");
+            status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+            if (status != JTOK_PARSE_STATUS_OK || tokens[2].size != 2 ||
+                (size_t)(tokens[3].end - tokens[3].start) !=
+                    n + 1 + strlen(suffixes[s]) ||
+                (size_t)(tokens[4].end - tokens[4].start) != n)
+            {
+                printf("failed for %zu digits and \"%s\".\n", n, suffixes[s]);
+                return 1;
+            }
+
+            /* 0xB0 ... 0xB9 are not digits */
+            len = (size_t)snprintf(json, sizeof(json), "{\"k\":");
+            len += run(&json[len], n, "1234567890");
+            json[len++] = (char)(0xB0 + n % 10);
+            len += (size_t)snprintf(&json[len], sizeof(json) - len, "}");
+            status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+            if (status != JTOK_PARSE_STATUS_INVALID_PRIMITIVE)
+            {
+                printf("failed. %zu digits then 0x%X gave %d.\n", n,
+                       0xB0 + (unsigned int)(n % 10), status);
+                return 1;
+            }
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nEnding runs of whitespace on the right char ... ");
+    for (size_t n = 0; n <= RUN_MAX; n++)
+    {
+        len = (size_t)snprintf(json, sizeof(json), "{");
+        len += run(&json[len], n, " \t\r\n");
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "\"k\"");
+        len += run(&json[len], n, "\n  ");
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, ":");
+        len += run(&json[len], n, "\t");
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "true");
+        len += run(&json[len], n, " ");
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "}");
+        status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            !jtok_tokcmp("true", &tokens[2]))
+        {
+            printf("failed for %zu chars with status %d.\n", n, status);
+            return 1;
+        }
+
+        /* 0xA0 is not a space */
+        len = (size_t)snprintf(json, sizeof(json), "{\"k\":");
+        len += run(&json[len], n, " \t\r\n");
+        json[len++] = (char)0xA0;
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "1}");
+        status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_INVAL)
+        {
+            printf("failed. %zu spaces then 0xA0 gave %d.\n", n, status);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+
+    printf("\nStepping over bytes that alias quotes and backslashes ... ");
+    for (size_t n = 0; n <= RUN_MAX; n++)
+    {
+        /* 0xA2 and 0xDC have the low 7 bits of '"' and '\\' */
+        static const char aliases[] = {(char)0xA2, (char)0xDC, 'x', '\0'};
+        len = (size_t)snprintf(json, sizeof(json), "{\"k\":\"");
+        len += run(&json[len], n, aliases);
+        len += (size_t)snprintf(&json[len], sizeof(json) - len, "\\n\"}");
+        status = jtok_parse_n(json, len, tokens, TOKEN_MAX);
+        if (status != JTOK_PARSE_STATUS_OK ||
+            (size_t)(tokens[2].end - tokens[2].start) != n + 2)
+        {
+            printf("failed for %zu chars with status %d.\n", n, status);
+            return 1;
+        }
+    }
+    printf("passed.\n");
+    return 0;
+}
+
+
+/**
+ * @brief Write n chars cycling through chars
+ *
+ * @return size_t n
+ */
+static size_t run(char *dst, size_t n, const char *chars)
+{
+    size_t count = strlen(chars);
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] = chars[i % count];
+    }
+    dst[n] = '\0';
+    return n;
+}